@@ -86,6 +86,7 @@
 #include    "advgetopt/advgetopt.h"
 
 #include    "advgetopt/exception.h"
+#include    "advgetopt/option_schema.h"
 
 
 // snapdev
@@ -104,9 +105,16 @@
 #include    <libutf8/iterator.h>
 
 
+// C++
+//
+#include    <cstddef>
+#include    <memory_resource>
+
+
 // C
 //
 #include    <string.h>
+#include    <unistd.h>
 
 
 // last include
@@ -130,6 +138,16 @@ namespace
 {
 
 
+/** \brief Size of the buffer on the stack used by the parse_string() arena.
+ *
+ * Most strings parsed by parse_string() (i.e. an environment variable)
+ * are short enough for their arguments to fit in this buffer. Longer
+ * strings make the arena allocate more memory which gets freed when
+ * parse_string() returns.
+ */
+constexpr std::size_t const     g_arena_buffer_size = 1024;
+
+
 /** \brief Definitions of the system options.
  *
  * The system options are options we add automatically (if the user asked
@@ -347,6 +365,68 @@ bool is_arg(char const * a)
 
 
 
+/** \brief Split a string in arguments.
+ *
+ * This function is the implementation of the getopt::split_environment()
+ * function. It is a template so the parse_string() function can
+ * use containers allocated in its arena.
+ *
+ * \param[in] environment  The string to be split in arguments.
+ * \param[out] args  The list where the arguments get added.
+ */
+template<typename list_t>
+void split_arguments(std::string const & environment, list_t & args)
+{
+    // this is exactly like the command line only in an environment variable
+    // so parse the parameters just like the shell
+    //
+    typename list_t::value_type a(args.get_allocator());
+    char const * s(environment.c_str());
+    while(*s != '\0')
+    {
+        if(isspace(*s))
+        {
+            if(!a.empty())
+            {
+                args.push_back(a);
+                a.clear();
+            }
+            do
+            {
+                ++s;
+            }
+            while(isspace(*s));
+        }
+        else if(*s == '"'
+             || *s == '\'')
+        {
+            // support quotations and remove them from the argument
+            //
+            char const quote(*s++);
+            while(*s != '\0'
+               && *s != quote)
+            {
+                a += *s++;
+            }
+            if(*s != '\0')
+            {
+                ++s;
+            }
+        }
+        else
+        {
+            a += *s++;
+        }
+    }
+
+    if(!a.empty())
+    {
+        args.push_back(a);
+    }
+}
+
+
+
 /** \brief Check for a "--show-option-sources" flag.
  *
  * When this flag is defined, we turn on the trace mode in the option_info
@@ -617,6 +697,55 @@ getopt::getopt(options_environment const & opt_env
 }
 
 
+/** \brief Initialize a getopt object from a schema.
+ *
+ * This constructor creates a getopt object with the options defined in
+ * \p schema. The definitions are shared with the schema (and all the
+ * other getopt objects created from it) so only the values get
+ * allocated. This is much faster than loading the options each time.
+ *
+ * As with the getopt(options_environment const &) constructor, nothing
+ * gets parsed. You are expected to call the parse functions yourself.
+ *
+ * \param[in] schema  The schema defining the options.
+ *
+ * \sa option_schema
+ */
+getopt::getopt(std::shared_ptr<option_schema const> schema)
+{
+    initialize_parser(schema);
+}
+
+
+/** \brief Initialize a getopt object from a schema and parse \p argv.
+ *
+ * This constructor is the same as the getopt(options_environment const &,
+ * int, char *[]) constructor except that the options are defined by
+ * \p schema. The configuration files, environment variable, and
+ * \p argv are all parsed as usual.
+ *
+ * \exception getopt_exit
+ * This function calls finish_parsing() which may throw this exception.
+ * See that function for details.
+ *
+ * \param[in] schema  The schema defining the options.
+ * \param[in] argc  The number of arguments in argv.
+ * \param[in] argv  An array of strings representing arguments.
+ *
+ * \sa option_schema
+ */
+getopt::getopt(
+          std::shared_ptr<option_schema const> schema
+        , int argc
+        , char * argv[])
+{
+    check_for_show_sources(argc, argv);
+
+    initialize_parser(schema);
+    finish_parsing(argc, argv);
+}
+
+
 /** \brief Initialize the parser.
  *
  * This function is called from the two constructors. It initializes the
@@ -653,6 +782,39 @@ void getopt::initialize_parser(options_environment const & opt_env)
 }
 
 
+/** \brief Initialize the parser from a schema.
+ *
+ * This function is called from the two schema constructors. Instead of
+ * loading the options from the user definitions, files, etc. it creates
+ * one option_info per definition found in the \p schema.
+ *
+ * \exception getopt_logic_error
+ * The \p schema pointer cannot be null.
+ *
+ * \param[in] schema  The schema defining the options.
+ */
+void getopt::initialize_parser(std::shared_ptr<option_schema const> schema)
+{
+    if(schema == nullptr)
+    {
+        throw getopt_logic_error("the schema pointer cannot be null.");
+    }
+
+    f_variables = std::make_shared<variables>();
+    f_options_environment = schema->get_options_environment();
+
+    for(auto const & d : schema->get_definitions())
+    {
+        option_info::pointer_t o(std::make_shared<option_info>(d));
+        o->set_variables(f_variables);
+        add_option(o);
+    }
+    link_aliases();
+
+    define_environment_variable_data();
+}
+
+
 /** \brief Actually parse everything.
  *
  * This function allows you to run the second half of the initialization
@@ -724,8 +886,7 @@ void getopt::finish_parsing(int argc, char * argv[])
  */
 void getopt::is_parsed() const
 {
-    if(!f_parsed
-    && (f_options_environment.f_environment_flags & GETOPT_ENVIRONMENT_FLAG_AUTO_DONE) == 0)
+    if(!is_done())
     {
         throw getopt_initialization(
                 "function called too soon, parser is not done yet"
@@ -735,6 +896,23 @@ void getopt::is_parsed() const
 }
 
 
+/** \brief Check whether the parser is done.
+ *
+ * This function returns true once the parser is done, i.e. the
+ * functions retrieving the values of the options can be called.
+ *
+ * Unlike is_parsed(), this function does not throw. It is used by the
+ * try_get_...() functions.
+ *
+ * \return true if the values of the options can be retrieved.
+ */
+bool getopt::is_done() const
+{
+    return f_parsed
+        || (f_options_environment.f_environment_flags & GETOPT_ENVIRONMENT_FLAG_AUTO_DONE) != 0;
+}
+
+
 /** \brief Return a reference to the options environment.
  *
  * This function returns a reference to the options environment that
@@ -798,6 +976,60 @@ void getopt::define_environment_variable_data()
 }
 
 
+/** \brief Take a snapshot of the environment variables we need.
+ *
+ * Calling getenv() is a linear search through the environment. With
+ * many options having their own environment variable and a large
+ * environment (i.e. in a container), that gets slow.
+ *
+ * This function instead goes through the environment once and saves
+ * the value of the variables we are interested in: each option
+ * environment variable (with the introducer prepended if defined) in
+ * a hash map. Variables which are not defined are saved without a value.
+ *
+ * Like getenv(), if a variable is defined more than once, the first
+ * definition is used.
+ *
+ * \return The snapshot of the option environment variables.
+ */
+getopt::environment_snapshot_t getopt::snapshot_environment() const
+{
+    environment_snapshot_t snapshot;
+
+    char const * const intro(f_options_environment.f_environment_variable_intro);
+    for(auto const & opt : f_options_by_name)
+    {
+        std::string const name(opt.second->get_environment_variable_name());
+        if(!name.empty())
+        {
+            snapshot[intro == nullptr ? name : intro + name];
+        }
+    }
+
+    if(snapshot.empty())
+    {
+        return snapshot;
+    }
+
+    for(char ** env(environ); env != nullptr && *env != nullptr; ++env)
+    {
+        char const * const equal(strchr(*env, '='));
+        if(equal == nullptr)
+        {
+            continue;
+        }
+        auto it(snapshot.find(std::string(*env, equal - *env)));
+        if(it != snapshot.end()
+        && !it->second.has_value())
+        {
+            it->second = std::string(equal + 1);
+        }
+    }
+
+    return snapshot;
+}
+
+
 /** \brief Check for an environment variable.
  *
  * If the name of an environment variable is specified in the option
@@ -817,6 +1049,10 @@ void getopt::define_environment_variable_data()
  * you may allow options to appear on the command line, in configuration
  * files, in environment variables or a mix of all of these locations.
  *
+ * The values of the option environment variables are read when this
+ * function gets called. The environment is scanned once for all the
+ * options (see snapshot_environment()).
+ *
  * \note
  * If you change the environment variable between the creation of the
  * getopt object and a call to this function, you want to call the
@@ -837,20 +1073,26 @@ void getopt::parse_environment_variable()
 
     // second check each option environment variable
     //
+    environment_snapshot_t const snapshot(snapshot_environment());
+    char const * const intro(f_options_environment.f_environment_variable_intro);
     for(auto const & opt : f_options_by_name)
     {
         std::string const name(opt.second->get_environment_variable_name());
+        if(name.empty())
+        {
+            continue;
+        }
 
-        // get the value, only set the option if the variable is set
+        auto const it(snapshot.find(intro == nullptr ? name : intro + name));
+
+        // only set the option if the variable is set
         //
-        std::string value;
-        if(opt.second->get_environment_variable_value(
-                  value
-                , f_options_environment.f_environment_variable_intro))
+        if(it != snapshot.end()
+        && it->second.has_value())
         {
             add_option_from_string(
                       opt.second
-                    , value
+                    , *it->second
                     , std::string()
                     , string_list_t()
                     , option_source_t::SOURCE_ENVIRONMENT_VARIABLE);
@@ -874,6 +1116,10 @@ void getopt::parse_environment_variable()
  * This function actually transforms the input string in an array of
  * strings and then calls the parse_arguments() function.
  *
+ * That array is allocated from an arena which only exists for the
+ * duration of this call. The option values are still saved in
+ * std::string objects.
+ *
  * \note
  * The input allows for an empty string in which case pretty much nothing
  * happens.
@@ -888,7 +1134,14 @@ void getopt::parse_string(
         , option_source_t source
         , bool only_environment_variable)
 {
-    string_list_t args(split_environment(str));
+    // allocate these buffers from an arena which only lives until
+    // parse_arguments() returns; it starts with a buffer on the stack
+    // so short strings do not allocate at all
+    //
+    alignas(std::max_align_t) std::byte buffer[g_arena_buffer_size];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+    std::pmr::vector<std::pmr::string> args(&arena);
+    split_arguments(str, args);
     if(args.empty())
     {
         // nothing extra to do
@@ -902,9 +1155,7 @@ void getopt::parse_string(
 
     // the argv array has to be a null terminated bare string pointers
     //
-    std::vector<char *> sub_argv;
-
-    sub_argv.resize(args.size() + 2);
+    std::pmr::vector<char *> sub_argv(args.size() + 2, nullptr, &arena);
 
     // argv[0] is the program name
     //
@@ -948,54 +1199,8 @@ void getopt::parse_string(
  */
 string_list_t getopt::split_environment(std::string const & environment)
 {
-    // this is exactly like the command line only in an environment variable
-    // so parse the parameters just like the shell
-    //
     string_list_t args;
-    std::string a;
-    char const * s(environment.c_str());
-    while(*s != '\0')
-    {
-        if(isspace(*s))
-        {
-            if(!a.empty())
-            {
-                args.push_back(a);
-                a.clear();
-            }
-            do
-            {
-                ++s;
-            }
-            while(isspace(*s));
-        }
-        else if(*s == '"'
-             || *s == '\'')
-        {
-            // support quotations and remove them from the argument
-            //
-            char const quote(*s++);
-            while(*s != '\0'
-               && *s != quote)
-            {
-                a += *s++;
-            }
-            if(*s != '\0')
-            {
-                ++s;
-            }
-        }
-        else
-        {
-            a += *s++;
-        }
-    }
-
-    if(!a.empty())
-    {
-        args.push_back(a);
-    }
-
+    split_arguments(environment, args);
     return args;
 }
 
@@ -1609,6 +1814,71 @@ option_info::pointer_t getopt::get_option(short_name_t short_name, bool exact_op
 }
 
 
+/** \brief Search an option by name.
+ *
+ * This function searches an option like get_option() does, except that
+ * it never throws and the search is done with the \p name view as is.
+ * A copy of the name is only created when it includes underscores.
+ *
+ * Aliases are always resolved. If the alias destination is missing, the
+ * function returns a nullptr.
+ *
+ * \param[in] name  The name of the option to search.
+ *
+ * \return The pointer to the named option or nullptr if not found.
+ */
+option_info::pointer_t getopt::find_option(std::string_view name) const
+{
+    if(name.empty())
+    {
+        return option_info::pointer_t();
+    }
+
+    if(name.find('_') != std::string_view::npos)
+    {
+        return find_option(option_with_dashes(std::string(name)));
+    }
+
+    option_info::pointer_t opt;
+    if(name == "--")
+    {
+        opt = f_default_option;
+    }
+    else
+    {
+        // a short name is at most 4 bytes (one UTF-8 character)
+        //
+        short_name_t const short_name(name.length() <= 4
+                        ? string_to_short_name(std::string(name))
+                        : NO_SHORT_NAME);
+        if(short_name != NO_SHORT_NAME)
+        {
+            auto it(f_options_by_short_name.find(short_name));
+            if(it != f_options_by_short_name.end())
+            {
+                opt = it->second;
+            }
+        }
+        else
+        {
+            auto it(f_options_by_name.find(name));
+            if(it != f_options_by_name.end())
+            {
+                opt = it->second;
+            }
+        }
+    }
+
+    if(opt != nullptr
+    && opt->has_flag(GETOPT_FLAG_ALIAS))
+    {
+        opt = opt->get_alias_destination();
+    }
+
+    return opt;
+}
+
+
 /** \brief Read parameters of the current option.
  *
  * This function saves the option in the list of options found in this list
@@ -1734,7 +2004,7 @@ void getopt::add_option_from_string(
         //
         if(is_false(value))
         {
-            opt->reset();
+            opt->reset(source);
             return;
         }
 
@@ -36,10 +36,14 @@
 
 // C++
 //
+#include    <functional>
 #include    <limits>
 #include    <map>
 #include    <memory>
+#include    <optional>
 #include    <ostream>
+#include    <string_view>
+#include    <unordered_map>
 #include    <vector>
 
 
@@ -73,15 +77,26 @@ constexpr flag_t            SYSTEM_OPTION_OPTIONS_MASK                  = 0xF000
 
 
 
+class option_schema;
+
+
 class getopt
 {
 public:
     typedef std::shared_ptr<getopt>     pointer_t;
+    typedef std::map<std::string, std::string>
+                                        value_map_t;
+    typedef std::function<void (getopt const & opt, option_info::vector_t const & changed)>
+                                        batch_callback_t;
 
                             getopt(options_environment const & opts);
                             getopt(options_environment const & opts
                                  , int argc
                                  , char * argv[]);
+                            getopt(std::shared_ptr<option_schema const> schema);
+                            getopt(std::shared_ptr<option_schema const> schema
+                                 , int argc
+                                 , char * argv[]);
 
     options_environment const &
                             get_options_environment() const;
@@ -113,6 +128,7 @@ public:
                                       int argc = 0
                                     , char * argv[] = nullptr);
     void                    process_configuration_file(std::string const & filename);
+    option_info::vector_t   reload_configuration_files();
 
     std::string             get_environment_variable() const;
     static string_list_t    split_environment(std::string const & environment);
@@ -144,11 +160,14 @@ public:
     option_info::pointer_t  get_option(
                                       short_name_t name
                                     , bool exact_option = false) const;
+    option_info::pointer_t  find_option(std::string_view name) const;
     std::string             options_to_string(
                                       bool include_progname = false
                                     , bool keep_defaults = false) const;
     bool                    is_defined(std::string const & name) const;
     std::size_t             size(std::string const & name) const;
+    static option_info::generation_t
+                            get_global_generation();
     bool                    has_default(std::string const & name) const;
     std::string             get_default(std::string const & name) const;
     long                    get_long(
@@ -161,10 +180,29 @@ public:
                                     , int idx = 0
                                     , double min = std::numeric_limits<double>::min()
                                     , double max = std::numeric_limits<double>::max()) const;
+    std::optional<long>     try_get_long(
+                                      std::string_view name
+                                    , int idx = 0
+                                    , long min = std::numeric_limits<long>::min()
+                                    , long max = std::numeric_limits<long>::max()) const;
+    std::optional<double>   try_get_double(
+                                      std::string_view name
+                                    , int idx = 0
+                                    , double min = std::numeric_limits<double>::lowest()
+                                    , double max = std::numeric_limits<double>::max()) const;
     std::string             get_string(
                                       std::string const & name
                                     , int idx = 0
                                     , bool raw = false) const;
+    std::optional<std::string>
+                            try_get_string(
+                                      std::string_view name
+                                    , int idx = 0
+                                    , bool raw = false) const;
+    std::optional<std::string_view>
+                            try_get_raw_string(
+                                      std::string_view name
+                                    , int idx = 0) const;
     std::string             operator [] (std::string const & name) const;
     option_info_ref         operator [] (std::string const & name);
 
@@ -191,15 +229,35 @@ public:
     std::string             usage(flag_t show = GETOPT_FLAG_SHOW_MOST) const;
     std::string             process_help_string(char const * help) const;
 
+    bool                    set_dynamic_values(
+                                      value_map_t const & values
+                                    , option_source_t source = option_source_t::SOURCE_DYNAMIC);
+    option_info::callback_id_t
+                            add_batch_callback(batch_callback_t const & c);
+    void                    remove_batch_callback(option_info::callback_id_t id);
+    std::vector<option_info::value_snapshot_pointer_t>
+                            get_snapshots(string_list_t const & names) const;
+
     variables::pointer_t    get_variables() const;
 
 private:
+    typedef std::unordered_map<std::string, std::optional<std::string>>
+                            environment_snapshot_t;
+    typedef std::vector<std::pair<option_info::callback_id_t, batch_callback_t>>
+                            batch_callback_vector_t;
+    typedef std::shared_ptr<batch_callback_vector_t const>
+                            batch_callback_list_t;
+
     void                    initialize_parser(options_environment const & opt_env);
+    void                    initialize_parser(std::shared_ptr<option_schema const> schema);
+    environment_snapshot_t  snapshot_environment() const;
     void                    parse_options_from_group_names();
     void                    parse_options_from_file();
     void                    show_option_sources(std::basic_ostream<char> & out);
     option_info::pointer_t  get_alias_destination(option_info::pointer_t opt) const;
     void                    is_parsed() const;
+    bool                    is_done() const;
+    void                    call_batch_callbacks(option_info::vector_t const & changed) const;
     static string_list_t    find_config_dir(int argc, char * argv[]);
     static void             add_configuration_filename(string_list_t & names, std::string const & add);
     void                    get_managed_configuration_filenames(
@@ -229,6 +287,8 @@ private:
     option_info::pointer_t              f_default_option = option_info::pointer_t();
     std::string                         f_environment_variable = std::string();
     variables::pointer_t                f_variables = variables::pointer_t();
+    batch_callback_list_t               f_batch_callbacks = batch_callback_list_t();
+    option_info::callback_id_t          f_next_batch_callback_id = 0;
     bool                                f_parsed = false;
 };
 
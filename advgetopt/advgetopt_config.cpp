@@ -54,6 +54,40 @@ namespace advgetopt
 
 
 
+namespace
+{
+
+
+
+/** \brief Set the configuration trace context for the current file.
+ *
+ * The trace of the sources uses the name of the configuration file
+ * being processed. This object sets that name for the duration of
+ * one getopt::process_configuration_file() call.
+ */
+class configuration_trace
+{
+public:
+    configuration_trace(std::string const & filename)
+    {
+        option_info::set_configuration_filename(filename);
+    }
+
+    configuration_trace(configuration_trace const &) = delete;
+    configuration_trace & operator = (configuration_trace const &) = delete;
+
+    ~configuration_trace()
+    {
+        option_info::set_configuration_filename(std::string());
+    }
+};
+
+
+
+} // no name namespace
+
+
+
 
 /** \brief Generate a list of configuration filenames.
  *
@@ -615,6 +649,97 @@ void getopt::parse_configuration_files(int argc, char * argv[])
 }
 
 
+/** \brief Read the configuration files again.
+ *
+ * This function is used to apply changes made to the configuration
+ * files while the program is running (i.e. on a SIGHUP.)
+ *
+ * The values of the options are organized in layers: configuration
+ * files, environment variable, command line, and values set by the
+ * program. Only the configuration file layer gets replaced.
+ *
+ * The layers are only kept when the GETOPT_ENVIRONMENT_FLAG_RELOAD_CONFIGURATION
+ * flag is set in the options environment. Without it, the options only
+ * keep their current values (which saves memory) and this function
+ * throws. The other
+ * layers are not parsed again. Their values are applied again on top
+ * of the new configuration values so they keep their priority. For
+ * example, an option specified on the command line keeps its command
+ * line value even if the configuration file changed.
+ *
+ * The list of configuration files is determined as by
+ * parse_configuration_files(), using the current `--config-dir`
+ * value, if any. Those files are removed from the configuration file
+ * cache so they are read from disk again. The other cached files are
+ * left alone.
+ *
+ * The options which changed are published at once with one generation
+ * (as with set_dynamic_values()) and then the callbacks of each option
+ * and the batch callbacks are called.
+ *
+ * \note
+ * The variables defined in the configuration files are updated, but
+ * variables which were removed from the files are not removed.
+ *
+ * \exception getopt_logic_error
+ * The GETOPT_ENVIRONMENT_FLAG_RELOAD_CONFIGURATION flag must be set.
+ *
+ * \return The list of options which changed.
+ *
+ * \sa parse_configuration_files()
+ * \sa option_info::rewind_layer()
+ */
+option_info::vector_t getopt::reload_configuration_files()
+{
+    is_parsed();
+
+    if(!has_flag(GETOPT_ENVIRONMENT_FLAG_RELOAD_CONFIGURATION))
+    {
+        throw getopt_logic_error(
+                  "reload_configuration_files() requires the"
+                  " GETOPT_ENVIRONMENT_FLAG_RELOAD_CONFIGURATION flag.");
+    }
+
+    string_list_t const filenames(get_configuration_filenames(false, false));
+
+    // only forget the files we read again; the other conf_file objects
+    // may be used elsewhere in this process
+    //
+    for(auto const & f : filenames)
+    {
+        conf_file::reset_conf_file(conf_file_setup(f).get_filename());
+    }
+
+    for(auto const & opt : f_options_by_name)
+    {
+        opt.second->rewind_layer(option_source_t::SOURCE_CONFIGURATION);
+    }
+
+    for(auto const & f : filenames)
+    {
+        process_configuration_file(f);
+    }
+    f_parsed = true;
+
+    // new options may have been added by the configuration files; those
+    // were not rewound so forward_layer() ignores them
+    //
+    option_info::vector_t changed;
+    for(auto const & opt : f_options_by_name)
+    {
+        if(opt.second->forward_layer())
+        {
+            changed.push_back(opt.second);
+        }
+    }
+
+    option_info::publish_changes(changed);
+    call_batch_callbacks(changed);
+
+    return changed;
+}
+
+
 /** \brief Parse one specific configuration file and process the results.
  *
  * This function reads one specific configuration file using a conf_file
@@ -639,7 +764,7 @@ void getopt::parse_configuration_files(int argc, char * argv[])
  */
 void getopt::process_configuration_file(std::string const & filename)
 {
-    option_info::set_configuration_filename(filename);
+    configuration_trace trace(filename);
 
     conf_file_setup::pointer_t conf_setup;
     if(f_options_environment.f_config_setup == nullptr)
@@ -681,6 +806,7 @@ void getopt::process_configuration_file(std::string const & filename)
             configuration_sections->add_flag(
                           GETOPT_FLAG_MULTIPLE
                         | GETOPT_FLAG_CONFIGURATION_FILE);
+            configuration_sections->set_keep_layers(has_flag(GETOPT_ENVIRONMENT_FLAG_RELOAD_CONFIGURATION));
             f_options_by_name[configuration_sections->get_name()] = configuration_sections;
         }
         else if(!configuration_sections->has_flag(GETOPT_FLAG_MULTIPLE))
@@ -738,6 +864,7 @@ void getopt::process_configuration_file(std::string const & filename)
                 // (which is likely in our environment)
                 //
                 opt->set_default(param.second);
+                opt->set_keep_layers(has_flag(GETOPT_ENVIRONMENT_FLAG_RELOAD_CONFIGURATION));
 
                 f_options_by_name[opt->get_name()] = opt;
             }
@@ -808,6 +935,7 @@ void getopt::process_configuration_file(std::string const & filename)
 
         }
 
+        option_info::set_configuration_line(param.second.get_line());
         add_option_from_string(
                   opt
                 , value
@@ -37,7 +37,9 @@
 
 // cppthread
 //
+#include    <cppthread/guard.h>
 #include    <cppthread/log.h>
+#include    <cppthread/mutex.h>
 
 
 // C
@@ -57,6 +59,15 @@ namespace advgetopt
 
 
 
+// from utils.cpp
+//
+// (it's here because we do not want to make cppthread public in
+// out header files--we could have an advgetopt_private.h, though)
+//
+cppthread::mutex &  get_global_mutex();
+
+
+
 
 
 /** \brief Check whether a parameter is defined.
@@ -135,6 +146,229 @@ size_t getopt::size(std::string const & name) const
 }
 
 
+/** \brief Retrieve the global generation.
+ *
+ * This function returns a counter which gets incremented each time an
+ * option value changes. A thread can poll this number and only check
+ * the options it is interested in when it changed. Further, each option
+ * has its own generation (see option_info::get_generation()).
+ *
+ * \warning
+ * The counter is global to the process. It is not specific to this
+ * getopt object. It also gets incremented when an option of another
+ * getopt object or a standalone option_info changes. So a new
+ * generation means that something may have changed, not that one of
+ * these options did change. When nothing changed, however, the
+ * generation remains the same.
+ *
+ * Reading the generation is a single atomic load and it does not
+ * require the options to be parsed.
+ *
+ * \return The current global generation.
+ *
+ * \sa option_info::get_global_generation()
+ */
+option_info::generation_t getopt::get_global_generation()
+{
+    return option_info::get_global_generation();
+}
+
+
+/** \brief Set a group of dynamic values at once.
+ *
+ * This function sets all the values found in \p values as one atomic
+ * update. The names are the long or short names of the options. See
+ * option_info::apply_batch() for details about the validation and how
+ * the values get published.
+ *
+ * When the batch gets applied and at least one value changed, the batch
+ * callbacks (see add_batch_callback()) are called once with the list of
+ * options which changed. This happens after the callbacks of each
+ * option were called.
+ *
+ * If a name does not match an option, an error is logged and nothing
+ * changes.
+ *
+ * \param[in] values  The map of option names and their new value.
+ * \param[in] source  Where the values come from.
+ *
+ * \return true if all the values were valid and thus applied.
+ */
+bool getopt::set_dynamic_values(
+      value_map_t const & values
+    , option_source_t source)
+{
+    option_info::value_batch_t batch;
+    batch.reserve(values.size());
+    bool valid(true);
+    for(auto const & v : values)
+    {
+        option_info::pointer_t opt(v.first.empty()
+                                        ? option_info::pointer_t()
+                                        : get_option(v.first));
+        if(opt == nullptr)
+        {
+            cppthread::log << cppthread::log_level_t::error
+                           << "option \"--"
+                           << v.first
+                           << "\" is not defined."
+                           << cppthread::end;
+            valid = false;
+            continue;
+        }
+        batch.emplace_back(opt, v.second);
+    }
+    if(!valid)
+    {
+        return false;
+    }
+
+    option_info::vector_t changed;
+    if(!option_info::apply_batch(batch, changed, source))
+    {
+        return false;
+    }
+
+    call_batch_callbacks(changed);
+
+    return true;
+}
+
+
+/** \brief Call the batch callbacks.
+ *
+ * This function calls all the batch callbacks with the list of options
+ * which changed. If \p changed is empty, nothing happens.
+ *
+ * The list of callbacks is immutable. The global mutex is held just long
+ * enough to get a reference to the current list. The callbacks are
+ * called without the lock.
+ *
+ * \param[in] changed  The list of options which changed.
+ */
+void getopt::call_batch_callbacks(option_info::vector_t const & changed) const
+{
+    if(changed.empty())
+    {
+        return;
+    }
+
+    batch_callback_list_t callbacks;
+    {
+        cppthread::guard lock(get_global_mutex());
+        callbacks = f_batch_callbacks;
+    }
+    if(callbacks == nullptr)
+    {
+        return;
+    }
+
+    for(auto const & c : *callbacks)
+    {
+        c.second(*this, changed);
+    }
+}
+
+
+/** \brief Add a callback called once per batch of dynamic values.
+ *
+ * The set_dynamic_values() function calls these callbacks once all the
+ * values of a batch were updated. The callback receives the list of
+ * options which changed so it can react to all the changes at once.
+ *
+ * \param[in] c  The callback.
+ *
+ * \return The identifier of the new callback.
+ */
+option_info::callback_id_t getopt::add_batch_callback(batch_callback_t const & c)
+{
+    cppthread::guard lock(get_global_mutex());
+
+    std::shared_ptr<batch_callback_vector_t> callbacks(f_batch_callbacks == nullptr
+            ? std::make_shared<batch_callback_vector_t>()
+            : std::make_shared<batch_callback_vector_t>(*f_batch_callbacks));
+
+    ++f_next_batch_callback_id;
+    callbacks->emplace_back(f_next_batch_callback_id, c);
+    f_batch_callbacks = callbacks;
+
+    return f_next_batch_callback_id;
+}
+
+
+/** \brief Remove a batch callback.
+ *
+ * This function removes a callback added with add_batch_callback().
+ *
+ * \param[in] id  The identifier returned by add_batch_callback().
+ */
+void getopt::remove_batch_callback(option_info::callback_id_t id)
+{
+    cppthread::guard lock(get_global_mutex());
+
+    batch_callback_list_t const current(f_batch_callbacks);
+    if(current == nullptr)
+    {
+        return;
+    }
+
+    std::shared_ptr<batch_callback_vector_t> callbacks(std::make_shared<batch_callback_vector_t>());
+    for(auto const & c : *current)
+    {
+        if(c.first != id)
+        {
+            callbacks->push_back(c);
+        }
+    }
+    if(callbacks->size() != current->size())
+    {
+        f_batch_callbacks = callbacks->empty()
+                    ? batch_callback_list_t()
+                    : batch_callback_list_t(callbacks);
+    }
+}
+
+
+/** \brief Get the snapshots of several options at once.
+ *
+ * Reading the snapshot of one option does not lock any mutex. However,
+ * reading the snapshots of several options one after the other may
+ * return a mix of old and new values if set_dynamic_values() runs in
+ * between.
+ *
+ * This function retrieves all the snapshots with the global mutex
+ * locked. A batch publishes its snapshots with that same mutex locked
+ * so they are either all from before or all from after a batch.
+ *
+ * \param[in] names  The names of the options to read.
+ *
+ * \return One snapshot per name, nullptr if that option does not exist.
+ */
+std::vector<option_info::value_snapshot_pointer_t> getopt::get_snapshots(string_list_t const & names) const
+{
+    std::vector<option_info::pointer_t> options;
+    options.reserve(names.size());
+    for(auto const & n : names)
+    {
+        options.push_back(n.empty() ? option_info::pointer_t() : get_option(n));
+    }
+
+    std::vector<option_info::value_snapshot_pointer_t> result;
+    result.reserve(options.size());
+
+    cppthread::guard lock(get_global_mutex());
+
+    for(auto const & opt : options)
+    {
+        result.push_back(opt == nullptr
+                    ? option_info::value_snapshot_pointer_t()
+                    : opt->get_snapshot());
+    }
+
+    return result;
+}
+
+
 /** \brief Check whether an option has a default value.
  *
  * Some parameters may be given a default. This function is used to
@@ -305,6 +539,70 @@ long getopt::get_long(std::string const & name, int idx, long min, long max) con
 }
 
 
+/** \brief Try to retrieve an argument as a long value.
+ *
+ * This function is similar to get_long() except that it does not throw
+ * and does not log errors. Instead it returns std::nullopt when:
+ *
+ * \li the parser is not done yet;
+ * \li the \p name option does not exist;
+ * \li the option is not defined and it has no valid default;
+ * \li \p idx is out of bounds;
+ * \li the value is not a valid integer;
+ * \li the value is out of the \p min to \p max range.
+ *
+ * This way code which polls an option does not have to first call
+ * is_defined() and size(). The option is searched with find_option()
+ * so the \p name does not get copied.
+ *
+ * \param[in] name  The name of the option to retrieve.
+ * \param[in] idx  The index of the argument to retrieve.
+ * \param[in] min  The minimum value that will be returned (inclusive).
+ * \param[in] max  The maximum value that will be returned (inclusive).
+ *
+ * \return The argument as a long or std::nullopt.
+ */
+std::optional<long> getopt::try_get_long(
+      std::string_view name
+    , int idx
+    , long min
+    , long max) const
+{
+    if(!is_done())
+    {
+        return std::nullopt;
+    }
+
+    option_info::pointer_t opt(find_option(name));
+    if(opt == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    std::optional<long> result;
+    if(!opt->is_defined())
+    {
+        std::int64_t d(0);
+        if(validator_integer::convert_string(opt->get_default(), d))
+        {
+            result = d;
+        }
+    }
+    else
+    {
+        result = opt->try_get_long(idx);
+    }
+
+    if(result.has_value()
+    && (*result < min || *result > max))
+    {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+
 /** \brief This function retrieves an argument as a double value.
  *
  * This function reads the specified argument from the named option and
@@ -412,6 +710,60 @@ double getopt::get_double(std::string const & name, int idx, double min, double
 }
 
 
+/** \brief Try to retrieve an argument as a double value.
+ *
+ * This function is similar to get_double() except that it does not throw
+ * and does not log errors. It returns std::nullopt in the same cases as
+ * try_get_long().
+ *
+ * \param[in] name  The name of the option to retrieve.
+ * \param[in] idx  The index of the argument to retrieve.
+ * \param[in] min  The minimum value that will be returned (inclusive).
+ * \param[in] max  The maximum value that will be returned (inclusive).
+ *
+ * \return The argument as a double or std::nullopt.
+ */
+std::optional<double> getopt::try_get_double(
+      std::string_view name
+    , int idx
+    , double min
+    , double max) const
+{
+    if(!is_done())
+    {
+        return std::nullopt;
+    }
+
+    option_info::pointer_t opt(find_option(name));
+    if(opt == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    std::optional<double> result;
+    if(!opt->is_defined())
+    {
+        double d(0.0);
+        if(validator_double::convert_string(opt->get_default(), d))
+        {
+            result = d;
+        }
+    }
+    else
+    {
+        result = opt->try_get_double(idx);
+    }
+
+    if(result.has_value()
+    && (*result < min || *result > max))
+    {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+
 /** \brief Get the content of an option as a string.
  *
  * Get the content of the named parameter as a string. Command line options
@@ -480,6 +832,112 @@ std::string getopt::get_string(
 }
 
 
+/** \brief Try to get the content of an option as a string.
+ *
+ * This function is similar to get_string() except that it returns
+ * std::nullopt instead of throwing when the parser is not done yet, the
+ * option does not exist, is not defined and has no default, or \p idx
+ * is out of bounds.
+ *
+ * \param[in] name  The name of the option to read.
+ * \param[in] idx  The zero based index of a multi-argument command line option.
+ * \param[in] raw  Whether to return the value without replacing the variables.
+ *
+ * \return The option argument as a string or std::nullopt.
+ */
+std::optional<std::string> getopt::try_get_string(
+      std::string_view name
+    , int idx
+    , bool raw) const
+{
+    if(!is_done())
+    {
+        return std::nullopt;
+    }
+
+    option_info::pointer_t opt(find_option(name));
+    if(opt == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    if(!opt->is_defined())
+    {
+        if(opt->has_default())
+        {
+            return opt->get_default();
+        }
+        return std::nullopt;
+    }
+
+    std::optional<std::string> value(opt->try_get_value(idx, raw));
+    if(value.has_value()
+    && value->empty()
+    && opt->has_default()
+    && !opt->has_flag(GETOPT_FLAG_REQUIRED))
+    {
+        return opt->get_default();
+    }
+
+    return value;
+}
+
+
+/** \brief Get a view of the raw content of an option.
+ *
+ * This function returns a view of the raw value of an option. The
+ * value does not go through the variable processing and no copy is
+ * made. It otherwise follows the same rules as try_get_string(): if
+ * the option is not defined, its default value is returned and if it
+ * has no default, std::nullopt is returned.
+ *
+ * \warning
+ * The view points to the internal buffer of the option. It becomes
+ * invalid as soon as that option gets modified (i.e. a call to
+ * reset(), a configuration file reloaded, etc.)
+ *
+ * \param[in] name  The name of the option to read.
+ * \param[in] idx  The zero based index of a multi-argument command line option.
+ *
+ * \return A view of the option argument or std::nullopt.
+ */
+std::optional<std::string_view> getopt::try_get_raw_string(
+      std::string_view name
+    , int idx) const
+{
+    if(!is_done())
+    {
+        return std::nullopt;
+    }
+
+    option_info::pointer_t opt(find_option(name));
+    if(opt == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    if(!opt->is_defined())
+    {
+        if(opt->has_default())
+        {
+            return std::string_view(opt->get_definition()->f_default_value);
+        }
+        return std::nullopt;
+    }
+
+    std::optional<std::string_view> value(opt->try_get_raw_value(idx));
+    if(value.has_value()
+    && value->empty()
+    && opt->has_default()
+    && !opt->has_flag(GETOPT_FLAG_REQUIRED))
+    {
+        return std::string_view(opt->get_definition()->f_default_value);
+    }
+
+    return value;
+}
+
+
 /** \brief Retrieve the value of an argument.
  *
  * This operator returns the value of an argument just like the get_string()
@@ -594,6 +1052,7 @@ option_info_ref getopt::operator [] (std::string const & name)
         opt = std::make_shared<option_info>(name);
         opt->set_variables(f_variables);
         opt->add_flag(GETOPT_FLAG_DYNAMIC_CONFIGURATION);
+        opt->set_keep_layers(has_flag(GETOPT_ENVIRONMENT_FLAG_RELOAD_CONFIGURATION));
         f_options_by_name[name] = opt;
     }
 
@@ -263,6 +263,11 @@ void getopt::add_option(option_info::pointer_t opt, bool ignore_duplicates)
         f_default_option = opt;
     }
 
+    if(has_flag(GETOPT_ENVIRONMENT_FLAG_RELOAD_CONFIGURATION))
+    {
+        opt->set_keep_layers(true);
+    }
+
     f_options_by_name[opt->get_name()] = opt;
 
     if(short_name != NO_SHORT_NAME)
@@ -872,7 +877,7 @@ void getopt::show_option_sources(std::basic_ostream<char> & out)
     for(auto const & opt : f_options_by_name)
     {
         out << "  " << idx << ". option \"" << opt.second->get_name() << "\"";
-        string_list_t sources(opt.second->trace_sources());
+        string_list_t const & sources(opt.second->trace_sources());
         if(sources.empty())
         {
             out << " (undefined)\n";
@@ -853,6 +853,27 @@ void conf_file::reset_conf_files()
 }
 
 
+/** \brief Forget one cached configuration file.
+ *
+ * This function removes one configuration file from the cache so the
+ * next get_conf_file() with that file reads it from disk again. The
+ * other configuration files are not affected.
+ *
+ * Existing pointers to that conf_file, and the callbacks attached to it,
+ * remain valid. They just do not see the data of the new instance.
+ *
+ * \param[in] filename  The canonicalized filename of the configuration
+ * file as returned by conf_file_setup::get_filename().
+ *
+ * \sa reset_conf_files()
+ */
+void conf_file::reset_conf_file(std::string const & filename)
+{
+    cppthread::guard lock(get_global_mutex());
+    g_conf_files.erase(filename);
+}
+
+
 /** \brief Save the configuration file.
  *
  * This function saves the current data from this configuration file to
@@ -1091,7 +1112,12 @@ conf_file_setup const & conf_file::get_setup() const
  * call.
  *
  * If you specifcy a \p parameter_name, the callback is called only if the
- * parameter has that specific name.
+ * parameter has that specific name. As with the other parameter
+ * functions, underscores in the name are viewed as dashes.
+ *
+ * The callbacks are saved in an immutable map indexed by parameter name.
+ * This function creates a new map and replaces the old one while holding
+ * the global mutex.
  *
  * \param[in] c  The new callback std::function.
  * \param[in] parameter_name  The parameter name or an empty string.
@@ -1102,10 +1128,19 @@ conf_file::callback_id_t conf_file::add_callback(
           callback_t const & c
         , std::string const & parameter_name)
 {
+    std::string name(parameter_name);
+    std::replace(name.begin(), name.end(), '_', '-');
+
     cppthread::guard lock(get_global_mutex());
 
+    std::shared_ptr<callback_map_t> callbacks(f_callbacks == nullptr
+            ? std::make_shared<callback_map_t>()
+            : std::make_shared<callback_map_t>(*f_callbacks));
+
     ++f_next_callback_id;
-    f_callbacks.emplace_back(f_next_callback_id, c, parameter_name);
+    (*callbacks)[name].emplace_back(f_next_callback_id, c);
+    f_callbacks = callbacks;
+
     return f_next_callback_id;
 }
 
@@ -1123,16 +1158,35 @@ void conf_file::remove_callback(callback_id_t id)
 {
     cppthread::guard lock(get_global_mutex());
 
-    auto it(std::find_if(
-              f_callbacks.begin()
-            , f_callbacks.end()
-            , [id](auto e)
-            {
-                return e.f_id == id;
-            }));
-    if(it != f_callbacks.end())
+    callback_list_t const current(f_callbacks);
+    if(current == nullptr)
+    {
+        return;
+    }
+
+    for(auto const & l : *current)
     {
-        f_callbacks.erase(it);
+        auto it(std::find_if(
+                  l.second.begin()
+                , l.second.end()
+                , [id](auto const & e)
+                {
+                    return e.f_id == id;
+                }));
+        if(it != l.second.end())
+        {
+            std::shared_ptr<callback_map_t> callbacks(std::make_shared<callback_map_t>(*current));
+            callback_vector_t & v(callbacks->at(l.first));
+            v.erase(v.begin() + (it - l.second.begin()));
+            if(v.empty())
+            {
+                callbacks->erase(l.first);
+            }
+            f_callbacks = callbacks->empty()
+                        ? callback_list_t()
+                        : callback_list_t(callbacks);
+            return;
+        }
     }
 }
 
@@ -1142,33 +1196,54 @@ void conf_file::remove_callback(callback_id_t id)
  * This function is called on a change of the internal values.
  *
  * The function is used to call the callbacks that were added to this
- * option_info object. The function first copies the existing list of
- * callbacks so you can safely update the list from within a callback.
+ * conf_file object. The callbacks listening to all the parameters are
+ * called first, then the callbacks listening to \p parameter_name.
+ * The other callbacks are not even looked at.
+ *
+ * The map of callbacks is immutable so the function only needs to hold
+ * a reference to the current map. The global mutex is held just long
+ * enough to get that reference. You can safely update the list from
+ * within a callback, the change will be visible on the next call.
  *
  * \warning
  * Destroying your advgetopt::getopt option is not safe while a callback
  * is running.
+ *
+ * \param[in] action  The action that happened to the parameter.
+ * \param[in] parameter_name  The name of the parameter that changed.
+ * \param[in] value  The new value of the parameter.
  */
 void conf_file::value_changed(
           callback_action_t action
         , std::string const & parameter_name
         , std::string const & value)
 {
-    callback_vector_t callbacks;
-    callbacks.reserve(f_callbacks.size());
-
+    callback_list_t callbacks;
     {
         cppthread::guard lock(get_global_mutex());
         callbacks = f_callbacks;
     }
+    if(callbacks == nullptr)
+    {
+        return;
+    }
 
-    for(auto & e : callbacks)
+    auto call = [&](std::string const & name)
     {
-        if(e.f_parameter_name.empty()
-        || e.f_parameter_name == parameter_name)
+        auto const it(callbacks->find(name));
+        if(it != callbacks->end())
         {
-            e.f_callback(shared_from_this(), action, parameter_name, value);
+            for(auto const & e : it->second)
+            {
+                e.f_callback(shared_from_this(), action, parameter_name, value);
+            }
         }
+    };
+
+    call(std::string());
+    if(!parameter_name.empty())
+    {
+        call(parameter_name);
     }
 }
 
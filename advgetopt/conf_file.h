@@ -39,6 +39,7 @@
 #include    <map>
 #include    <memory>
 #include    <set>
+#include    <unordered_map>
 
 
 
@@ -195,6 +196,7 @@ public:
 
     static pointer_t            get_conf_file(conf_file_setup const & setup);
     static void                 reset_conf_files();
+    static void                 reset_conf_file(std::string const & filename);
 
     bool                        save_configuration(
                                       std::string backup_extension = std::string(".bak")
@@ -238,20 +240,21 @@ private:
     {
         callback_entry_t(
                     callback_id_t id
-                  , callback_t const & c
-                  , std::string const & name)
+                  , callback_t const & c)
             : f_id(id)
             , f_callback(c)
-            , f_parameter_name(name)
         {
         }
 
         callback_id_t           f_id = 0;
         callback_t              f_callback = callback_t();
-        std::string             f_parameter_name = std::string();
     };
     typedef std::vector<callback_entry_t>
                                 callback_vector_t;
+    typedef std::unordered_map<std::string, callback_vector_t>
+                                callback_map_t;
+    typedef std::shared_ptr<callback_map_t const>
+                                callback_list_t;
 
                                 conf_file(conf_file_setup const & setup);
 
@@ -276,7 +279,7 @@ private:
     sections_t                  f_sections = sections_t();
     variables::pointer_t        f_variables = variables::pointer_t();
     parameters_t                f_parameters = parameters_t();
-    callback_vector_t           f_callbacks = callback_vector_t();
+    callback_list_t             f_callbacks = callback_list_t();
     callback_id_t               f_next_callback_id = 0;
 };
 
@@ -30,6 +30,7 @@
 #include    "advgetopt/option_info.h"
 
 #include    "advgetopt/exception.h"
+#include    "advgetopt/validator_address.h"
 #include    "advgetopt/validator_double.h"
 #include    "advgetopt/validator_integer.h"
 
@@ -53,6 +54,12 @@
 #include    <libutf8/iterator.h>
 
 
+// C++
+//
+#include    <algorithm>
+#include    <limits>
+
+
 // last include
 //
 #include    <snapdev/poison.h>
@@ -84,17 +91,128 @@ namespace
 bool g_trace_sources = false;
 
 
-/** \brief The filename of the configuration being processed.
+/** \brief The global generation counter.
+ *
+ * Each time the value of an option changes, this counter gets
+ * incremented. The new counter is also saved in the option generation.
+ * See option_info::get_generation() for details.
+ */
+std::atomic<option_info::generation_t> g_generation = 0;
+
+
+/** \brief The configuration being processed.
+ *
+ * This structure holds the identifier of the filename and the line of
+ * the configuration currently being processed. This information is used
+ * to generate the trace of the sources. That way it is possible to see
+ * where the current value of a given variable comes from.
  *
- * This variable holds the filename of the configuration currently
- * being processed. This information is used to generate the trace
- * of the sources. That way it is possible to see where the current
- * value of a given variable comes from.
+ * The context is thread local so two threads can parse configuration
+ * files at the same time without mixing up their traces.
  *
- * This parameter is currently set from the
+ * The context is currently set from the
  * getopt::process_configuration_file() function.
  */
-std::string g_configuration_filename = std::string();
+struct configuration_context_t
+{
+    std::uint32_t       f_filename = 0;
+    std::uint32_t       f_line = 0;
+};
+
+thread_local configuration_context_t g_configuration_context = configuration_context_t();
+
+
+/** \brief The filenames found in the trace records.
+ *
+ * The trace records only save an identifier to the filename. This vector
+ * is used to convert that identifier back to a filename. The identifier
+ * 0 represents "no filename".
+ *
+ * Access to this vector and the corresponding map must be done with the
+ * global mutex locked.
+ */
+string_list_t g_trace_filenames = string_list_t{ std::string() };
+std::map<std::string, std::uint32_t> g_trace_filename_ids = std::map<std::string, std::uint32_t>();
+
+
+/** \brief Prepend a key to a value.
+ *
+ * The values of an option with keys (GETOPT_FLAG_ARRAY) are saved as
+ * "<key>:<value>". The keys returned by getopt::parse_option_map() do
+ * not include the colon so it gets added here when missing.
+ *
+ * \param[in] key  The key of the value.
+ * \param[in] value  The value.
+ *
+ * \return The value prefixed by its key.
+ */
+std::string keyed_value(std::string const & key, std::string const & value)
+{
+    if(!key.empty()
+    && key.back() == ':')
+    {
+        return key + value;
+    }
+    return key + ':' + value;
+}
+
+
+// the std::atomic_...(std::shared_ptr) functions are deprecated in C++20
+// in favor of std::atomic<std::shared_ptr>, which C++17 does not offer
+//
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+
+/** \brief Read a snapshot pointer.
+ *
+ * The snapshot pointer gets replaced by writers while readers load it.
+ * Readers never lock a mutex, they only load the pointer atomically.
+ *
+ * \param[in] snapshot  The snapshot pointer to load.
+ *
+ * \return A copy of the snapshot pointer.
+ */
+option_info::value_snapshot_pointer_t load_snapshot(option_info::value_snapshot_pointer_t const & snapshot)
+{
+    return std::atomic_load_explicit(&snapshot, std::memory_order_acquire);
+}
+
+
+/** \brief Replace a snapshot pointer.
+ *
+ * \param[in,out] snapshot  The snapshot pointer to replace.
+ * \param[in] value  The new snapshot.
+ */
+void store_snapshot(
+      option_info::value_snapshot_pointer_t & snapshot
+    , option_info::value_snapshot_pointer_t const & value)
+{
+    std::atomic_store_explicit(&snapshot, value, std::memory_order_release);
+}
+
+
+/** \brief Replace a snapshot pointer if it did not change.
+ *
+ * \param[in,out] snapshot  The snapshot pointer to replace.
+ * \param[in] expected  The snapshot pointer to be replaced.
+ * \param[in] value  The new snapshot.
+ *
+ * \return true if the snapshot pointer was replaced.
+ */
+bool exchange_snapshot(
+      option_info::value_snapshot_pointer_t & snapshot
+    , option_info::value_snapshot_pointer_t expected
+    , option_info::value_snapshot_pointer_t const & value)
+{
+    return std::atomic_compare_exchange_strong_explicit(
+                  &snapshot
+                , &expected
+                , value
+                , std::memory_order_acq_rel
+                , std::memory_order_acquire);
+}
+
+#pragma GCC diagnostic pop
 
 
 
@@ -222,10 +340,13 @@ std::string short_name_to_string(short_name_t short_name)
  * \param[in] short_name  The short name of this option (one character.)
  */
 option_info::option_info(std::string const & name, short_name_t short_name)
-    : f_name(option_with_dashes(name))
-    , f_short_name(short_name)
 {
-    if(f_name.empty())
+    f_editable_definition = std::make_shared<definition_t>();
+    f_editable_definition->f_name = option_with_dashes(name);
+    f_editable_definition->f_short_name = short_name;
+    f_definition = f_editable_definition;
+
+    if(f_definition->f_name.empty())
     {
         if(short_name != NO_SHORT_NAME)
         {
@@ -238,7 +359,7 @@ option_info::option_info(std::string const & name, short_name_t short_name)
                       "option_info::option_info(): all options must at least have a long name.");
     }
 
-    if(f_name == "--")
+    if(f_definition->f_name == "--")
     {
         if(short_name != NO_SHORT_NAME)
         {
@@ -252,11 +373,11 @@ option_info::option_info(std::string const & name, short_name_t short_name)
     }
     else
     {
-        if(f_name[0] == '-')
+        if(f_definition->f_name[0] == '-')
         {
             throw getopt_logic_error(
                           "option_info::option_info(): an option cannot start with a dash (-), \""
-                        + f_name
+                        + f_definition->f_name
                         + "\" is not valid.");
         }
 
@@ -269,6 +390,56 @@ option_info::option_info(std::string const & name, short_name_t short_name)
 }
 
 
+/** \brief Create an option sharing an existing definition.
+ *
+ * This constructor creates a new option_info object with no value which
+ * uses the specified \p definition (name, flags, help, validator, etc.)
+ * The definition is shared, not copied, so creating many options from
+ * one option_schema is cheap.
+ *
+ * The definition of this option can still be modified (i.e. with
+ * add_flag() or set_help()). In that case, the option first makes its
+ * own copy of the definition so the other options sharing it are not
+ * affected.
+ *
+ * The alias destination is not part of the definition since it points
+ * to another option_info object. It has to be set again with
+ * set_alias_destination() (which getopt::link_aliases() does.)
+ *
+ * \exception getopt_logic_error
+ * The \p definition cannot be a null pointer.
+ *
+ * \param[in] definition  The definition of this option.
+ */
+option_info::option_info(definition_pointer_t definition)
+    : f_definition(definition)
+{
+    if(f_definition == nullptr)
+    {
+        throw getopt_logic_error(
+                      "option_info::option_info(): the definition pointer cannot be null.");
+    }
+}
+
+
+/** \brief Retrieve the definition of this option.
+ *
+ * This function returns a pointer to the immutable definition of this
+ * option. It can be used to create other option_info objects sharing
+ * the same definition.
+ *
+ * \note
+ * If the definition of this option gets modified later, the option
+ * creates a new definition. The pointer returned here remains unchanged.
+ *
+ * \return The definition of this option.
+ */
+option_info::definition_pointer_t option_info::get_definition() const
+{
+    return f_definition;
+}
+
+
 /** \brief Get the long name of the option.
  *
  * This option retrieves the long name of the option.
@@ -282,11 +453,15 @@ option_info::option_info(std::string const & name, short_name_t short_name)
  * The name is always defined. The creation of an option_info object
  * fails if the name is empty.
  *
+ * \note
+ * The name is returned by value since the definition it comes from
+ * gets replaced when modified while shared (see edit_definition()).
+ *
  * \return The long name with dashes instead of underscores.
  */
-std::string const & option_info::get_name() const
+std::string option_info::get_name() const
 {
-    return f_name;
+    return f_definition->f_name;
 }
 
 
@@ -311,7 +486,7 @@ std::string const & option_info::get_name() const
  */
 void option_info::set_short_name(short_name_t short_name)
 {
-    f_short_name = short_name;
+    edit_definition().f_short_name = short_name;
 }
 
 
@@ -325,7 +500,7 @@ void option_info::set_short_name(short_name_t short_name)
  */
 short_name_t option_info::get_short_name() const
 {
-    return f_short_name;
+    return f_definition->f_short_name;
 }
 
 
@@ -343,13 +518,13 @@ short_name_t option_info::get_short_name() const
  */
 std::string option_info::get_basename() const
 {
-    std::string::size_type const pos(f_name.rfind("::"));
+    std::string::size_type const pos(f_definition->f_name.rfind("::"));
     if(pos == std::string::npos)
     {
-        return f_name;
+        return f_definition->f_name;
     }
 
-    return f_name.substr(pos + 2);
+    return f_definition->f_name.substr(pos + 2);
 }
 
 
@@ -370,13 +545,13 @@ std::string option_info::get_basename() const
  */
 std::string option_info::get_section_name() const
 {
-    std::string::size_type const pos(f_name.rfind("::"));
+    std::string::size_type const pos(f_definition->f_name.rfind("::"));
     if(pos == std::string::npos)
     {
         return std::string();
     }
 
-    return f_name.substr(0, pos);
+    return f_definition->f_name.substr(0, pos);
 }
 
 
@@ -397,7 +572,7 @@ std::string option_info::get_section_name() const
  */
 string_list_t option_info::get_section_name_list() const
 {
-    std::string::size_type const pos(f_name.rfind("::"));
+    std::string::size_type const pos(f_definition->f_name.rfind("::"));
     if(pos == std::string::npos)
     {
         return string_list_t();
@@ -405,7 +580,7 @@ string_list_t option_info::get_section_name_list() const
 
     string_list_t section_list;
     snapdev::tokenize_string(section_list
-                        , f_name.substr(0, pos)
+                        , f_definition->f_name.substr(0, pos)
                         , "::"
                         , true
                         , std::string()
@@ -430,7 +605,7 @@ string_list_t option_info::get_section_name_list() const
 bool option_info::is_default_option() const
 {
     return has_flag(GETOPT_FLAG_DEFAULT_OPTION)
-        || (f_name.size() == 2 && f_name[0] == '-' && f_name[1] == '-');
+        || (f_definition->f_name.size() == 2 && f_definition->f_name[0] == '-' && f_definition->f_name[1] == '-');
 }
 
 
@@ -450,7 +625,7 @@ bool option_info::is_default_option() const
  */
 void option_info::set_environment_variable_name(std::string const & name)
 {
-    f_environment_variable_name = name;
+    edit_definition().f_environment_variable_name = name;
 }
 
 
@@ -492,7 +667,7 @@ void option_info::set_environment_variable_name(char const * name)
  */
 std::string option_info::get_environment_variable_name() const
 {
-    return f_environment_variable_name;
+    return f_definition->f_environment_variable_name;
 }
 
 
@@ -518,12 +693,12 @@ bool option_info::get_environment_variable_value(
     //
     value.clear();
 
-    if(f_environment_variable_name.empty())
+    if(f_definition->f_environment_variable_name.empty())
     {
         return false;
     }
 
-    std::string name(f_environment_variable_name);
+    std::string name(f_definition->f_environment_variable_name);
     if(intro != nullptr)
     {
         name = intro + name;
@@ -563,7 +738,12 @@ bool option_info::get_environment_variable_value(
  */
 void option_info::set_flags(flag_t flags)
 {
-    f_flags = flags;
+    if(f_definition->f_flags == flags)
+    {
+        return;
+    }
+
+    edit_definition().f_flags = flags;
 }
 
 
@@ -578,7 +758,7 @@ void option_info::set_flags(flag_t flags)
  */
 void option_info::add_flag(flag_t flag)
 {
-    set_flags(f_flags | flag);
+    set_flags(f_definition->f_flags | flag);
 }
 
 
@@ -593,7 +773,7 @@ void option_info::add_flag(flag_t flag)
  */
 void option_info::remove_flag(flag_t flag)
 {
-    set_flags(f_flags & ~flag);
+    set_flags(f_definition->f_flags & ~flag);
 }
 
 
@@ -608,7 +788,7 @@ void option_info::remove_flag(flag_t flag)
  */
 flag_t option_info::get_flags() const
 {
-    return f_flags;
+    return f_definition->f_flags;
 }
 
 
@@ -624,7 +804,7 @@ flag_t option_info::get_flags() const
  */
 bool option_info::has_flag(flag_t flag) const
 {
-    return (f_flags & flag) != 0;
+    return (f_definition->f_flags & flag) != 0;
 }
 
 
@@ -673,7 +853,7 @@ bool option_info::has_default() const
  */
 void option_info::set_default(std::string const & default_value)
 {
-    f_default_value = default_value;
+    edit_definition().f_default_value = default_value;
     add_flag(GETOPT_FLAG_HAS_DEFAULT);
 }
 
@@ -709,20 +889,22 @@ void option_info::set_default(char const * default_value)
  */
 void option_info::remove_default()
 {
-    f_default_value.clear();
+    edit_definition().f_default_value.clear();
     remove_flag(GETOPT_FLAG_HAS_DEFAULT);
 }
 
 
 /** \brief Retrieve the default value.
  *
- * This function returns the default value.
+ * This function returns a copy of the default value. The setters may
+ * replace the definition (see edit_definition()) so a reference could
+ * become invalid.
  *
  * \return The default string value.
  */
-std::string const & option_info::get_default() const
+std::string option_info::get_default() const
 {
-    return f_default_value;
+    return f_definition->f_default_value;
 }
 
 
@@ -763,7 +945,7 @@ std::string const & option_info::get_default() const
  */
 void option_info::set_help(std::string const & help)
 {
-    f_help = help;
+    edit_definition().f_help = help;
 }
 
 
@@ -791,11 +973,15 @@ void option_info::set_help(char const * help)
  * Note that when a special flag is set, this string may represent something
  * else that a help string.
  *
+ * \note
+ * The string is returned by value since the setters may replace the
+ * definition (see edit_definition()).
+ *
  * \return The help string of this argument.
  */
-std::string const & option_info::get_help() const
+std::string option_info::get_help() const
 {
-    return f_help;
+    return f_definition->f_help;
 }
 
 
@@ -820,6 +1006,9 @@ std::string const & option_info::get_help() const
  * If the input string is empty, the current validator, if one is
  * installed, gets removed.
  *
+ * The validator is obtained with validator::get_shared() so options
+ * using the same specification share the same validator instance.
+ *
  * \note
  * If the option_info already has a set of values, they get validated
  * against the new validator. Any value which does not validate gets
@@ -835,7 +1024,7 @@ std::string const & option_info::get_help() const
  */
 bool option_info::set_validator(std::string const & name_and_params)
 {
-    return set_validator(validator::create(name_and_params));
+    return set_validator(validator::get_shared(name_and_params));
 }
 
 
@@ -864,9 +1053,9 @@ bool option_info::set_validator(std::string const & name_and_params)
  * \return true if the validator was installed and all existing values were
  *         considered valid.
  */
-bool option_info::set_validator(validator::pointer_t validator)
+bool option_info::set_validator(validator::const_pointer_t validator)
 {
-    f_validator = validator;
+    edit_definition().f_validator = validator;
 
     // make sure that all existing values validate against this
     // new validator
@@ -895,7 +1084,7 @@ bool option_info::set_validator(std::nullptr_t null_ptr)
 {
     snapdev::NOT_USED(null_ptr);
 
-    f_validator.reset();
+    edit_definition().f_validator.reset();
 
     return true;
 }
@@ -932,7 +1121,7 @@ bool option_info::validates(int idx)
                     + " (idx >= "                                       // LCOV_EXCL_LINE
                     + std::to_string(f_value.size())                    // LCOV_EXCL_LINE
                     + ") for --"                                        // LCOV_EXCL_LINE
-                    + f_name                                            // LCOV_EXCL_LINE
+                    + f_definition->f_name                              // LCOV_EXCL_LINE
                     + " so you can't get this value.");                 // LCOV_EXCL_LINE
     }
 
@@ -941,9 +1130,10 @@ bool option_info::validates(int idx)
     //   * if the value is empty
     //   * when the value validate against the specified validator
     //
-    if(f_validator == nullptr
+    validation_result result;
+    if(f_definition->f_validator == nullptr
     || f_value[idx].empty()
-    || f_validator->validate(f_value[idx]))
+    || f_definition->f_validator->validate_with_result(f_value[idx], result))
     {
         return true;
     }
@@ -952,14 +1142,15 @@ bool option_info::validates(int idx)
                    << "input \""
                    << f_value[idx]
                    << "\" given to parameter --"
-                   << f_name
+                   << f_definition->f_name
                    << " is not considered valid: "
-                   << f_validator->get_error()
+                   << result.get_message()
                    << cppthread::end;
 
     // get rid of that value since it does not validate
     //
     f_value.erase(f_value.begin() + idx);
+    f_key_index_valid = false;
     if(f_value.empty())
     {
         f_source = option_source_t::SOURCE_UNDEFINED;
@@ -981,14 +1172,17 @@ bool option_info::validates(int idx)
  * the specialized validator of this option. If that returns a null
  * pointer, then the option is not using that type of validator.
  *
+ * The validator may be shared with other options (see
+ * validator::get_shared()) so it can't be modified.
+ *
  * \todo
  * Add a template function that does the cast for the caller.
  *
  * \return A pointer to this option validator.
  */
-validator::pointer_t option_info::get_validator() const
+validator::const_pointer_t option_info::get_validator() const
 {
-    return f_validator;
+    return f_definition->f_validator;
 }
 
 
@@ -1042,15 +1236,14 @@ option_info::pointer_t option_info::get_alias_destination() const
  */
 void option_info::set_multiple_separators(char const * const * separators)
 {
-    f_multiple_separators.clear();
-    if(separators == nullptr)
-    {
-        return;
-    }
-
-    for(; *separators != nullptr; ++separators)
+    definition_t & definition(edit_definition());
+    definition.f_multiple_separators.clear();
+    if(separators != nullptr)
     {
-        f_multiple_separators.push_back(*separators);
+        for(; *separators != nullptr; ++separators)
+        {
+            definition.f_multiple_separators.push_back(*separators);
+        }
     }
 }
 
@@ -1071,13 +1264,13 @@ void option_info::set_multiple_separators(char const * const * separators)
  */
 void option_info::set_multiple_separators(string_list_t const & separators)
 {
-    f_multiple_separators = separators;
+    edit_definition().f_multiple_separators = separators;
 }
 
 
 /** \brief Retrieve the list of separators for this argument.
  *
- * This function returns a reference to the list of separators of this
+ * This function returns a copy of the list of separators of this
  * option. It is expected to be used when a value is found in a
  * configuration file or a command line in an environment variable.
  * Parameters on the command line are already broken down by the
@@ -1090,13 +1283,12 @@ void option_info::set_multiple_separators(string_list_t const & separators)
  * thinking that the `--tags a,b,c,d` should probably work the same way
  * though because otherwise many people will have a surprise.
  *
- * \return A reference to the list of separators used to cut multiple
- *         arguments found in a configuration file or an environment
- *         variable.
+ * \return The list of separators used to cut multiple arguments found
+ *         in a configuration file or an environment variable.
  */
-string_list_t const & option_info::get_multiple_separators() const
+string_list_t option_info::get_multiple_separators() const
 {
-    return f_multiple_separators;
+    return f_definition->f_multiple_separators;
 }
 
 
@@ -1180,13 +1372,20 @@ bool option_info::add_value(
     , string_list_t const & option_keys
     , option_source_t source)
 {
-    return set_value(
-              has_flag(GETOPT_FLAG_MULTIPLE)
+    bool const multiple(has_flag(GETOPT_FLAG_MULTIPLE));
+    if(!assign_value(
+              multiple
                     ? f_value.size()
                     : 0
             , value
             , option_keys
-            , source);
+            , source))
+    {
+        return false;
+    }
+
+    record_layer(source, multiple ? LAYER_APPEND : 0, value, option_keys);
+    return true;
 }
 
 
@@ -1227,6 +1426,35 @@ bool option_info::set_value(
     , std::string const & value
     , string_list_t const & option_keys
     , option_source_t source)
+{
+    if(!assign_value(idx, value, option_keys, source))
+    {
+        return false;
+    }
+
+    record_layer(source, idx, value, option_keys);
+    return true;
+}
+
+
+/** \brief Replace a value without recording it in its layer.
+ *
+ * This function is the implementation of set_value() and add_value().
+ * It verifies that the option accepts the value and then saves it
+ * with store_value(). The caller records the value in its layer.
+ *
+ * \param[in] idx  The position of the value to update.
+ * \param[in] value  The new value.
+ * \param[in] option_keys  An array of keys to prepend to each value.
+ * \param[in] source  Where the value comes from.
+ *
+ * \return true if the value was accepted.
+ */
+bool option_info::assign_value(
+      int idx
+    , std::string const & value
+    , string_list_t const & option_keys
+    , option_source_t source)
 {
     if(source == option_source_t::SOURCE_UNDEFINED)
     {
@@ -1246,7 +1474,7 @@ bool option_info::set_value(
     {
         cppthread::log << cppthread::log_level_t::error
                        << "option \"--"
-                       << f_name
+                       << f_definition->f_name
                        << "\" can't be directly updated."
                        << cppthread::end;
         return false;
@@ -1271,16 +1499,45 @@ bool option_info::set_value(
         {
             throw getopt_logic_error(
                           "option_info::set_value(): single value option \"--"
-                        + f_name
+                        + f_definition->f_name
                         + "\" does not accepts index "
                         + std::to_string(idx)
                         + " which is not 0.");
         }
     }
 
+    return store_value(idx, value, option_keys, source, true);
+}
+
+
+/** \brief Save a value in this option.
+ *
+ * This function saves the value once assign_value() verified that the
+ * option accepts it. When replaying the layers, the values were
+ * already accepted and validated when first set so the function is
+ * called directly with \p validate set to false.
+ *
+ * \param[in] idx  The position of the value to update.
+ * \param[in] value  The new value.
+ * \param[in] option_keys  An array of keys to prepend to each value.
+ * \param[in] source  Where the value comes from.
+ * \param[in] validate  Whether the value needs to be validated.
+ *
+ * \return true if the value was accepted.
+ */
+bool option_info::store_value(
+      int idx
+    , std::string const & value
+    , string_list_t const & option_keys
+    , option_source_t source
+    , bool validate)
+{
+    bool const multiple(has_flag(GETOPT_FLAG_MULTIPLE));
+
     f_source = source;
     f_integer.clear();
     f_double.clear();
+    f_address.reset();
 
     bool r(true);
     if(option_keys.empty())
@@ -1303,8 +1560,9 @@ bool option_info::set_value(
             }
             f_value[idx] = value;
         }
+        f_key_index_valid = false;
 
-        if(validates(idx))
+        if(!validate || validates(idx))
         {
             value_changed(idx);
         }
@@ -1320,11 +1578,19 @@ bool option_info::set_value(
         for(auto const & k : option_keys)
         {
             bool new_value(true);
-            std::string const v(k + value);
-            idx = append ? -1 : find_value_index_by_key(k);
+            std::string const v(keyed_value(k, value));
+            idx = append ? -1 : find_key_index(k);
             if(idx == -1)
             {
+                idx = f_value.size();
                 f_value.push_back(v);
+                if(f_key_index_valid)
+                {
+                    // keep the index in sync; emplace() does not replace
+                    // the first value with that key when appending
+                    //
+                    f_key_index.emplace(v.substr(0, v.find(':')), idx);
+                }
                 changed = true;
             }
             else
@@ -1341,7 +1607,7 @@ bool option_info::set_value(
             }
             if(new_value)
             {
-                if(validates(idx))
+                if(!validate || validates(idx))
                 {
                     value_changed(idx);
                 }
@@ -1413,7 +1679,7 @@ bool option_info::set_multiple_values(
     {
         throw getopt_logic_error(
                  "option_info::set_multiple_value(): parameter --"
-               + f_name
+               + f_definition->f_name
                + " does not support array keys.");
     }
 
@@ -1426,14 +1692,14 @@ bool option_info::set_multiple_values(
     }
 
     string_list_t result;
-    split_string(unquote(value, "[]"), result, f_multiple_separators);
+    split_string(unquote(value, "[]"), result, f_definition->f_multiple_separators);
 
     if(!has_flag(GETOPT_FLAG_MULTIPLE)
     && result.size() > 1)
     {
         throw getopt_logic_error(
                  "option_info::set_multiple_value(): parameter --"
-               + f_name
+               + f_definition->f_name
                + " expects zero or one parameter. The set_multiple_value() function should not be called with parameters that only accept one value.");
     }
 
@@ -1444,9 +1710,7 @@ bool option_info::set_multiple_values(
         {
             for(auto & r : result)
             {
-                // note: the keys are expected to already include the ending ':'
-                //
-                keyed_result.push_back(k + r);
+                keyed_result.push_back(keyed_value(k, r));
             }
         }
         result.swap(keyed_result);
@@ -1456,8 +1720,11 @@ bool option_info::set_multiple_values(
     f_value.swap(result);
     f_integer.clear();
     f_double.clear();
+    f_address.reset();
+    f_key_index_valid = false;
 
     bool const r(validate_all_values());
+    record_layer(source, f_value);
 
     if(f_value != result)
     {
@@ -1489,26 +1756,63 @@ bool option_info::set_multiple_values(
  * option was used without a value, which is useful for some
  * options.
  *
+ * The values are checked with validator::validate_batch() so validators
+ * with many values (i.e. a list of integers) are checked faster.
+ *
  * \return true if all the values were considered valid.
  */
 bool option_info::validate_all_values()
 {
+    validator::index_list_t invalid;
+    if(f_definition->f_validator == nullptr
+    || f_definition->f_validator->validate_batch(f_value, invalid))
+    {
+        return true;
+    }
+
+    // the batch does not give us the error messages, so run the
+    // validator again on each invalid value (which is expected to be
+    // rare) and then remove all of those values in one pass
+    //
     bool all_valid(true);
-    if(f_validator != nullptr)
+    std::size_t keep(0);
+    auto it(invalid.begin());
+    for(std::size_t idx(0); idx < f_value.size(); ++idx)
     {
-        for(size_t idx(0); idx < f_value.size(); )
+        if(it != invalid.end()
+        && *it == idx)
         {
-            if(!validates(idx))
+            ++it;
+            validation_result result;
+            if(!f_value[idx].empty()
+            && !f_definition->f_validator->validate_with_result(f_value[idx], result))
             {
-                // the value was removed, so do not increment `idx`
-                //
+                cppthread::log << cppthread::log_level_t::error
+                               << "input \""
+                               << f_value[idx]
+                               << "\" given to parameter --"
+                               << f_definition->f_name
+                               << " is not considered valid: "
+                               << result.get_message()
+                               << cppthread::end;
                 all_valid = false;
-            }
-            else
-            {
-                ++idx;
+                continue;
             }
         }
+        if(keep != idx)
+        {
+            f_value[keep] = std::move(f_value[idx]);
+        }
+        ++keep;
+    }
+    f_value.resize(keep);
+    if(!all_valid)
+    {
+        f_key_index_valid = false;
+    }
+    if(f_value.empty())
+    {
+        f_source = option_source_t::SOURCE_UNDEFINED;
     }
 
     return all_valid;
@@ -1594,24 +1898,113 @@ void option_info::set_trace_sources(bool trace)
  * sources such as the command line, environment variable, direct,
  * dynamic, configuration files.
  *
+ * The trace is saved in compact records (see trace_records()). This
+ * function converts the records which were not yet converted to
+ * strings.
+ *
  * \return An array of strings representing the source of each value
  * in the order they were set in this option_info.
  */
 string_list_t const & option_info::trace_sources() const
 {
+    cppthread::guard lock(get_global_mutex());
+
+    for(std::size_t idx(f_trace_sources.size()); idx < f_trace_records.size(); ++idx)
+    {
+        f_trace_sources.push_back(format_trace(f_trace_records[idx]));
+    }
+
     return f_trace_sources;
 }
 
 
+/** \brief Get the raw trace records of this option.
+ *
+ * This function returns the records saved each time a value of this
+ * option changed while tracing was turned on. Contrary to the
+ * trace_sources() function, this gives you access to the configuration
+ * file line number.
+ *
+ * The filename is an identifier which can be converted back to a string
+ * with the get_trace_filename() function.
+ *
+ * \return The vector of trace records.
+ */
+option_info::trace_record_vector_t const & option_info::trace_records() const
+{
+    return f_trace_records;
+}
+
+
+/** \brief Convert a trace filename identifier back to a filename.
+ *
+ * The trace records use an identifier for the filenames so the same
+ * string does not get duplicated in each record.
+ *
+ * \param[in] id  The identifier of the filename as found in a trace record.
+ *
+ * \return The filename or an empty string if \p id is not known.
+ */
+std::string option_info::get_trace_filename(std::uint32_t id)
+{
+    cppthread::guard lock(get_global_mutex());
+
+    if(id >= g_trace_filenames.size())
+    {
+        return std::string();
+    }
+    return g_trace_filenames[id];
+}
+
+
 /** \brief Save the filename of the current configuration file.
  *
  * While parsing a configuration file, this function gets called to
  * set the name which is used to generate the trace of the source
  * of all the configuration data.
+ *
+ * The filename is saved once in a table and the trace records only
+ * keep its identifier. Calling this function also resets the line
+ * number to 0.
+ *
+ * \param[in] filename  The name of the configuration file being parsed
+ * or an empty string once done.
  */
 void option_info::set_configuration_filename(std::string const & filename)
 {
-    g_configuration_filename = filename;
+    g_configuration_context.f_line = 0;
+    if(filename.empty())
+    {
+        g_configuration_context.f_filename = 0;
+        return;
+    }
+
+    cppthread::guard lock(get_global_mutex());
+
+    auto const it(g_trace_filename_ids.find(filename));
+    if(it != g_trace_filename_ids.end())
+    {
+        g_configuration_context.f_filename = it->second;
+        return;
+    }
+
+    std::uint32_t const id(g_trace_filenames.size());
+    g_trace_filenames.push_back(filename);
+    g_trace_filename_ids[filename] = id;
+    g_configuration_context.f_filename = id;
+}
+
+
+/** \brief Save the line of the current configuration parameter.
+ *
+ * While parsing a configuration file, this function gets called with
+ * the line on which the parameter being added was found.
+ *
+ * \param[in] line  The line number of the parameter.
+ */
+void option_info::set_configuration_line(int line)
+{
+    g_configuration_context.f_line = line < 0 ? 0 : line;
 }
 
 
@@ -1670,7 +2063,7 @@ std::string option_info::get_value(int idx, bool raw) const
                     + " (idx >= "
                     + std::to_string(f_value.size())
                     + ") for --"
-                    + f_name
+                    + f_definition->f_name
                     + " so you can't get this value.");
     }
 
@@ -1687,11 +2080,77 @@ std::string option_info::get_value(int idx, bool raw) const
 }
 
 
+/** \brief Try to retrieve the value.
+ *
+ * This function is similar to get_value() except that it returns
+ * std::nullopt instead of throwing when \p idx is out of bounds.
+ *
+ * The function returns a copy of the value. It is only necessary
+ * when the variables have to be processed. Otherwise, prefer
+ * try_get_raw_value() which does not allocate anything.
+ *
+ * \param[in] idx  The index of the parameter to retrieve.
+ * \param[in] raw  Whether to allow the variable processing or not.
+ *
+ * \return The value at \p idx or std::nullopt.
+ */
+std::optional<std::string> option_info::try_get_value(int idx, bool raw) const
+{
+    std::optional<std::string_view> const value(try_get_raw_value(idx));
+    if(!value.has_value())
+    {
+        return std::nullopt;
+    }
+
+    if(!raw
+    && f_variables != nullptr
+    && has_flag(GETOPT_FLAG_PROCESS_VARIABLES))
+    {
+        return f_variables->process_value(f_value[idx]);
+    }
+
+    return std::string(*value);
+}
+
+
+/** \brief Get a view of the raw value.
+ *
+ * This function returns a view of the value as it was saved in the
+ * option, without variable processing and without any copy. If \p idx
+ * is out of bounds, the function returns std::nullopt.
+ *
+ * This is the accessor to use in code that reads a value often. It does
+ * not throw, does not lock and does not allocate. The other try_get_...()
+ * functions are built on top of it.
+ *
+ * \warning
+ * The view points to the internal buffer of the option. It becomes
+ * invalid as soon as the value is modified (set_value(), add_value(),
+ * reset(), etc.) If you need to keep the value, make a copy.
+ *
+ * \param[in] idx  The index of the parameter to retrieve.
+ *
+ * \return A view of the raw value at \p idx or std::nullopt.
+ */
+std::optional<std::string_view> option_info::try_get_raw_value(int idx) const
+{
+    if(static_cast<size_t>(idx) >= f_value.size())
+    {
+        return std::nullopt;
+    }
+
+    return std::string_view(f_value[idx]);
+}
+
+
 /** \brief Get the index at which a value with the given key is defined.
  *
  * This function searches a value with the specified \p key and return
  * the index where it was found.
  *
+ * The values of an option supporting keys (GETOPT_FLAG_ARRAY) are saved
+ * as "<key>:<value>". The \p key may or may not include the ending colon.
+ *
  * If the function does not find a value starting with \p key, then it
  * returns -1.
  *
@@ -1700,6 +2159,12 @@ std::string option_info::get_value(int idx, bool raw) const
  * to call the function with \p idx larger or equal to the number of
  * values defined.
  *
+ * \note
+ * The keys are indexed in a hash map the first time this function
+ * gets called so searching a key is O(1) even when the option has
+ * thousands of values. The index is kept up to date by add_value()
+ * and set_value().
+ *
  * \exception getopt_logic_error
  * If the \p idx parameter is negative, this exception is raised.
  *
@@ -1714,7 +2179,7 @@ std::string option_info::get_value(int idx, bool raw) const
  *
  * \return The index at which that value is defined or -1 when not found.
  */
-int option_info::find_value_index_by_key(std::string key, int idx) const
+int option_info::find_value_index_by_key(std::string const & key, int idx) const
 {
     if(idx < 0)
     {
@@ -1724,36 +2189,117 @@ int option_info::find_value_index_by_key(std::string key, int idx) const
     {
         throw getopt_undefined(
                       "option_info::find_value_index_by_key(): --"
-                    + f_name
+                    + f_definition->f_name
                     + " has no values defined.");
     }
 
-    if(key.back() != ':')
-    {
-        key += ':';
-    }
-    int const max(f_value.size());
-    for(; idx < max; ++idx)
-    {
-        if(f_value[idx].rfind(key, 0) == 0)
-        {
-            return idx;
-        }
-    }
-
-    return -1;
+    return find_key_index(key, idx);
 }
 
 
-/** \brief Get the value as a long.
+/** \brief Search the index of a key.
  *
- * This function returns the value converted to a `long`.
+ * This function is the implementation of find_value_index_by_key()
+ * without the parameter checks so it can be used internally on an
+ * option without values.
  *
- * If the value does not represent a valid long value, an error is
- * emitted through the logger.
+ * Keys which themselves include a colon (i.e. "a:b" as in `--opt[a:b]`)
+ * are not indexed since the index uses the string up to the first colon.
+ * Those are searched linearly.
  *
- * The value will be parsed through the variables if defined and this
- * parameter allows it. This means the value may be a variable reference
+ * \param[in] key  The key to search for.
+ * \param[in] idx  Start from this index.
+ *
+ * \return The index at which that value is defined or -1 when not found.
+ */
+int option_info::find_key_index(std::string const & key, int idx) const
+{
+    std::string::size_type const length(
+            !key.empty() && key.back() == ':'
+                ? key.length() - 1
+                : key.length());
+    int const max(f_value.size());
+    auto const search = [&](int start)
+    {
+        for(; start < max; ++start)
+        {
+            std::string const & v(f_value[start]);
+            if(v.length() > length
+            && v[length] == ':'
+            && v.compare(0, length, key, 0, length) == 0)
+            {
+                return start;
+            }
+        }
+        return -1;
+    };
+
+    if(key.find(':') < length)
+    {
+        return search(idx);
+    }
+
+    // the index is mutable and may be built from a const function
+    //
+    cppthread::guard lock(get_global_mutex());
+
+    index_keys();
+    auto const it(length == key.length()
+                    ? f_key_index.find(key)
+                    : f_key_index.find(key.substr(0, length)));
+    if(it == f_key_index.end())
+    {
+        return -1;
+    }
+    if(it->second >= idx)
+    {
+        return it->second;
+    }
+
+    // the same key may appear again in a GETOPT_FLAG_MULTIPLE option
+    //
+    return search(idx);
+}
+
+
+/** \brief Build the index of keys.
+ *
+ * This function builds the hash map used to find the index of a value
+ * by key if it is not already valid. Only the first value with a given
+ * key is indexed.
+ *
+ * The function must be called with the global mutex locked.
+ */
+void option_info::index_keys() const
+{
+    if(f_key_index_valid)
+    {
+        return;
+    }
+
+    f_key_index.clear();
+    int const max(f_value.size());
+    for(int idx(0); idx < max; ++idx)
+    {
+        std::string::size_type const pos(f_value[idx].find(':'));
+        if(pos != std::string::npos)
+        {
+            f_key_index.emplace(f_value[idx].substr(0, pos), idx);
+        }
+    }
+    f_key_index_valid = true;
+}
+
+
+/** \brief Get the value as a long.
+ *
+ * This function returns the value converted to a `long`.
+ *
+ * If the value does not represent a valid long value, an error is
+ * emitted through the logger.
+ *
+ * The value will be parsed through the variables if defined and this
+ * parameter allows it. This means the value may be a variable reference
  * instead of an actually value (i.e. `${one}`)
  *
  * \note
@@ -1779,7 +2325,7 @@ long option_info::get_long(int idx) const
                     + " (idx >= "
                     + std::to_string(f_value.size())
                     + ") for --"
-                    + f_name
+                    + f_definition->f_name
                     + " so you can't get this value.");
     }
 
@@ -1789,34 +2335,108 @@ long option_info::get_long(int idx) const
     //
     cppthread::guard lock(get_global_mutex());
 
-    if(f_integer.size() != f_value.size())
+    std::size_t invalid(0);
+    if(!convert_integers(invalid))
     {
-        // we did not yet convert to integers do that now
-        //
-        size_t const max(f_value.size());
-        for(size_t i(f_integer.size()); i < max; ++i)
-        {
-            std::int64_t v;
-            if(!validator_integer::convert_string(get_value(i), v))
-            {
-                f_integer.clear();
+        cppthread::log << cppthread::log_level_t::error
+                       << "invalid number ("
+                       << f_value[invalid]
+                       << ") in parameter --"
+                       << f_definition->f_name
+                       << " at offset "
+                       << invalid
+                       << "."
+                       << cppthread::end;
+        return -1;
+    }
 
-                cppthread::log << cppthread::log_level_t::error
-                               << "invalid number ("
-                               << f_value[i]
-                               << ") in parameter --"
-                               << f_name
-                               << " at offset "
-                               << i
-                               << "."
-                               << cppthread::end;
-                return -1;
-            }
-            f_integer.push_back(v);
+    return f_integer[idx];
+}
+
+
+/** \brief Try to get the value as a long.
+ *
+ * This function is similar to get_long() except that it never throws
+ * and never logs an error. If \p idx is out of bounds or the value is
+ * not a valid integer, then the function returns std::nullopt.
+ *
+ * This is useful in code that polls an option often and does not want
+ * to first call is_defined() and size().
+ *
+ * Contrary to get_long(), this function does not use the cache of
+ * converted integers. It converts the value at \p idx only so it does
+ * not need to lock the global mutex. This also means only that one
+ * value has to be a valid integer.
+ *
+ * \param[in] idx  The index of the value to retrieve as a long.
+ *
+ * \return The value at \p idx converted to a long or std::nullopt.
+ */
+std::optional<long> option_info::try_get_long(int idx) const
+{
+    std::optional<std::string_view> const value(try_get_raw_value(idx));
+    if(!value.has_value())
+    {
+        return std::nullopt;
+    }
+
+    std::int64_t v(0);
+    bool const valid(f_variables != nullptr
+                  && has_flag(GETOPT_FLAG_PROCESS_VARIABLES)
+            ? validator_integer::convert_string(f_variables->process_value(f_value[idx]), v)
+            : validator_integer::convert_string(*value, v));
+    if(!valid)
+    {
+        return std::nullopt;
+    }
+
+    return v;
+}
+
+
+/** \brief Convert all the values to integers.
+ *
+ * This function converts the values which were not yet converted to
+ * integers and saves the results in the f_integer cache.
+ *
+ * If a value is not a valid integer, the cache is cleared, \p invalid
+ * is set to the index of that value and the function returns false.
+ *
+ * The function must be called with the global mutex locked.
+ *
+ * \param[out] invalid  The index of the first invalid value.
+ *
+ * \return true if all the values are valid integers.
+ */
+bool option_info::convert_integers(std::size_t & invalid) const
+{
+    if(f_integer.size() == f_value.size())
+    {
+        return true;
+    }
+
+    // avoid the copy made by get_value() when no variables are
+    // involved
+    //
+    bool const process_variables(f_variables != nullptr
+                              && has_flag(GETOPT_FLAG_PROCESS_VARIABLES));
+    size_t const max(f_value.size());
+    for(size_t i(f_integer.size()); i < max; ++i)
+    {
+        std::int64_t v;
+        bool const valid(process_variables
+                ? validator_integer::convert_string(get_value(i), v)
+                : validator_integer::convert_string(f_value[i], v));
+        if(!valid)
+        {
+            f_integer.clear();
+            invalid = i;
+            return false;
         }
+        f_integer.push_back(v);
     }
 
-    return f_integer[idx];
+    return true;
 }
 
 
@@ -1854,44 +2474,194 @@ double option_info::get_double(int idx) const
                     + " (idx >= "
                     + std::to_string(f_value.size())
                     + ") for --"
-                    + f_name
+                    + f_definition->f_name
                     + " so you can't get this value.");
     }
 
-    // since we may change the f_integer vector between threads,
+    // since we may change the f_double vector between threads,
     // add protection (i.e. most everything else is created at the
     // beginning so in the main thread)
     //
     cppthread::guard lock(get_global_mutex());
 
-    if(f_double.size() != f_value.size())
+    std::size_t invalid(0);
+    if(!convert_doubles(invalid))
     {
-        // we did not yet convert to doubles do that now
-        //
+        cppthread::log << cppthread::log_level_t::error
+                       << "invalid number ("
+                       << f_value[invalid]
+                       << ") in parameter --"
+                       << f_definition->f_name
+                       << " at offset "
+                       << invalid
+                       << "."
+                       << cppthread::end;
+        return -1;
+    }
+
+    return f_double[idx];
+}
+
+
+/** \brief Try to get the value as a double.
+ *
+ * This function is similar to get_double() except that it never throws
+ * and never logs an error. If \p idx is out of bounds or the value is
+ * not a valid number, then the function returns std::nullopt.
+ *
+ * As with try_get_long(), only the value at \p idx gets converted and
+ * the global mutex is not locked.
+ *
+ * \param[in] idx  The index of the value to retrieve as a double.
+ *
+ * \return The value at \p idx converted to a double or std::nullopt.
+ */
+std::optional<double> option_info::try_get_double(int idx) const
+{
+    std::optional<std::string_view> const value(try_get_raw_value(idx));
+    if(!value.has_value())
+    {
+        return std::nullopt;
+    }
+
+    double v(0.0);
+    bool const valid(f_variables != nullptr
+                  && has_flag(GETOPT_FLAG_PROCESS_VARIABLES)
+            ? validator_double::convert_string(f_variables->process_value(f_value[idx]), v)
+            : validator_double::convert_string(*value, v));
+    if(!valid)
+    {
+        return std::nullopt;
+    }
+
+    return v;
+}
+
+
+/** \brief Convert all the values to doubles.
+ *
+ * This function converts the values which were not yet converted to
+ * doubles and saves the results in the f_double cache.
+ *
+ * If a value is not a valid number, the cache is cleared, \p invalid
+ * is set to the index of that value and the function returns false.
+ *
+ * The function must be called with the global mutex locked.
+ *
+ * \param[out] invalid  The index of the first invalid value.
+ *
+ * \return true if all the values are valid numbers.
+ */
+bool option_info::convert_doubles(std::size_t & invalid) const
+{
+    if(f_double.size() == f_value.size())
+    {
+        return true;
+    }
+
+    // avoid the copy made by get_value() when no variables are
+    // involved
+    //
+    bool const process_variables(f_variables != nullptr
+                              && has_flag(GETOPT_FLAG_PROCESS_VARIABLES));
+    size_t const max(f_value.size());
+    for(size_t i(f_double.size()); i < max; ++i)
+    {
+        double v;
+        bool const valid(process_variables
+                ? validator_double::convert_string(get_value(i), v)
+                : validator_double::convert_string(f_value[i], v));
+        if(!valid)
+        {
+            f_double.clear();
+            invalid = i;
+            return false;
+        }
+        f_double.push_back(v);
+    }
+
+    return true;
+}
+
+
+/** \brief Get the value as a network address.
+ *
+ * This function returns the value converted to a binary address as
+ * defined by the address validator. This is useful for options such
+ * as `--listen` or `--allow` which are used in hot paths: the string
+ * gets parsed once and the binary form is cached.
+ *
+ * If the value does not represent a valid address, an error is
+ * emitted through the logger.
+ *
+ * \note
+ * The function will transform all the values in case this is a
+ * GETOPT_FLAG_MULTIPLE option and cache the results.
+ * Calling the function many times with the same index is very fast
+ * after the first time.
+ *
+ * \exception getopt_exception_undefined
+ * If the value was not defined, the function raises this exception.
+ *
+ * \param[in] idx  The index of the value to retrieve as an address.
+ *
+ * \return The value at \p idx converted to an address or a default
+ * address (`::`) on error.
+ */
+network_address_t option_info::get_address(int idx) const
+{
+    if(static_cast<size_t>(idx) >= f_value.size())
+    {
+        throw getopt_undefined(
+                      "option_info::get_address(): no value at index "
+                    + std::to_string(idx)
+                    + " (idx >= "
+                    + std::to_string(f_value.size())
+                    + ") for --"
+                    + f_definition->f_name
+                    + " so you can't get this value.");
+    }
+
+    cppthread::guard lock(get_global_mutex());
+
+    // the header only has a forward declaration of network_address_t
+    // so the cache is allocated here
+    //
+    if(f_address == nullptr)
+    {
+        f_address = std::make_shared<std::vector<network_address_t>>();
+    }
+    if(f_address->size() != f_value.size())
+    {
+        bool const process_variables(f_variables != nullptr
+                                  && has_flag(GETOPT_FLAG_PROCESS_VARIABLES));
         size_t const max(f_value.size());
-        for(size_t i(f_double.size()); i < max; ++i)
+        for(size_t i(f_address->size()); i < max; ++i)
         {
-            double v;
-            if(!validator_double::convert_string(get_value(i), v))
+            network_address_t v;
+            bool const valid(process_variables
+                    ? validator_address::convert_string(get_value(i), v)
+                    : validator_address::convert_string(f_value[i], v));
+            if(!valid)
             {
-                f_double.clear();
+                f_address.reset();
 
                 cppthread::log << cppthread::log_level_t::error
-                               << "invalid number ("
+                               << "invalid address ("
                                << f_value[i]
                                << ") in parameter --"
-                               << f_name
+                               << f_definition->f_name
                                << " at offset "
                                << i
                                << "."
                                << cppthread::end;
-                return -1;
+                return network_address_t();
             }
-            f_double.push_back(v);
+            f_address->push_back(v);
         }
     }
 
-    return f_double[idx];
+    return (*f_address)[idx];
 }
 
 
@@ -1958,110 +2728,1072 @@ void option_info::unlock()
  * To reuse the same getopt object multiple times, you can use the
  * reset() function which clears the values. Then you can parse a
  * new set of argc/argv parameters.
+ *
+ * All the layers are forgotten (see rewind_layer()).
  */
 void option_info::reset()
 {
+    for(auto & l : f_layers)
+    {
+        l.f_entries.clear();
+        l.f_indexed.clear();
+    }
+    reset(option_source_t::SOURCE_UNDEFINED);
+}
+
+
+/** \brief Reset this value from a specific source.
+ *
+ * This function clears the value like reset() does. The reset is also
+ * recorded in the layer of \p source (i.e. `--verbose=false` on the
+ * command line) so it gets applied again if a lower layer is replaced
+ * (see rewind_layer()).
+ *
+ * With SOURCE_UNDEFINED, the layers are left alone.
+ *
+ * \param[in] source  The source requesting the reset.
+ */
+void option_info::reset(option_source_t source)
+{
+    if(source != option_source_t::SOURCE_UNDEFINED)
+    {
+        record_layer(source, string_list_t());
+    }
+
     if(is_defined())
     {
         f_source = option_source_t::SOURCE_UNDEFINED;
         f_value.clear();
         f_integer.clear();
         f_double.clear();
+        f_address.reset();
+        f_key_index_valid = false;
 
         value_changed(0);
     }
 }
 
 
-/** \brief Add a callback to call on a change to this value.
+/** \brief Retrieve the generation of this option.
  *
- * Since we now officially support dynamically setting option values, we
- * decided to add a callback mechanism that lets you know that an option
- * changed. That way you can react to the change as soon as possible instead
- * of having to poll for the value once in a while.
+ * Each time the value of this option changes (set_value(), add_value(),
+ * reset(), etc.), the generation gets updated. The generation is 0 until
+ * the first change. After that, it is the global generation (see
+ * get_global_generation()) at the time of the last change so the number
+ * increases monotonically.
  *
- * \param[in] c  The callback. Usually an std::bind() call.
+ * A thread which needs to react to changes can save the generation and
+ * later compare it with the current one. When equal, nothing changed and
+ * the value does not need to be read again:
  *
- * \return The new callback identifier.
+ * \code
+ *     option_info::generation_t const g(opt->get_generation());
+ *     if(g != f_last_generation)
+ *     {
+ *         f_last_generation = g;
+ *         f_timeout = opt->get_long();
+ *     }
+ * \endcode
+ *
+ * Contrary to a callback, this does not run anything in the thread
+ * making the change.
+ *
+ * \return The generation of the last change to this option.
  */
-option_info::callback_id_t option_info::add_callback(callback_t const & c)
+option_info::generation_t option_info::get_generation() const
 {
-    cppthread::guard lock(get_global_mutex());
-
-    ++f_next_callback_id;
-    f_callbacks.emplace_back(f_next_callback_id, c);
-    return f_next_callback_id;
+    return f_generation.load(std::memory_order_acquire);
 }
 
 
-/** \brief Remove a callback.
+/** \brief Get an immutable snapshot of the values.
  *
- * This function is the opposite of the add_callback(). It removes a callback
- * that you previously added. This is useful if you are interested in hearing
- * about the value when set but are not interested at all about future
- * changes.
+ * The set_value(), add_value(), reset(), etc. functions modify the
+ * values in place. A thread reading the values while another thread
+ * updates them would race. The snapshot offers a safe way to read the
+ * values from any thread. Reading the current snapshot does not lock
+ * any mutex, the pointer is loaded atomically (the snapshots are
+ * published RCU style).
  *
- * \param[in] id  The id returned by the add_callback() function.
+ * The snapshot includes the source, the generation, the values (with
+ * the variables processed if this option supports variables) and the
+ * values converted to integers and doubles. When a value is not a
+ * valid number, the corresponding std::optional is not set.
+ *
+ * Options which have the GETOPT_FLAG_DYNAMIC_CONFIGURATION flag set
+ * publish a new snapshot each time their value changes. The old
+ * snapshot is released by the last thread holding a pointer to it,
+ * so a reader can keep using its snapshot as long as necessary.
+ *
+ * When no snapshot exists yet (i.e. the values were set before the
+ * GETOPT_FLAG_DYNAMIC_CONFIGURATION flag was added) or the option
+ * is not dynamic and its values changed since the last snapshot was
+ * created, a new snapshot is created from the current values. Options
+ * which are not dynamic are not expected to change once the parsing
+ * is done so that is safe.
+ *
+ * \code
+ *     option_info::value_snapshot_pointer_t const values(opt->get_snapshot());
+ *     if(!values->f_integer.empty()
+ *     && values->f_integer[0].has_value())
+ *     {
+ *         f_timeout = *values->f_integer[0];
+ *     }
+ * \endcode
+ *
+ * \return A pointer to the current snapshot of the values, never nullptr.
  */
-void option_info::remove_callback(callback_id_t id)
+option_info::value_snapshot_pointer_t option_info::get_snapshot() const
 {
-    cppthread::guard lock(get_global_mutex());
-
-    auto it(std::find_if(
-              f_callbacks.begin()
-            , f_callbacks.end()
-            , [id](auto e)
-            {
-                return e.f_id == id;
-            }));
-    if(it != f_callbacks.end())
+    // publish() saves the snapshot before the generation so a snapshot
+    // at least as recent as the generation we load here is current
+    //
+    generation_t const generation(f_generation.load(std::memory_order_acquire));
+    value_snapshot_pointer_t const current(load_snapshot(f_snapshot));
+    if(current != nullptr
+    && current->f_generation >= generation)
     {
-        f_callbacks.erase(it);
+        return current;
     }
+
+    std::shared_ptr<value_snapshot_t> snapshot(create_snapshot(f_value, f_source, current));
+    snapshot->f_generation = generation;
+
+    // if another thread replaced the snapshot in the meantime, keep
+    // that one; ours is still valid for this call
+    //
+    exchange_snapshot(f_snapshot, current, snapshot);
+
+    return snapshot;
 }
 
 
-/** \brief Call whenever the value changed so we can handle callbacks.
+/** \brief Create a snapshot of a set of values.
  *
- * This function is called on a change of the internal values.
+ * This function creates a new snapshot of the specified values as
+ * returned by get_snapshot(). The caller is expected to set the
+ * generation before publishing the snapshot.
  *
- * The function is used to call the callbacks that were added to this
- * option_info object. The function first copies the existing list of
- * callbacks so you can safely update the list from within a callback.
+ * Converting the values to integers and doubles is costly. A value
+ * which did not change since the \p previous snapshot reuses the
+ * conversions of that snapshot so adding one value to a long list
+ * only converts the new value.
  *
- * \warning
- * Destroying your advgetopt::getopt option is not safe while a callback
- * is running.
+ * This function does not lock any mutex.
  *
- * \param[in] idx  This represents the index of the value that last changed
- * (currently poor attempt to fix this issue).
+ * \param[in] values  The values to save in the snapshot.
+ * \param[in] source  The source of the values.
+ * \param[in] previous  The previous snapshot or nullptr.
+ *
+ * \return The new snapshot.
  */
-void option_info::value_changed(int idx)
+std::shared_ptr<option_info::value_snapshot_t> option_info::create_snapshot(
+          string_list_t const & values
+        , option_source_t source
+        , value_snapshot_pointer_t const & previous) const
 {
-    trace_source(idx);
+    std::shared_ptr<value_snapshot_t> snapshot(std::make_shared<value_snapshot_t>());
+    snapshot->f_source = source;
+
+    bool const process_variables(f_variables != nullptr
+                              && has_flag(GETOPT_FLAG_PROCESS_VARIABLES));
+    std::size_t const max(values.size());
+    snapshot->f_value.reserve(max);
+    snapshot->f_integer.reserve(max);
+    snapshot->f_double.reserve(max);
+    for(std::size_t idx(0); idx < max; ++idx)
+    {
+        snapshot->f_value.push_back(process_variables
+                    ? f_variables->process_value(values[idx])
+                    : values[idx]);
 
-    callback_vector_t callbacks;
-    callbacks.reserve(f_callbacks.size());
+        if(previous != nullptr
+        && idx < previous->f_value.size()
+        && previous->f_value[idx] == snapshot->f_value.back())
+        {
+            snapshot->f_integer.push_back(previous->f_integer[idx]);
+            snapshot->f_double.push_back(previous->f_double[idx]);
+            continue;
+        }
 
-    {
+        std::int64_t integer(0);
+        snapshot->f_integer.push_back(
+                    validator_integer::convert_string(snapshot->f_value.back(), integer)
+                        ? std::optional<std::int64_t>(integer)
+                        : std::nullopt);
+
+        double number(0.0);
+        snapshot->f_double.push_back(
+                    validator_double::convert_string(snapshot->f_value.back(), number)
+                        ? std::optional<double>(number)
+                        : std::nullopt);
+    }
+
+    return snapshot;
+}
+
+
+/** \brief Retrieve the global generation.
+ *
+ * This counter is incremented each time any option changes. It can be
+ * used to quickly detect that nothing changed at all before checking
+ * the generation of each option of interest.
+ *
+ * \note
+ * The counter is shared by all the options of the process, including
+ * options of different getopt objects.
+ *
+ * \return The global generation.
+ */
+option_info::generation_t option_info::get_global_generation()
+{
+    return g_generation.load(std::memory_order_acquire);
+}
+
+
+/** \brief Add a callback to call on a change to this value.
+ *
+ * Since we now officially support dynamically setting option values, we
+ * decided to add a callback mechanism that lets you know that an option
+ * changed. That way you can react to the change as soon as possible instead
+ * of having to poll for the value once in a while.
+ *
+ * The list of callbacks is never modified in place. This function creates
+ * a new list and replaces the old one while holding the global mutex.
+ * That way value_changed() only needs the mutex to get a reference to
+ * the current list and it can go through the list without a lock and
+ * without making a copy.
+ *
+ * \param[in] c  The callback. Usually an std::bind() call.
+ *
+ * \return The new callback identifier.
+ */
+option_info::callback_id_t option_info::add_callback(callback_t const & c)
+{
+    cppthread::guard lock(get_global_mutex());
+
+    std::shared_ptr<callback_vector_t> callbacks(f_callbacks == nullptr
+            ? std::make_shared<callback_vector_t>()
+            : std::make_shared<callback_vector_t>(*f_callbacks));
+
+    ++f_next_callback_id;
+    callbacks->emplace_back(f_next_callback_id, c);
+    f_callbacks = callbacks;
+
+    return f_next_callback_id;
+}
+
+
+/** \brief Remove a callback.
+ *
+ * This function is the opposite of the add_callback(). It removes a callback
+ * that you previously added. This is useful if you are interested in hearing
+ * about the value when set but are not interested at all about future
+ * changes.
+ *
+ * A callback currently running (i.e. in another thread) uses the previous
+ * list so it may still be called once after this function returns.
+ *
+ * \param[in] id  The id returned by the add_callback() function.
+ */
+void option_info::remove_callback(callback_id_t id)
+{
+    cppthread::guard lock(get_global_mutex());
+
+    callback_list_t const current(f_callbacks);
+    if(current == nullptr)
+    {
+        return;
+    }
+
+    auto it(std::find_if(
+              current->begin()
+            , current->end()
+            , [id](auto const & e)
+            {
+                return e.f_id == id;
+            }));
+    if(it != current->end())
+    {
+        std::shared_ptr<callback_vector_t> callbacks(std::make_shared<callback_vector_t>(*current));
+        callbacks->erase(callbacks->begin() + (it - current->begin()));
+        f_callbacks = callbacks->empty()
+                    ? callback_list_t()
+                    : callback_list_t(callbacks);
+    }
+}
+
+
+/** \brief Call whenever the value changed so we can handle callbacks.
+ *
+ * This function is called on a change of the internal values.
+ *
+ * The function is used to call the callbacks that were added to this
+ * option_info object. The list of callbacks is immutable so the function
+ * only needs to hold a reference to the current list. The global mutex
+ * is held just long enough to get that reference. You can safely
+ * update the list from within a callback, the change will be visible on
+ * the next call.
+ *
+ * \warning
+ * Destroying your advgetopt::getopt option is not safe while a callback
+ * is running.
+ *
+ * \param[in] idx  This represents the index of the value that last changed
+ * (currently poor attempt to fix this issue).
+ */
+void option_info::value_changed(int idx)
+{
+    if(f_replaying)
+    {
+        return;
+    }
+
+    if(f_rewound_priority >= 0)
+    {
+        // forward_layer() reports the change once the layers are all
+        // applied again
+        //
+        trace_source(idx);
+        return;
+    }
+
+    publish(g_generation.fetch_add(1, std::memory_order_acq_rel) + 1);
+
+    trace_source(idx);
+
+    call_callbacks();
+}
+
+
+/** \brief Publish the current values.
+ *
+ * This function publishes the values with the specified generation.
+ * If this option is dynamic, a new snapshot is created and replaces
+ * the current one. Other options only get their generation updated;
+ * get_snapshot() detects that their snapshot is out of date.
+ *
+ * The snapshot is published before the new generation so a reader
+ * which sees the new generation also sees the new snapshot. No mutex
+ * is locked.
+ *
+ * \param[in] generation  The generation of this change.
+ */
+void option_info::publish(generation_t generation)
+{
+    if(has_flag(GETOPT_FLAG_DYNAMIC_CONFIGURATION))
+    {
+        std::shared_ptr<value_snapshot_t> snapshot(create_snapshot(f_value, f_source, load_snapshot(f_snapshot)));
+        snapshot->f_generation = generation;
+        store_snapshot(f_snapshot, snapshot);
+    }
+
+    f_generation.store(generation, std::memory_order_release);
+}
+
+
+/** \brief Publish a snapshot created ahead of time.
+ *
+ * This function is used by apply_batch() and publish_changes() which
+ * create the snapshots first and then publish all of them with the
+ * global mutex locked. That way getopt::get_snapshots() sees all the
+ * changes of a batch or none of them.
+ *
+ * \param[in] generation  The generation of this change.
+ * \param[in] snapshot  The new snapshot, nullptr if the option is not
+ * dynamic.
+ */
+void option_info::publish_snapshot(
+      generation_t generation
+    , std::shared_ptr<value_snapshot_t> const & snapshot)
+{
+    if(snapshot != nullptr)
+    {
+        snapshot->f_generation = generation;
+        store_snapshot(f_snapshot, snapshot);
+    }
+
+    f_generation.store(generation, std::memory_order_release);
+}
+
+
+/** \brief Call the callbacks of this option.
+ *
+ * This function calls all the callbacks attached to this option.
+ */
+void option_info::call_callbacks()
+{
+    callback_list_t callbacks;
+    {
         cppthread::guard lock(get_global_mutex());
         callbacks = f_callbacks;
     }
+    if(callbacks == nullptr)
+    {
+        return;
+    }
 
-    for(auto e : callbacks)
+    for(auto const & e : *callbacks)
     {
         e.f_callback(*this);
     }
 }
 
 
+/** \brief Apply a batch of values to a set of options.
+ *
+ * Dynamic settings often come in groups which have to change together
+ * (i.e. an IP address, a port, and a TLS flag). Calling set_value() on
+ * each option makes each change visible separately and calls the
+ * callbacks of each option before the other options were updated.
+ *
+ * This function instead:
+ *
+ * \li validates all the values first; if any one value is not valid,
+ * then nothing changes (the whole batch is rejected) and the function
+ * returns false;
+ * \li creates the new snapshots, then updates all the options and
+ * publishes them at once, with the global mutex locked, and with the
+ * same generation; so getopt::get_snapshots() returns either all the
+ * old or all the new values;
+ * \li calls the callbacks of each option which changed, once, after
+ * all the options were updated.
+ *
+ * Each value replaces all the existing values of its option. For options
+ * with the GETOPT_FLAG_MULTIPLE flag, the value is first split using the
+ * option separators (as with set_multiple_values()).
+ *
+ * A batch is rejected if one of its options is locked or, when \p source
+ * is SOURCE_DIRECT or SOURCE_DYNAMIC, does not have the
+ * GETOPT_FLAG_DYNAMIC_CONFIGURATION flag set. In all cases, an error
+ * is logged.
+ *
+ * \exception getopt_logic_error
+ * The \p source parameter cannot be SOURCE_UNDEFINED and the batch
+ * cannot include a null option.
+ *
+ * \param[in] batch  The list of options and their new value.
+ * \param[out] changed  The options which changed.
+ * \param[in] source  Where the values come from.
+ *
+ * \return true if the batch was applied.
+ */
+bool option_info::apply_batch(
+      value_batch_t const & batch
+    , vector_t & changed
+    , option_source_t source)
+{
+    changed.clear();
+
+    if(source == option_source_t::SOURCE_UNDEFINED)
+    {
+        throw getopt_logic_error(
+                  "option_info::apply_batch(): called with SOURCE_UNDEFINED ("
+                + std::to_string(static_cast<int>(source))
+                + ").");
+    }
+
+    // validate everything first so a failure leaves all the options
+    // untouched
+    //
+    bool valid(true);
+    std::vector<string_list_t> values;
+    values.reserve(batch.size());
+    for(auto const & b : batch)
+    {
+        if(b.first == nullptr)
+        {
+            throw getopt_logic_error("option_info::apply_batch(): the batch cannot include a null option.");
+        }
+        option_info const & opt(*b.first);
+
+        values.emplace_back();
+        if(opt.has_flag(GETOPT_FLAG_MULTIPLE))
+        {
+            split_string(unquote(b.second, "[]"), values.back(), opt.f_definition->f_multiple_separators);
+        }
+        else
+        {
+            values.back().push_back(b.second);
+        }
+
+        if(opt.has_flag(GETOPT_FLAG_LOCK))
+        {
+            cppthread::log << cppthread::log_level_t::error
+                           << "option \"--"
+                           << opt.f_definition->f_name
+                           << "\" is locked."
+                           << cppthread::end;
+            valid = false;
+            continue;
+        }
+
+        if((source == option_source_t::SOURCE_DIRECT
+                || source == option_source_t::SOURCE_DYNAMIC)
+        && !opt.has_flag(GETOPT_FLAG_DYNAMIC_CONFIGURATION))
+        {
+            cppthread::log << cppthread::log_level_t::error
+                           << "option \"--"
+                           << opt.f_definition->f_name
+                           << "\" can't be directly updated."
+                           << cppthread::end;
+            valid = false;
+            continue;
+        }
+
+        if(opt.f_definition->f_validator != nullptr)
+        {
+            for(auto const & v : values.back())
+            {
+                validation_result result;
+                if(!v.empty()
+                && !opt.f_definition->f_validator->validate_with_result(v, result))
+                {
+                    cppthread::log << cppthread::log_level_t::error
+                                   << "input \""
+                                   << v
+                                   << "\" given to parameter --"
+                                   << opt.f_definition->f_name
+                                   << " is not considered valid: "
+                                   << result.get_message()
+                                   << cppthread::end;
+                    valid = false;
+                }
+            }
+        }
+    }
+    if(!valid)
+    {
+        return false;
+    }
+
+    // create the new snapshots before locking the mutex, the conversions
+    // and the variables can be slow; a batch which does not change an
+    // option just drops its snapshot
+    //
+    std::size_t const max(batch.size());
+    std::vector<std::shared_ptr<value_snapshot_t>> snapshots(max);
+    for(std::size_t idx(0); idx < max; ++idx)
+    {
+        option_info const & opt(*batch[idx].first);
+        if(opt.has_flag(GETOPT_FLAG_DYNAMIC_CONFIGURATION))
+        {
+            snapshots[idx] = opt.create_snapshot(
+                      values[idx]
+                    , values[idx].empty()
+                            ? option_source_t::SOURCE_UNDEFINED
+                            : source
+                    , load_snapshot(opt.f_snapshot));
+        }
+    }
+
+    {
+        cppthread::guard lock(get_global_mutex());
+
+        std::vector<std::shared_ptr<value_snapshot_t>> changed_snapshots;
+        for(std::size_t idx(0); idx < max; ++idx)
+        {
+            option_info & opt(*batch[idx].first);
+            opt.record_layer(source, values[idx]);
+            if(opt.f_value == values[idx]
+            && opt.f_source == source)
+            {
+                continue;
+            }
+
+            opt.f_source = values[idx].empty()
+                                ? option_source_t::SOURCE_UNDEFINED
+                                : source;
+            opt.f_value.swap(values[idx]);
+            opt.f_integer.clear();
+            opt.f_double.clear();
+            opt.f_address.reset();
+            opt.f_key_index_valid = false;
+
+            auto it(std::find(changed.begin(), changed.end(), batch[idx].first));
+            if(it == changed.end())
+            {
+                changed.push_back(batch[idx].first);
+                changed_snapshots.push_back(snapshots[idx]);
+            }
+            else
+            {
+                changed_snapshots[it - changed.begin()] = snapshots[idx];
+            }
+        }
+
+        if(changed.empty())
+        {
+            return true;
+        }
+
+        // only the pointers get swapped while the mutex is locked
+        //
+        generation_t const generation(g_generation.fetch_add(1, std::memory_order_acq_rel) + 1);
+        std::size_t const count(changed.size());
+        for(std::size_t idx(0); idx < count; ++idx)
+        {
+            changed[idx]->publish_snapshot(generation, changed_snapshots[idx]);
+            changed[idx]->trace_source(0);
+        }
+    }
+
+    for(auto const & opt : changed)
+    {
+        opt->call_callbacks();
+    }
+
+    return true;
+}
+
+
+/** \brief Publish the changes of a set of options at once.
+ *
+ * This function gives all the options in \p changed the same new
+ * generation and publishes their values, as apply_batch() does. The
+ * snapshots are created first, only the publication happens with the
+ * global mutex locked. Then it calls the callbacks of each option.
+ *
+ * It is used after forward_layer() returned true for a set of options.
+ *
+ * \param[in] changed  The list of options which changed.
+ */
+void option_info::publish_changes(vector_t const & changed)
+{
+    if(changed.empty())
+    {
+        return;
+    }
+
+    std::size_t const max(changed.size());
+    std::vector<std::shared_ptr<value_snapshot_t>> snapshots(max);
+    for(std::size_t idx(0); idx < max; ++idx)
+    {
+        option_info const & opt(*changed[idx]);
+        if(opt.has_flag(GETOPT_FLAG_DYNAMIC_CONFIGURATION))
+        {
+            snapshots[idx] = opt.create_snapshot(opt.f_value, opt.f_source, load_snapshot(opt.f_snapshot));
+        }
+    }
+
+    {
+        cppthread::guard lock(get_global_mutex());
+
+        generation_t const generation(g_generation.fetch_add(1, std::memory_order_acq_rel) + 1);
+        for(std::size_t idx(0); idx < max; ++idx)
+        {
+            changed[idx]->publish_snapshot(generation, snapshots[idx]);
+        }
+    }
+
+    for(auto const & opt : changed)
+    {
+        opt->call_callbacks();
+    }
+}
+
+
+/** \brief Remove one layer of values to replace it.
+ *
+ * Each option remembers the values set by each source (its layers).
+ * The priority of the layers is:
+ *
+ * \li configuration files,
+ * \li the environment variable,
+ * \li the command line,
+ * \li the values set directly or dynamically by the program.
+ *
+ * This function removes the layer of \p source and brings the option
+ * back to the values of the layers with a lower priority. At that
+ * point, the new values of that source can be set as usual (i.e. by
+ * reading the configuration files again). Then call forward_layer() to
+ * apply the layers with a higher priority again. Those are not parsed
+ * again, their values are replayed as they were recorded.
+ *
+ * While rewound, the changes are neither published nor sent to the
+ * callbacks. forward_layer() tells whether the final values changed.
+ *
+ * A locked option is not rewound since its value cannot change. An
+ * option which does not keep its layers (see set_keep_layers()) is not
+ * rewound either.
+ *
+ * \param[in] source  The source of the layer to replace.
+ *
+ * \sa forward_layer()
+ * \sa getopt::reload_configuration_files()
+ */
+void option_info::rewind_layer(option_source_t source)
+{
+    if(f_layers.empty()
+    || has_flag(GETOPT_FLAG_LOCK)
+    || f_rewound_priority >= 0)
+    {
+        return;
+    }
+
+    int const priority(layer_priority(source));
+
+    f_layers[priority].f_entries.clear();
+    f_layers[priority].f_indexed.clear();
+
+    f_rewound_source = f_source;
+    f_rewound_value.clear();
+    f_rewound_value.swap(f_value);
+
+    f_source = option_source_t::SOURCE_UNDEFINED;
+    f_integer.clear();
+    f_double.clear();
+    f_address.reset();
+    f_key_index_valid = false;
+
+    replay_layers(0, priority);
+
+    f_rewound_priority = priority;
+}
+
+
+/** \brief Apply the layers above a rewound layer again.
+ *
+ * After a call to rewind_layer() and setting the new values of that
+ * layer, this function replays the layers with a higher priority.
+ *
+ * The function does not publish the new values. Instead it returns
+ * true if the values changed. The caller is expected to call
+ * publish_changes() with all the options which changed so they are
+ * all published with the same generation.
+ *
+ * \return true if the values or the source of this option changed.
+ *
+ * \sa rewind_layer()
+ */
+bool option_info::forward_layer()
+{
+    if(f_rewound_priority < 0)
+    {
+        return false;
+    }
+
+    replay_layers(f_rewound_priority + 1, std::numeric_limits<int>::max());
+    f_rewound_priority = -1;
+
+    bool const changed(f_value != f_rewound_value
+                    || f_source != f_rewound_source);
+    f_rewound_value.clear();
+
+    return changed;
+}
+
+
+/** \brief Get the priority of a source.
+ *
+ * The layers are applied from the lowest to the highest priority.
+ *
+ * \exception getopt_logic_error
+ * The SOURCE_UNDEFINED source does not have a layer.
+ *
+ * \param[in] source  The source to convert.
+ *
+ * \return The priority of the layer of \p source.
+ */
+int option_info::layer_priority(option_source_t source)
+{
+    switch(source)
+    {
+    case option_source_t::SOURCE_CONFIGURATION:
+        return 0;
+
+    case option_source_t::SOURCE_ENVIRONMENT_VARIABLE:
+        return 1;
+
+    case option_source_t::SOURCE_COMMAND_LINE:
+        return 2;
+
+    case option_source_t::SOURCE_DIRECT:
+    case option_source_t::SOURCE_DYNAMIC:
+        return 3;
+
+    case option_source_t::SOURCE_UNDEFINED:
+        break;
+
+    }
+
+    throw getopt_logic_error("option_info::layer_priority(): SOURCE_UNDEFINED does not have a layer.");
+}
+
+
+/** \brief Keep the values of each source.
+ *
+ * By default, an option only keeps its current values. Call this
+ * function to also keep the values set by each source (its layers) so
+ * one source can later be replaced with rewind_layer() and
+ * forward_layer(). The getopt object does so for all its options when
+ * the GETOPT_ENVIRONMENT_FLAG_RELOAD_CONFIGURATION flag is set (see
+ * getopt::reload_configuration_files()).
+ *
+ * Values already set when the layers get enabled are recorded as if
+ * they were all set at once by their current source.
+ *
+ * Turning the layers off forgets all the layers.
+ *
+ * \param[in] keep  Whether to keep the layers.
+ *
+ * \sa rewind_layer()
+ */
+void option_info::set_keep_layers(bool keep)
+{
+    if(!keep)
+    {
+        f_layers.clear();
+        return;
+    }
+
+    if(!f_layers.empty())
+    {
+        return;
+    }
+
+    f_layers.resize(LAYER_COUNT);
+    if(f_source != option_source_t::SOURCE_UNDEFINED)
+    {
+        record_layer(f_source, f_value);
+    }
+}
+
+
+/** \brief Check whether this option keeps its layers.
+ *
+ * \return true if the values of each source are kept.
+ *
+ * \sa set_keep_layers()
+ */
+bool option_info::get_keep_layers() const
+{
+    return !f_layers.empty();
+}
+
+
+/** \brief Record a change replacing all the values.
+ *
+ * All the previous entries of the layer of \p source are dropped since
+ * they would be overwritten anyway.
+ *
+ * Nothing is recorded unless the layers are kept (see set_keep_layers()).
+ *
+ * \param[in] source  Where the values come from.
+ * \param[in] values  All the values.
+ */
+void option_info::record_layer(
+      option_source_t source
+    , string_list_t const & values)
+{
+    if(f_layers.empty()
+    || f_replaying)
+    {
+        return;
+    }
+
+    layer_t & layer(f_layers[layer_priority(source)]);
+    layer.f_entries.clear();
+    layer.f_indexed.clear();
+    layer.f_entries.push_back(layer_entry_t{source, LAYER_VALUES, values, string_list_t()});
+}
+
+
+/** \brief Record a change in the layer of its source.
+ *
+ * Within one layer, the entries are kept in the order they were set.
+ * They are collapsed so the list does not grow each time a value gets
+ * updated:
+ *
+ * \li setting the only value of an option without keys replaces all
+ * the values so the other entries of that layer get dropped;
+ * \li a change at an explicit index replaces the previous entry of that
+ * layer at the same index with the same keys; these entries are indexed
+ * by index and keys so they are found in O(log n);
+ * \li the values added one after the other are saved in one entry.
+ *
+ * So a layer holds at most one entry per index and set of keys plus
+ * the lists of appended values, which never hold more than the values
+ * that source defined.
+ *
+ * Nothing is recorded unless the layers are kept (see set_keep_layers()).
+ *
+ * \param[in] source  Where the value comes from.
+ * \param[in] idx  The index of the value or LAYER_APPEND.
+ * \param[in] value  The value.
+ * \param[in] option_keys  The keys used with the value.
+ */
+void option_info::record_layer(
+      option_source_t source
+    , int idx
+    , std::string const & value
+    , string_list_t const & option_keys)
+{
+    if(f_layers.empty()
+    || f_replaying)
+    {
+        return;
+    }
+
+    layer_t & layer(f_layers[layer_priority(source)]);
+    if(idx == LAYER_APPEND)
+    {
+        // values appended one after the other go in the same entry
+        // unless another change happened in between
+        //
+        if(!layer.f_entries.empty()
+        && layer.f_entries.back().f_index == LAYER_APPEND
+        && layer.f_entries.back().f_option_keys == option_keys)
+        {
+            layer.f_entries.back().f_source = source;
+            layer.f_entries.back().f_value.push_back(value);
+            return;
+        }
+    }
+    else
+    {
+        if(idx == 0
+        && option_keys.empty()
+        && !has_flag(GETOPT_FLAG_MULTIPLE))
+        {
+            layer.f_entries.clear();
+            layer.f_indexed.clear();
+        }
+
+        // the other changes of this layer do not read the value at
+        // that index so we can replace it where it was first set
+        //
+        auto const existing(layer.f_indexed.find(std::make_pair(idx, option_keys)));
+        if(existing != layer.f_indexed.end())
+        {
+            layer_entry_t & e(layer.f_entries[existing->second]);
+            e.f_source = source;
+            e.f_value[0] = value;
+            return;
+        }
+        layer.f_indexed[std::make_pair(idx, option_keys)] = layer.f_entries.size();
+    }
+
+    layer.f_entries.push_back(layer_entry_t{source, idx, string_list_t{value}, option_keys});
+}
+
+
+/** \brief Apply the recorded layers again.
+ *
+ * This function applies the entries of the layers with a priority
+ * from \p from_priority to \p to_priority (excluded). The entries are
+ * not recorded again and the changes are not published.
+ *
+ * The values were accepted and validated when they were first set so
+ * they are saved directly with store_value(). In particular, the lock
+ * and SOURCE_DIRECT checks are not applied again.
+ *
+ * \param[in] from_priority  The first layer to apply.
+ * \param[in] to_priority  The layer at which to stop.
+ */
+void option_info::replay_layers(int from_priority, int to_priority)
+{
+    bool const multiple(has_flag(GETOPT_FLAG_MULTIPLE));
+
+    f_replaying = true;
+    int const max(std::min(to_priority, static_cast<int>(f_layers.size())));
+    for(int priority(from_priority); priority < max; ++priority)
+    {
+        for(auto const & e : f_layers[priority].f_entries)
+        {
+            switch(e.f_index)
+            {
+            case LAYER_VALUES:
+                f_source = e.f_value.empty()
+                                ? option_source_t::SOURCE_UNDEFINED
+                                : e.f_source;
+                f_value = e.f_value;
+                f_integer.clear();
+                f_double.clear();
+                f_address.reset();
+                f_key_index_valid = false;
+                break;
+
+            case LAYER_APPEND:
+                for(auto const & v : e.f_value)
+                {
+                    store_value(
+                              multiple
+                                    ? f_value.size()
+                                    : 0
+                            , v
+                            , e.f_option_keys
+                            , e.f_source
+                            , false);
+                }
+                break;
+
+            default:
+                // the lower layers may now have fewer values
+                //
+                store_value(
+                          std::min(e.f_index, static_cast<int>(f_value.size()))
+                        , e.f_value[0]
+                        , e.f_option_keys
+                        , e.f_source
+                        , false);
+                break;
+
+            }
+        }
+    }
+    f_replaying = false;
+}
+
+
+/** \brief Get a modifiable definition.
+ *
+ * The definition of an option may be shared with other option_info
+ * objects (see the option_info(definition_pointer_t) constructor and
+ * get_definition()). A shared definition is frozen: it is never
+ * modified. In that case, this function first replaces the definition
+ * of this option with a copy which the setters can then modify.
+ *
+ * While the definition is only referenced by this option (the usual
+ * case while the options get defined), it is modified in place so
+ * calling several setters in a row does not create any copy.
+ *
+ * \warning
+ * Copying the definition may release the previous one. A
+ * parse_session indexes the options by name using std::string_view
+ * objects pointing to the f_name of the definitions. It keeps a
+ * reference to those definitions so its views remain valid, but it
+ * does not see the changes made after it was created. Do not change
+ * the definitions of the options while a parse_session exists.
+ *
+ * \return A reference to the definition of this option which can be
+ * modified.
+ */
+option_info::definition_t & option_info::edit_definition()
+{
+    // f_definition and f_editable_definition are two references to the
+    // same definition; any other reference means it is shared
+    //
+    if(f_editable_definition == nullptr
+    || f_editable_definition.use_count() != 2)
+    {
+        f_editable_definition = std::make_shared<definition_t>(*f_definition);
+        f_definition = f_editable_definition;
+    }
+
+    return *f_editable_definition;
+}
+
 
 /** \brief Remember the source information at of this last change.
  *
  * The getopt class supports a flag which turns on the trace mode. This
  * allows it to memorize where the values came fram. This includes the
  * source and if the source is a configuration file, the path to that
- * configuration file.
+ * configuration file and the line number.
+ *
+ * The function only saves a compact record. The string is generated
+ * only if the trace_sources() function gets called.
  */
 void option_info::trace_source(int idx)
 {
@@ -2070,15 +3802,63 @@ void option_info::trace_source(int idx)
         return;
     }
 
+    trace_record_t record;
+    record.f_source = f_source;
+    if(f_source == option_source_t::SOURCE_CONFIGURATION)
+    {
+        record.f_filename = g_configuration_context.f_filename;
+        record.f_line = g_configuration_context.f_line;
+    }
+
+    if(f_source != option_source_t::SOURCE_UNDEFINED)
+    {
+        if(f_value.empty())
+        {
+            // this should never ever happen
+            // (if f_value is empty then f_source == SOURCE_UNDEFINED)
+            //
+            record.f_index = TRACE_NO_VALUE;     // LCOV_EXCL_LINE
+        }
+        else if(!has_flag(GETOPT_FLAG_MULTIPLE)
+             || static_cast<std::size_t>(idx) >= f_value.size())
+        {
+            record.f_value = f_value[0];
+        }
+        else
+        {
+            record.f_index = idx;
+            record.f_value = f_value[idx];
+        }
+    }
+
+    f_trace_records.push_back(std::move(record));
+}
+
+
+/** \brief Convert a trace record to a string.
+ *
+ * This function generates the human readable version of a trace record
+ * as returned by the trace_sources() function.
+ *
+ * \param[in] record  The record to convert.
+ *
+ * \return The string representing \p record.
+ */
+std::string option_info::format_trace(trace_record_t const & record) const
+{
     std::string s;
-    switch(f_source)
+    switch(record.f_source)
     {
     case option_source_t::SOURCE_COMMAND_LINE:
         s = "command-line";
         break;
 
     case option_source_t::SOURCE_CONFIGURATION:
-        s = "configuration=\"" + g_configuration_filename + "\"";
+        s = "configuration=\""
+          + (record.f_filename < g_trace_filenames.size()
+                ? g_trace_filenames[record.f_filename]
+                : std::string())
+          + "\"";
         break;
 
     case option_source_t::SOURCE_DIRECT:
@@ -2096,32 +3876,21 @@ void option_info::trace_source(int idx)
     case option_source_t::SOURCE_UNDEFINED:
         // this happens on a reset or all the values were invalid
         //
-        f_trace_sources.push_back(f_name + " [*undefined-source*]");
-        return;
+        return f_definition->f_name + " [*undefined-source*]";
 
     }
 
-    if(f_value.empty())
+    if(record.f_index == TRACE_NO_VALUE)
     {
-        // this should never ever happen
-        // (if f_value is empty then f_source == SOURCE_UNDEFINED)
-        //
-        f_trace_sources.push_back(f_name + " [*undefined-value*]");     // LCOV_EXCL_LINE
+        return f_definition->f_name + " [*undefined-value*]";     // LCOV_EXCL_LINE
     }
-    else
+
+    if(record.f_index == TRACE_SINGLE_VALUE)
     {
-        // TODO: change the algorithm, if the option supports
-        //
-        if(!has_flag(GETOPT_FLAG_MULTIPLE)
-        || static_cast<std::size_t>(idx) >= f_value.size())
-        {
-            f_trace_sources.push_back(f_name + "=" + f_value[0] + " [" + s + "]");
-        }
-        else
-        {
-            f_trace_sources.push_back(f_name + "[" + std::to_string(idx) + "]=" + f_value[idx] + " [" + s + "]");
-        }
+        return f_definition->f_name + "=" + record.f_value + " [" + s + "]";
     }
+
+    return f_definition->f_name + "[" + std::to_string(record.f_index) + "]=" + record.f_value + " [" + s + "]";
 }
 
 
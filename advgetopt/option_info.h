@@ -37,8 +37,14 @@
 
 // C++
 //
+#include    <atomic>
+#include    <cstdint>
 #include    <functional>
 #include    <map>
+#include    <memory>
+#include    <optional>
+#include    <string_view>
+#include    <unordered_map>
 
 
 
@@ -69,6 +75,11 @@ enum class option_source_t
 };
 
 
+// see advgetopt/validator_address.h
+//
+struct network_address_t;
+
+
 // the `option_info` can be used instead or on top of the `struct option`
 // it is especially used to read an external getopt declaration file
 //
@@ -77,16 +88,63 @@ class option_info
 public:
     typedef std::shared_ptr<option_info>                    pointer_t;
     typedef std::vector<pointer_t>                          vector_t;
-    typedef std::map<std::string, pointer_t>                map_by_name_t;
+    typedef std::map<std::string, pointer_t, std::less<>>   map_by_name_t;
     typedef std::map<short_name_t, pointer_t>               map_by_short_name_t;
     typedef std::function<void (option_info const & opt)>   callback_t;
     typedef int                                             callback_id_t;
+    typedef std::uint64_t                                   generation_t;
+
+    static constexpr std::int32_t   TRACE_SINGLE_VALUE = -1;
+    static constexpr std::int32_t   TRACE_NO_VALUE = -2;
+
+    struct trace_record_t
+    {
+        option_source_t         f_source = option_source_t::SOURCE_UNDEFINED;
+        std::uint32_t           f_filename = 0;     // see get_trace_filename()
+        std::uint32_t           f_line = 0;
+        std::int32_t            f_index = TRACE_SINGLE_VALUE;
+        std::string             f_value = std::string();
+    };
+    typedef std::vector<trace_record_t>                     trace_record_vector_t;
+
+    struct value_snapshot_t
+    {
+        option_source_t         f_source = option_source_t::SOURCE_UNDEFINED;
+        generation_t            f_generation = 0;
+        string_list_t           f_value = string_list_t();
+        std::vector<std::optional<std::int64_t>>
+                                f_integer = std::vector<std::optional<std::int64_t>>();
+        std::vector<std::optional<double>>
+                                f_double = std::vector<std::optional<double>>();
+    };
+    typedef std::shared_ptr<value_snapshot_t const>         value_snapshot_pointer_t;
+    typedef std::vector<std::pair<pointer_t, std::string>>  value_batch_t;
+
+    // the definition can be shared between many option_info objects
+    // (see option_schema); the values are never shared
+    //
+    struct definition_t
+    {
+        std::string             f_name = std::string();
+        short_name_t            f_short_name = NO_SHORT_NAME;
+        std::string             f_environment_variable_name = std::string();
+        flag_t                  f_flags = GETOPT_FLAG_NONE;
+        std::string             f_default_value = std::string();
+        std::string             f_help = std::string();
+        validator::const_pointer_t
+                                f_validator = validator::const_pointer_t();
+        string_list_t           f_multiple_separators = string_list_t();
+    };
+    typedef std::shared_ptr<definition_t const>             definition_pointer_t;
 
                                 option_info(
                                       std::string const & name
                                     , short_name_t short_name = NO_SHORT_NAME);
+                                option_info(definition_pointer_t definition);
+
+    definition_pointer_t        get_definition() const;
 
-    std::string const &         get_name() const;
+    std::string                 get_name() const;
     void                        set_short_name(short_name_t short_name);
     short_name_t                get_short_name() const;
     std::string                 get_basename() const;
@@ -111,28 +169,28 @@ public:
     void                        set_default(std::string const & default_value);
     void                        set_default(char const * default_value);
     void                        remove_default();
-    std::string const &         get_default() const;
+    std::string                 get_default() const;
 
     void                        set_help(std::string const & help);
     void                        set_help(char const * help);
-    std::string const &         get_help() const;
+    std::string                 get_help() const;
 
     bool                        set_validator(std::string const & name_and_params);
-    bool                        set_validator(validator::pointer_t validator);
+    bool                        set_validator(validator::const_pointer_t validator);
     bool                        set_validator(std::nullptr_t);
-    validator::pointer_t        get_validator() const;
+    validator::const_pointer_t  get_validator() const;
 
     void                        set_alias_destination(pointer_t destination);
     pointer_t                   get_alias_destination() const;
 
     void                        set_multiple_separators(string_list_t const & separators);
     void                        set_multiple_separators(char const * const * separators);
-    string_list_t const &       get_multiple_separators() const;
+    string_list_t               get_multiple_separators() const;
 
     void                        set_variables(variables::pointer_t vars);
     variables::pointer_t        get_variables() const;
     bool                        has_value(std::string const & value) const;
-    int                         find_value_index_by_key(std::string key, int idx = 0) const;
+    int                         find_value_index_by_key(std::string const & key, int idx = 0) const;
     bool                        add_value(std::string const & value, string_list_t const & option_keys = string_list_t(), option_source_t source = option_source_t::SOURCE_DIRECT);
     bool                        set_value(int idx, std::string const & value, string_list_t const & option_keys = string_list_t(), option_source_t source = option_source_t::SOURCE_DIRECT);
     bool                        set_multiple_values(std::string const & value, string_list_t const & option_keys = string_list_t(), option_source_t source = option_source_t::SOURCE_DIRECT);
@@ -140,17 +198,40 @@ public:
     option_source_t             source() const;
     static void                 set_trace_sources(bool trace);
     string_list_t const &       trace_sources() const;
+    trace_record_vector_t const &
+                                trace_records() const;
+    static std::string          get_trace_filename(std::uint32_t id);
     static void                 set_configuration_filename(std::string const & filename);
+    static void                 set_configuration_line(int line);
     size_t                      size() const;
     std::string                 get_value(int idx = 0, bool raw = false) const;
+    std::optional<std::string>  try_get_value(int idx = 0, bool raw = false) const;
+    std::optional<std::string_view>
+                                try_get_raw_value(int idx = 0) const;
     long                        get_long(int idx = 0) const;
+    std::optional<long>         try_get_long(int idx = 0) const;
     double                      get_double(int idx = 0) const;
+    std::optional<double>       try_get_double(int idx = 0) const;
+    network_address_t           get_address(int idx = 0) const;
     void                        lock(bool always = true);
     void                        unlock();
     void                        reset();
+    void                        reset(option_source_t source);
 
     callback_id_t               add_callback(callback_t const & c);
     void                        remove_callback(callback_id_t id);
+    generation_t                get_generation() const;
+    value_snapshot_pointer_t    get_snapshot() const;
+    static generation_t         get_global_generation();
+    static bool                 apply_batch(
+                                      value_batch_t const & batch
+                                    , vector_t & changed
+                                    , option_source_t source = option_source_t::SOURCE_DYNAMIC);
+    static void                 publish_changes(vector_t const & changed);
+    void                        set_keep_layers(bool keep);
+    bool                        get_keep_layers() const;
+    void                        rewind_layer(option_source_t source);
+    bool                        forward_layer();
 
 private:
     struct callback_entry_t
@@ -166,26 +247,90 @@ private:
     };
     typedef std::vector<callback_entry_t>
                                 callback_vector_t;
+    typedef std::shared_ptr<callback_vector_t const>
+                                callback_list_t;
+
+    // the values set by each source can be kept so one source can be
+    // replaced without parsing the others again (see rewind_layer())
+    //
+    static constexpr int        LAYER_COUNT = 4;        // see layer_priority()
+    static constexpr int        LAYER_APPEND = -1;      // add_value(), all the appended values
+    static constexpr int        LAYER_VALUES = -2;      // all the values at once
+
+    struct layer_entry_t
+    {
+        option_source_t         f_source = option_source_t::SOURCE_UNDEFINED;
+        int                     f_index = LAYER_VALUES;
+        string_list_t           f_value = string_list_t();
+        string_list_t           f_option_keys = string_list_t();
+    };
+    typedef std::vector<layer_entry_t>
+                                layer_entry_vector_t;
 
+    struct layer_t
+    {
+        layer_entry_vector_t    f_entries = layer_entry_vector_t();
+        std::map<std::pair<int, string_list_t>, std::size_t>
+                                f_indexed = std::map<std::pair<int, string_list_t>, std::size_t>();
+    };
+    typedef std::vector<layer_t>
+                                layer_vector_t;
+
+    definition_t &              edit_definition();
+    bool                        assign_value(
+                                      int idx
+                                    , std::string const & value
+                                    , string_list_t const & option_keys
+                                    , option_source_t source);
+    bool                        store_value(
+                                      int idx
+                                    , std::string const & value
+                                    , string_list_t const & option_keys
+                                    , option_source_t source
+                                    , bool validate);
+    static int                  layer_priority(option_source_t source);
+    void                        record_layer(
+                                      option_source_t source
+                                    , string_list_t const & values);
+    void                        record_layer(
+                                      option_source_t source
+                                    , int idx
+                                    , std::string const & value
+                                    , string_list_t const & option_keys);
+    void                        replay_layers(int from_priority, int to_priority);
     bool                        validate_all_values();
     bool                        validates(int idx = 0);
+    int                         find_key_index(std::string const & key, int idx = 0) const;
+    void                        index_keys() const;
+    bool                        convert_integers(std::size_t & invalid) const;
+    bool                        convert_doubles(std::size_t & invalid) const;
     void                        value_changed(int idx);
+    void                        publish(generation_t generation);
+    void                        publish_snapshot(
+                                      generation_t generation
+                                    , std::shared_ptr<value_snapshot_t> const & snapshot);
+    void                        call_callbacks();
+    std::shared_ptr<value_snapshot_t>
+                                create_snapshot(
+                                      string_list_t const & values
+                                    , option_source_t source
+                                    , value_snapshot_pointer_t const & previous) const;
     void                        trace_source(int idx);
+    std::string                 format_trace(trace_record_t const & record) const;
 
     // definitions
     //
-    std::string                 f_name = std::string();
-    short_name_t                f_short_name = NO_SHORT_NAME;
-    std::string                 f_environment_variable_name = std::string();
-    flag_t                      f_flags = GETOPT_FLAG_NONE;
-    std::string                 f_default_value = std::string();
-    std::string                 f_help = std::string();
-    validator::pointer_t        f_validator = validator::pointer_t();
+    definition_pointer_t        f_definition = definition_pointer_t();
+    std::shared_ptr<definition_t>
+                                f_editable_definition = std::shared_ptr<definition_t>();
     pointer_t                   f_alias_destination = pointer_t();
-    string_list_t               f_multiple_separators = string_list_t();
-    callback_vector_t           f_callbacks = callback_vector_t();
+    callback_list_t             f_callbacks = callback_list_t();
+    std::atomic<generation_t>   f_generation = 0;
+    mutable value_snapshot_pointer_t
+                                f_snapshot = value_snapshot_pointer_t();
     id_t                        f_next_callback_id = 0;
-    string_list_t               f_trace_sources = string_list_t();
+    trace_record_vector_t       f_trace_records = trace_record_vector_t();
+    mutable string_list_t       f_trace_sources = string_list_t();
     variables::pointer_t        f_variables = variables::pointer_t();
 
     // value read from command line, environment, .conf file
@@ -194,6 +339,19 @@ private:
     string_list_t               f_value = string_list_t();
     mutable std::vector<long>   f_integer = std::vector<long>();
     mutable std::vector<double> f_double = std::vector<double>();
+    mutable std::shared_ptr<std::vector<network_address_t>>
+                                f_address = std::shared_ptr<std::vector<network_address_t>>();
+    mutable std::unordered_map<std::string, int>
+                                f_key_index = std::unordered_map<std::string, int>();
+    mutable bool                f_key_index_valid = false;
+
+    // per source values (layers), empty unless kept
+    //
+    layer_vector_t              f_layers = layer_vector_t();
+    int                         f_rewound_priority = -1;
+    bool                        f_replaying = false;
+    option_source_t             f_rewound_source = option_source_t::SOURCE_UNDEFINED;
+    string_list_t               f_rewound_value = string_list_t();
 };
 
 
@@ -0,0 +1,640 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+/** \file
+ * \brief Implementation of the option_overlay class.
+ *
+ * Request handlers sometimes need a few options to have a different
+ * value for one request (i.e. a per-tenant timeout). Copying the getopt
+ * object is expensive and changing the shared option_info objects
+ * affects all the other requests.
+ *
+ * The option_overlay object references a base getopt object and only
+ * saves the values which get overridden. All the other lookups fall
+ * through to the base. The overridden values are allocated in a small
+ * arena which is part of the overlay object itself so creating and
+ * destroying an overlay with a few short values does not touch the
+ * heap at all.
+ */
+
+// self
+//
+#include    "advgetopt/option_overlay.h"
+
+#include    "advgetopt/exception.h"
+#include    "advgetopt/validator_integer.h"
+
+
+// cppthread
+//
+#include    <cppthread/log.h>
+
+
+// C++
+//
+#include    <algorithm>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+
+namespace advgetopt
+{
+
+
+
+/** \brief Initialize an overlay.
+ *
+ * The overlay keeps a reference to \p base. The base must remain valid
+ * for as long as the overlay exists. The overlay never modifies the
+ * base so any number of overlays can reference the same base, in
+ * parallel, as long as each overlay is used by a single thread.
+ *
+ * Since the arena is part of the object, an overlay is expected to be
+ * created on the stack of the function handling the request. It can't
+ * be copied.
+ *
+ * \param[in] base  The getopt object with the default values.
+ */
+option_overlay::option_overlay(getopt const & base)
+    : f_base(base)
+    , f_arena(f_buffer, sizeof(f_buffer))
+    , f_overrides(&f_arena)
+{
+}
+
+
+/** \brief Retrieve the base getopt object.
+ *
+ * \return A reference to the getopt object this overlay references.
+ */
+getopt const & option_overlay::get_base() const
+{
+    return f_base;
+}
+
+
+/** \brief Override the value of an option.
+ *
+ * This function saves \p value as the value of option \p name for this
+ * overlay. If the option was already overridden, the new value replaces
+ * the old one. The base getopt object is not modified.
+ *
+ * The value gets checked against the validator of the option. If it
+ * does not validate, an error is logged and the previous state of the
+ * overlay is kept.
+ *
+ * An overlay saves exactly one value per option. For an option which
+ * accepts multiple values, the override replaces all the values of
+ * the base.
+ *
+ * \exception getopt_logic_error
+ * The option must exist in the base getopt object.
+ *
+ * \param[in] name  The name of the option to override.
+ * \param[in] value  The new value of the option.
+ *
+ * \return true if the value was accepted.
+ */
+bool option_overlay::set_value(std::string const & name, std::string const & value)
+{
+    option_info::pointer_t opt(get_option(name));
+    if(opt == nullptr)
+    {
+        throw getopt_logic_error(
+                  "option_overlay::set_value(): there is no --"
+                + name
+                + " option defined.");
+    }
+
+    validator::const_pointer_t v(opt->get_validator());
+    validation_result result;
+    if(v != nullptr
+    && !value.empty()
+    && !v->validate_with_result(value, result))
+    {
+        cppthread::log << cppthread::log_level_t::error
+                       << "input \""
+                       << value
+                       << "\" given to parameter --"
+                       << opt->get_name()
+                       << " is not considered valid: "
+                       << result.get_message()
+                       << cppthread::end;
+        return false;
+    }
+
+    auto it(std::find_if(
+          f_overrides.begin()
+        , f_overrides.end()
+        , [&opt](override_t const & o)
+        {
+            return o.f_option == opt.get();
+        }));
+    if(it != f_overrides.end())
+    {
+        it->f_value.assign(value);
+    }
+    else
+    {
+        f_overrides.push_back(override_t{ opt.get(), std::pmr::string(value, &f_arena) });
+    }
+
+    return true;
+}
+
+
+/** \brief Remove the override of an option.
+ *
+ * After this call, the value of option \p name comes from the base
+ * getopt object again. If the option was not overridden, nothing
+ * happens.
+ *
+ * \param[in] name  The name of the option to restore.
+ */
+void option_overlay::reset(std::string const & name)
+{
+    option_info::pointer_t opt(get_option(name));
+    if(opt == nullptr)
+    {
+        return;
+    }
+
+    auto it(std::find_if(
+          f_overrides.begin()
+        , f_overrides.end()
+        , [&opt](override_t const & o)
+        {
+            return o.f_option == opt.get();
+        }));
+    if(it != f_overrides.end())
+    {
+        f_overrides.erase(it);
+    }
+}
+
+
+/** \brief Remove all the overrides.
+ *
+ * This function restores all the options and releases the arena so the
+ * overlay can be reused for another request without growing.
+ */
+void option_overlay::clear()
+{
+    // the vector buffer lives in the arena, get rid of it before the
+    // release() call
+    //
+    std::pmr::vector<override_t>(&f_arena).swap(f_overrides);
+    f_arena.release();
+}
+
+
+/** \brief Check whether an option is overridden by this overlay.
+ *
+ * \param[in] name  The name of the option to check.
+ *
+ * \return true if set_value() was called for that option and it was not
+ * reset since.
+ */
+bool option_overlay::is_overridden(std::string const & name) const
+{
+    if(f_overrides.empty())
+    {
+        return false;
+    }
+
+    option_info::pointer_t opt(get_option(name));
+    return opt != nullptr && find_override(opt.get()) != nullptr;
+}
+
+
+/** \brief Retrieve the number of overridden options.
+ *
+ * \return The number of options with a value in this overlay.
+ */
+std::size_t option_overlay::overrides() const
+{
+    return f_overrides.size();
+}
+
+
+/** \brief Check whether an option is defined.
+ *
+ * An overridden option is always defined. Other options are checked in
+ * the base getopt object.
+ *
+ * \param[in] name  The name of the option to check.
+ *
+ * \return true if the option is defined.
+ *
+ * \sa getopt::is_defined()
+ */
+bool option_overlay::is_defined(std::string const & name) const
+{
+    if(f_overrides.empty())
+    {
+        return f_base.is_defined(name);
+    }
+
+    option_info::pointer_t opt(get_option(name));
+    if(opt != nullptr
+    && find_override(opt.get()) != nullptr)
+    {
+        return true;
+    }
+
+    return f_base.is_defined(name);
+}
+
+
+/** \brief Retrieve the number of values of an option.
+ *
+ * An overridden option has exactly one value. Other options are checked
+ * in the base getopt object.
+ *
+ * \param[in] name  The name of the option to check.
+ *
+ * \return The number of values of the option.
+ *
+ * \sa getopt::size()
+ */
+std::size_t option_overlay::size(std::string const & name) const
+{
+    if(f_overrides.empty())
+    {
+        return f_base.size(name);
+    }
+
+    option_info::pointer_t opt(get_option(name));
+    if(opt != nullptr
+    && find_override(opt.get()) != nullptr)
+    {
+        return 1;
+    }
+
+    return f_base.size(name);
+}
+
+
+/** \brief Retrieve the value of an option as a long.
+ *
+ * If the option is overridden, the overlay value gets converted.
+ * Otherwise the function returns getopt::get_long() from the base.
+ *
+ * As with the base, an invalid number or a number out of bounds is
+ * logged as an error and the function returns -1.
+ *
+ * \exception getopt_undefined
+ * The \p idx parameter must be 0 when the option is overridden.
+ *
+ * \param[in] name  The name of the option.
+ * \param[in] idx  The index of the value.
+ * \param[in] min  The minimum value (inclusive).
+ * \param[in] max  The maximum value (inclusive).
+ *
+ * \return The value of the option as a long.
+ *
+ * \sa getopt::get_long()
+ */
+long option_overlay::get_long(
+      std::string const & name
+    , int idx
+    , long min
+    , long max) const
+{
+    if(f_overrides.empty())
+    {
+        return f_base.get_long(name, idx, min, max);
+    }
+
+    option_info::pointer_t opt(get_option(name));
+    override_t const * o(opt == nullptr ? nullptr : find_override(opt.get()));
+    if(o == nullptr)
+    {
+        return f_base.get_long(name, idx, min, max);
+    }
+
+    if(idx != 0)
+    {
+        throw getopt_undefined(
+                  "option_overlay::get_long(): no value at index "
+                + std::to_string(idx)
+                + " (idx >= 1) for --"
+                + opt->get_name()
+                + " so you can't get this value.");
+    }
+
+    std::int64_t result(0);
+    if(!validator_integer::convert_string(o->f_value, result))
+    {
+        cppthread::log << cppthread::log_level_t::error
+                       << "invalid number ("
+                       << o->f_value
+                       << ") in parameter --"
+                       << opt->get_name()
+                       << " at offset 0."
+                       << cppthread::end;
+        return -1;
+    }
+
+    if(result < min || result > max)
+    {
+        cppthread::log << cppthread::log_level_t::error
+                       << result
+                       << " is out of bounds ("
+                       << min
+                       << ".."
+                       << max
+                       << " inclusive) in parameter --"
+                       << name
+                       << "."
+                       << cppthread::end;
+        return -1;
+    }
+
+    return result;
+}
+
+
+/** \brief Try to retrieve the value of an option as a long.
+ *
+ * This function is similar to get_long() except that it never throws
+ * and never logs an error. Instead it returns std::nullopt.
+ *
+ * \param[in] name  The name of the option.
+ * \param[in] idx  The index of the value.
+ * \param[in] min  The minimum value (inclusive).
+ * \param[in] max  The maximum value (inclusive).
+ *
+ * \return The value or std::nullopt.
+ *
+ * \sa getopt::try_get_long()
+ */
+std::optional<long> option_overlay::try_get_long(
+      std::string_view name
+    , int idx
+    , long min
+    , long max) const
+{
+    if(f_overrides.empty())
+    {
+        return f_base.try_get_long(name, idx, min, max);
+    }
+
+    option_info::pointer_t opt(get_option(name));
+    override_t const * o(opt == nullptr ? nullptr : find_override(opt.get()));
+    if(o == nullptr)
+    {
+        return f_base.try_get_long(name, idx, min, max);
+    }
+
+    std::int64_t result(0);
+    if(idx != 0
+    || !validator_integer::convert_string(o->f_value, result)
+    || result < min
+    || result > max)
+    {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+
+/** \brief Retrieve the value of an option.
+ *
+ * If the option is overridden, the overlay value is returned, with its
+ * variables processed unless \p raw is true. Like with the base, an
+ * empty value is replaced by the default when the option is not marked
+ * as GETOPT_FLAG_REQUIRED.
+ *
+ * Other options are retrieved from the base getopt object.
+ *
+ * \exception getopt_undefined
+ * The \p idx parameter must be 0 when the option is overridden.
+ *
+ * \param[in] name  The name of the option.
+ * \param[in] idx  The index of the value.
+ * \param[in] raw  Whether to skip the variable processing.
+ *
+ * \return The value of the option.
+ *
+ * \sa getopt::get_string()
+ */
+std::string option_overlay::get_string(
+      std::string const & name
+    , int idx
+    , bool raw) const
+{
+    if(f_overrides.empty())
+    {
+        return f_base.get_string(name, idx, raw);
+    }
+
+    option_info::pointer_t opt(get_option(name));
+    override_t const * o(opt == nullptr ? nullptr : find_override(opt.get()));
+    if(o == nullptr)
+    {
+        return f_base.get_string(name, idx, raw);
+    }
+
+    if(idx != 0)
+    {
+        throw getopt_undefined(
+                  "option_overlay::get_string(): no value at index "
+                + std::to_string(idx)
+                + " (idx >= 1) for --"
+                + opt->get_name()
+                + " so you can't get this value.");
+    }
+
+    return process_value(*opt, o->f_value, raw);
+}
+
+
+/** \brief Try to retrieve the value of an option.
+ *
+ * This function is similar to get_string() except that it returns
+ * std::nullopt instead of throwing.
+ *
+ * \param[in] name  The name of the option.
+ * \param[in] idx  The index of the value.
+ * \param[in] raw  Whether to skip the variable processing.
+ *
+ * \return The value of the option or std::nullopt.
+ *
+ * \sa getopt::try_get_string()
+ */
+std::optional<std::string> option_overlay::try_get_string(
+      std::string_view name
+    , int idx
+    , bool raw) const
+{
+    if(f_overrides.empty())
+    {
+        return f_base.try_get_string(name, idx, raw);
+    }
+
+    option_info::pointer_t opt(get_option(name));
+    override_t const * o(opt == nullptr ? nullptr : find_override(opt.get()));
+    if(o == nullptr)
+    {
+        return f_base.try_get_string(name, idx, raw);
+    }
+
+    if(idx != 0)
+    {
+        return std::nullopt;
+    }
+
+    return process_value(*opt, o->f_value, raw);
+}
+
+
+/** \brief Get a view of the raw value of an option.
+ *
+ * This function returns a view of the raw value of an option without
+ * making a copy. For an overridden option, the view points to the
+ * arena of the overlay.
+ *
+ * \warning
+ * The view becomes invalid when the option gets modified, in the
+ * overlay or in the base, and when the overlay is destroyed.
+ *
+ * \param[in] name  The name of the option.
+ * \param[in] idx  The index of the value.
+ *
+ * \return A view of the value or std::nullopt.
+ *
+ * \sa getopt::try_get_raw_string()
+ */
+std::optional<std::string_view> option_overlay::try_get_raw_string(
+      std::string_view name
+    , int idx) const
+{
+    if(f_overrides.empty())
+    {
+        return f_base.try_get_raw_string(name, idx);
+    }
+
+    option_info::pointer_t opt(get_option(name));
+    override_t const * o(opt == nullptr ? nullptr : find_override(opt.get()));
+    if(o == nullptr)
+    {
+        return f_base.try_get_raw_string(name, idx);
+    }
+
+    if(idx != 0)
+    {
+        return std::nullopt;
+    }
+
+    if(o->f_value.empty()
+    && opt->has_default()
+    && !opt->has_flag(GETOPT_FLAG_REQUIRED))
+    {
+        return std::string_view(opt->get_definition()->f_default_value);
+    }
+
+    return std::string_view(o->f_value);
+}
+
+
+/** \brief Search an option in the base.
+ *
+ * Aliases are resolved so overriding an alias overrides its destination.
+ *
+ * The search does not throw and does not copy \p name (see
+ * getopt::find_option()).
+ *
+ * \param[in] name  The name of the option.
+ *
+ * \return The option or nullptr if it does not exist.
+ */
+option_info::pointer_t option_overlay::get_option(std::string_view name) const
+{
+    return f_base.find_option(name);
+}
+
+
+/** \brief Search the override of an option.
+ *
+ * The overlay is expected to hold very few overrides so a linear search
+ * is faster than any map.
+ *
+ * \param[in] opt  The option to search.
+ *
+ * \return The override or nullptr.
+ */
+option_overlay::override_t const * option_overlay::find_override(option_info const * opt) const
+{
+    for(auto const & o : f_overrides)
+    {
+        if(o.f_option == opt)
+        {
+            return &o;
+        }
+    }
+
+    return nullptr;
+}
+
+
+/** \brief Transform an overridden value as getopt::get_string() would.
+ *
+ * \param[in] opt  The overridden option.
+ * \param[in] value  The value of the override.
+ * \param[in] raw  Whether to skip the variable processing.
+ *
+ * \return The value to return to the caller.
+ */
+std::string option_overlay::process_value(
+      option_info const & opt
+    , std::string_view value
+    , bool raw) const
+{
+    if(value.empty()
+    && opt.has_default()
+    && !opt.has_flag(GETOPT_FLAG_REQUIRED))
+    {
+        return opt.get_default();
+    }
+
+    std::string result(value);
+    if(!raw
+    && opt.has_flag(GETOPT_FLAG_PROCESS_VARIABLES))
+    {
+        variables::pointer_t vars(f_base.get_variables());
+        if(vars != nullptr)
+        {
+            return vars->process_value(result);
+        }
+    }
+
+    return result;
+}
+
+
+
+} // namespace advgetopt
+// vim: ts=4 sw=4 et
@@ -0,0 +1,120 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#pragma once
+
+/** \file
+ * \brief Declaration of the option_overlay class.
+ *
+ * An overlay references a base getopt object and overrides the value of
+ * a few of its options. It is used to apply settings to one request
+ * (i.e. a per-tenant timeout) without copying or modifying the base.
+ */
+
+// self
+//
+#include    <advgetopt/advgetopt.h>
+
+
+// C++
+//
+#include    <cstddef>
+#include    <limits>
+#include    <memory_resource>
+#include    <optional>
+#include    <string>
+#include    <string_view>
+#include    <vector>
+
+
+
+namespace advgetopt
+{
+
+
+
+class option_overlay
+{
+public:
+    static constexpr std::size_t    ARENA_SIZE = 512;
+
+                                option_overlay(getopt const & base);
+                                option_overlay(option_overlay const &) = delete;
+    option_overlay &            operator = (option_overlay const &) = delete;
+
+    getopt const &              get_base() const;
+
+    bool                        set_value(std::string const & name, std::string const & value);
+    void                        reset(std::string const & name);
+    void                        clear();
+    bool                        is_overridden(std::string const & name) const;
+    std::size_t                 overrides() const;
+
+    bool                        is_defined(std::string const & name) const;
+    std::size_t                 size(std::string const & name) const;
+    long                        get_long(
+                                      std::string const & name
+                                    , int idx = 0
+                                    , long min = std::numeric_limits<long>::min()
+                                    , long max = std::numeric_limits<long>::max()) const;
+    std::optional<long>         try_get_long(
+                                      std::string_view name
+                                    , int idx = 0
+                                    , long min = std::numeric_limits<long>::min()
+                                    , long max = std::numeric_limits<long>::max()) const;
+    std::string                 get_string(
+                                      std::string const & name
+                                    , int idx = 0
+                                    , bool raw = false) const;
+    std::optional<std::string>  try_get_string(
+                                      std::string_view name
+                                    , int idx = 0
+                                    , bool raw = false) const;
+    std::optional<std::string_view>
+                                try_get_raw_string(
+                                      std::string_view name
+                                    , int idx = 0) const;
+
+private:
+    struct override_t
+    {
+        option_info const *     f_option = nullptr;
+        std::pmr::string        f_value = std::pmr::string();
+    };
+
+    option_info::pointer_t      get_option(std::string_view name) const;
+    override_t const *          find_override(option_info const * opt) const;
+    std::string                 process_value(
+                                      option_info const & opt
+                                    , std::string_view value
+                                    , bool raw) const;
+
+    getopt const &              f_base;
+    // not initialized on purpose, the arena writes to it as required
+    alignas(std::max_align_t) std::byte
+                                f_buffer[ARENA_SIZE];
+    std::pmr::monotonic_buffer_resource
+                                f_arena;
+    std::pmr::vector<override_t>
+                                f_overrides;
+};
+
+
+
+}   // namespace advgetopt
+// vim: ts=4 sw=4 et
@@ -0,0 +1,187 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+/** \file
+ * \brief Implementation of the option_schema class.
+ *
+ * Each getopt object creates its own option_info objects. Services
+ * which create one getopt per tenant or per thread end up with many
+ * copies of the exact same definitions (names, flags, help, validators,
+ * etc.) and spend most of their construction time rebuilding them.
+ *
+ * The option_schema object creates the definitions once. The getopt
+ * objects created from a schema only allocate the per-option values.
+ */
+
+// self
+//
+#include    "advgetopt/option_schema.h"
+
+#include    "advgetopt/exception.h"
+#include    "advgetopt/utils.h"
+
+
+// C++
+//
+#include    <algorithm>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+
+namespace advgetopt
+{
+
+
+
+/** \brief Create a schema from a list of options.
+ *
+ * This constructor creates a getopt object with \p opts and then saves
+ * the definitions of all its options. This means the options are loaded
+ * exactly as getopt would load them: the f_options array, the options
+ * files, the system options, the group names, etc.
+ *
+ * The aliases are linked so any error with those is detected here.
+ *
+ * \note
+ * The pointers in \p opts are copied as is. Like with getopt, the data
+ * they point to must remain valid as long as the schema or any getopt
+ * created from it exists.
+ *
+ * \exception getopt_logic_error
+ * The same exceptions as the getopt constructor may be raised.
+ *
+ * \param[in] opts  The list of options defining this schema.
+ */
+option_schema::option_schema(options_environment const & opts)
+{
+    getopt prototype(opts);
+    prototype.link_aliases();
+    capture(prototype);
+}
+
+
+/** \brief Create a schema from an existing getopt object.
+ *
+ * This constructor saves the definitions of all the options of
+ * \p prototype. It can be used when options get added dynamically
+ * (i.e. with add_option()) before the schema is created.
+ *
+ * The values of the prototype are ignored.
+ *
+ * \param[in] prototype  The getopt object from which the definitions
+ * are taken.
+ */
+option_schema::option_schema(getopt const & prototype)
+{
+    capture(prototype);
+}
+
+
+/** \brief Retrieve the options environment of this schema.
+ *
+ * \return A reference to the options environment.
+ */
+options_environment const & option_schema::get_options_environment() const
+{
+    return f_options_environment;
+}
+
+
+/** \brief Retrieve all the definitions.
+ *
+ * The definitions are sorted by name.
+ *
+ * \return A reference to the vector of definitions.
+ */
+option_schema::definition_vector_t const & option_schema::get_definitions() const
+{
+    return f_definitions;
+}
+
+
+/** \brief Search for a definition by name.
+ *
+ * As everywhere else, the underscores in \p name are viewed as dashes.
+ *
+ * \param[in] name  The long name of the option.
+ *
+ * \return The definition or a null pointer if not found.
+ */
+option_info::definition_pointer_t option_schema::get_definition(std::string const & name) const
+{
+    std::string const n(option_with_dashes(name));
+    auto const it(std::lower_bound(
+              f_definitions.begin()
+            , f_definitions.end()
+            , n
+            , [](option_info::definition_pointer_t const & d, std::string const & v)
+            {
+                return d->f_name < v;
+            }));
+    if(it == f_definitions.end()
+    || (*it)->f_name != n)
+    {
+        return option_info::definition_pointer_t();
+    }
+
+    return *it;
+}
+
+
+/** \brief Get the number of definitions in this schema.
+ *
+ * \return The number of definitions.
+ */
+std::size_t option_schema::size() const
+{
+    return f_definitions.size();
+}
+
+
+/** \brief Save the definitions of the \p prototype.
+ *
+ * \param[in] prototype  The getopt object from which the definitions
+ * are taken.
+ */
+void option_schema::capture(getopt const & prototype)
+{
+    f_options_environment = prototype.get_options_environment();
+
+    option_info::map_by_name_t const & options(prototype.get_options());
+    if(options.empty())
+    {
+        throw getopt_logic_error("an empty list of options is not legal, you must defined at least one (i.e. --version, --help...)");
+    }
+
+    f_definitions.reserve(options.size());
+    for(auto const & o : options)
+    {
+        f_definitions.push_back(o.second->get_definition());
+    }
+}
+
+
+
+} // namespace advgetopt
+// vim: ts=4 sw=4 et
@@ -0,0 +1,70 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#pragma once
+
+/** \file
+ * \brief Declaration of the option_schema class.
+ *
+ * A schema holds the immutable definitions of a set of options. Any
+ * number of getopt objects can be created from one schema. They all
+ * share the definitions and only allocate their own values.
+ */
+
+// self
+//
+#include    <advgetopt/advgetopt.h>
+
+
+// C++
+//
+#include    <vector>
+
+
+
+namespace advgetopt
+{
+
+
+
+class option_schema
+{
+public:
+    typedef std::shared_ptr<option_schema const>            pointer_t;
+    typedef std::vector<option_info::definition_pointer_t>  definition_vector_t;
+
+                                option_schema(options_environment const & opts);
+                                option_schema(getopt const & prototype);
+
+    options_environment const & get_options_environment() const;
+    definition_vector_t const & get_definitions() const;
+    option_info::definition_pointer_t
+                                get_definition(std::string const & name) const;
+    std::size_t                 size() const;
+
+private:
+    void                        capture(getopt const & prototype);
+
+    options_environment         f_options_environment = options_environment();
+    definition_vector_t         f_definitions = definition_vector_t();
+};
+
+
+
+}   // namespace advgetopt
+// vim: ts=4 sw=4 et
@@ -0,0 +1,734 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+/** \file
+ * \brief Implementation of the parse_session class.
+ *
+ * Daemons which accept command lines over a socket used to create a
+ * new getopt object for each command or call reset() and parse_string()
+ * on a shared one. Both are slow (the getopt object has to be created
+ * or all the options get reset, callbacks are called, buffers are
+ * reallocated) and the second is not thread safe.
+ *
+ * The parse_session object instead takes the option definitions from a
+ * prototype getopt object once. It then parses command lines in its own
+ * buffers which are reused from one command line to the next. Since the
+ * prototype is only read, any number of sessions can be used in parallel,
+ * one per thread.
+ */
+
+// self
+//
+#include    "advgetopt/parse_session.h"
+
+#include    "advgetopt/utils.h"
+#include    "advgetopt/validator_integer.h"
+
+
+// libutf8
+//
+#include    <libutf8/iterator.h>
+
+
+// C++
+//
+#include    <algorithm>
+
+
+// C
+//
+#include    <ctype.h>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+
+namespace advgetopt
+{
+
+
+
+namespace
+{
+
+
+
+/** \brief Check whether an argument is an option.
+ *
+ * This is the same test as the one used by the getopt parser: "-" by
+ * itself is not an option and "--" is viewed as one.
+ *
+ * \param[in] a  The argument to check.
+ *
+ * \return true if \p a starts with a dash and is not just "-".
+ */
+bool is_arg(std::string const & a)
+{
+    return a.length() > 1 && a[0] == '-';
+}
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Initialize a parse session.
+ *
+ * This function gathers the option definitions from the \p prototype.
+ * The prototype is not used again after the constructor returns,
+ * however, the definitions are shared so they must not be modified
+ * while the session exists.
+ *
+ * The options are indexed by name with std::string_view objects which
+ * point to the f_name of their definitions. The session keeps a
+ * reference to these definitions so the views remain valid even if
+ * an option gets its definition replaced (see
+ * option_info::edit_definition()).
+ *
+ * Aliases are resolved here so the parser directly finds the final
+ * option.
+ *
+ * \param[in] prototype  The getopt object defining the options.
+ */
+parse_session::parse_session(getopt const & prototype)
+{
+    option_info::map_by_name_t const & options(prototype.get_options());
+    f_slots.reserve(options.size());
+    for(auto const & o : options)
+    {
+        if(o.second->has_flag(GETOPT_FLAG_ALIAS))
+        {
+            continue;
+        }
+
+        int const idx(static_cast<int>(f_slots.size()));
+        f_slots.emplace_back();
+        f_slots.back().f_option = o.second;
+        f_definitions.push_back(o.second->get_definition());
+        f_by_name[f_definitions.back()->f_name] = idx;
+        if(o.second->get_short_name() != NO_SHORT_NAME)
+        {
+            f_by_short_name[o.second->get_short_name()] = idx;
+        }
+        if(o.second->is_default_option())
+        {
+            f_default_slot = idx;
+        }
+    }
+
+    for(auto const & o : options)
+    {
+        if(!o.second->has_flag(GETOPT_FLAG_ALIAS))
+        {
+            continue;
+        }
+
+        option_info::pointer_t const destination(o.second->get_alias_destination());
+        if(destination == nullptr)
+        {
+            continue;
+        }
+        int const idx(find_slot_index(destination->get_name()));
+        if(idx < 0)
+        {
+            continue;
+        }
+
+        f_definitions.push_back(o.second->get_definition());
+        f_by_name[f_definitions.back()->f_name] = idx;
+        if(o.second->get_short_name() != NO_SHORT_NAME)
+        {
+            f_by_short_name[o.second->get_short_name()] = idx;
+        }
+    }
+}
+
+
+/** \brief Parse one command line.
+ *
+ * This function clears the values of the previous command line and
+ * parses \p command_line. The syntax is the same as the one supported
+ * by getopt::parse_string() except for the array syntax
+ * (`--name[key]`) which is not supported.
+ *
+ * Only options with the GETOPT_FLAG_COMMAND_LINE flag are accepted.
+ * Values are checked against the validator of their option.
+ *
+ * Errors are not logged since a daemon generally wants to send them
+ * back to its client. Instead, the parsing stops on the first error,
+ * the function returns false and the error message is available with
+ * get_error().
+ *
+ * \param[in] command_line  The command line to parse.
+ *
+ * \return true if the command line was valid.
+ */
+bool parse_session::parse(std::string_view command_line)
+{
+    clear();
+    split(command_line);
+
+    for(std::size_t i(0); i < f_argument_count; ++i)
+    {
+        std::string const & arg(f_arguments[i]);
+        if(arg[0] != '-'
+        || arg.length() == 1)
+        {
+            // direct entry or "-" (stdin/stdout)
+            //
+            if(f_default_slot < 0)
+            {
+                return error(
+                          "no default options defined; we do not know what to do of \""
+                        + arg
+                        + "\"; standalone parameters are not accepted by this program.");
+            }
+            slot_t & slot(f_slots[f_default_slot]);
+            if(!slot.f_option->has_flag(GETOPT_FLAG_COMMAND_LINE))
+            {
+                return error("default options are not supported on the command line.");
+            }
+            if(!add_value(slot, arg))
+            {
+                return false;
+            }
+        }
+        else if(arg[1] == '-')
+        {
+            if(arg.length() == 2)
+            {
+                // end of options, anything else is a default option
+                //
+                if(f_default_slot < 0)
+                {
+                    return error("no default options defined; thus \"--\" is not accepted by this program.");
+                }
+                slot_t & slot(f_slots[f_default_slot]);
+                if(!slot.f_option->has_flag(GETOPT_FLAG_COMMAND_LINE))
+                {
+                    return error("option \"--\" is not supported on the command line.");
+                }
+                while(i + 1 < f_argument_count)
+                {
+                    ++i;
+                    if(!add_value(slot, f_arguments[i]))
+                    {
+                        return false;
+                    }
+                }
+                break;
+            }
+
+            std::string_view name(arg);
+            name.remove_prefix(2);
+            std::string_view value;
+            std::string_view::size_type const pos(name.find('='));
+            if(pos != std::string_view::npos)
+            {
+                if(pos == 0)
+                {
+                    return error("name missing in \"" + arg + "\".");
+                }
+                value = name.substr(pos + 1);
+                name = name.substr(0, pos);
+            }
+
+            int const idx(find_slot_index(name));
+            if(idx < 0)
+            {
+                return error("option \"--" + std::string(name) + "\" is not supported.");
+            }
+            slot_t & slot(f_slots[idx]);
+            if(!slot.f_option->has_flag(GETOPT_FLAG_COMMAND_LINE))
+            {
+                return error("option \"--" + std::string(name) + "\" is not supported on the command line.");
+            }
+
+            if(pos != std::string_view::npos)
+            {
+                if(!set_value(slot, value))
+                {
+                    return false;
+                }
+            }
+            else if(!add_values(slot, i))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            // short option(s); add_values() may increment i so
+            // keep a reference to this argument
+            //
+            libutf8::utf8_iterator short_args(arg);
+            for(++short_args; short_args != arg.end(); ++short_args)
+            {
+                auto const it(f_by_short_name.find(*short_args));
+                if(it == f_by_short_name.end())
+                {
+                    return error(
+                              "option \"-"
+                            + short_name_to_string(*short_args)
+                            + "\" is not supported.");
+                }
+                slot_t & slot(f_slots[it->second]);
+                if(!slot.f_option->has_flag(GETOPT_FLAG_COMMAND_LINE))
+                {
+                    return error(
+                              "option \"-"
+                            + short_name_to_string(*short_args)
+                            + "\" is not supported on the command line.");
+                }
+                if(!add_values(slot, i))
+                {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+
+/** \brief Clear the values.
+ *
+ * This function marks all the options as undefined. The buffers are
+ * kept so the next parse() does not have to allocate them again.
+ */
+void parse_session::clear()
+{
+    for(auto & slot : f_slots)
+    {
+        slot.f_size = 0;
+    }
+    f_argument_count = 0;
+    f_error.clear();
+}
+
+
+/** \brief Retrieve the last error.
+ *
+ * When parse() returns false, this function returns the corresponding
+ * error message.
+ *
+ * \return The last error message or an empty string.
+ */
+std::string const & parse_session::get_error() const
+{
+    return f_error;
+}
+
+
+/** \brief Check whether an option was defined on the command line.
+ *
+ * \param[in] name  The long name of the option.
+ *
+ * \return true if the option was found on the last command line.
+ */
+bool parse_session::is_defined(std::string_view name) const
+{
+    slot_t const * slot(find_slot(name));
+    return slot != nullptr && slot->f_size > 0;
+}
+
+
+/** \brief Retrieve the number of values of an option.
+ *
+ * \param[in] name  The long name of the option.
+ *
+ * \return The number of values found on the last command line.
+ */
+std::size_t parse_session::size(std::string_view name) const
+{
+    slot_t const * slot(find_slot(name));
+    return slot == nullptr ? 0 : slot->f_size;
+}
+
+
+/** \brief Retrieve the value of an option.
+ *
+ * This function returns a view of the value of an option. If the
+ * option was not defined on the command line, its default value is
+ * returned instead. If it has no default, the function returns
+ * std::nullopt.
+ *
+ * Variables are not processed.
+ *
+ * \warning
+ * The view becomes invalid on the next call to parse() or clear().
+ *
+ * \param[in] name  The long name of the option.
+ * \param[in] idx  The index of the value.
+ *
+ * \return The value, the default value, or std::nullopt.
+ */
+std::optional<std::string_view> parse_session::get_string(std::string_view name, int idx) const
+{
+    slot_t const * slot(find_slot(name));
+    if(slot == nullptr)
+    {
+        return std::nullopt;
+    }
+
+    if(slot->f_size == 0)
+    {
+        if(idx == 0
+        && slot->f_option->has_default())
+        {
+            return std::string_view(slot->f_option->get_definition()->f_default_value);
+        }
+        return std::nullopt;
+    }
+
+    if(static_cast<std::size_t>(idx) >= slot->f_size)
+    {
+        return std::nullopt;
+    }
+
+    return std::string_view(slot->f_values[idx]);
+}
+
+
+/** \brief Retrieve the value of an option as a long.
+ *
+ * This function converts the value returned by get_string() to a
+ * number.
+ *
+ * \param[in] name  The long name of the option.
+ * \param[in] idx  The index of the value.
+ *
+ * \return The number or std::nullopt if undefined or not a valid integer.
+ */
+std::optional<long> parse_session::get_long(std::string_view name, int idx) const
+{
+    std::optional<std::string_view> const value(get_string(name, idx));
+    if(!value.has_value())
+    {
+        return std::nullopt;
+    }
+
+    std::int64_t result(0);
+    if(!validator_integer::convert_string(*value, result))
+    {
+        return std::nullopt;
+    }
+
+    return result;
+}
+
+
+/** \brief Find the slot of an option.
+ *
+ * \param[in] name  The long name of the option.
+ *
+ * \return A pointer to the slot or nullptr if the option does not exist.
+ */
+parse_session::slot_t const * parse_session::find_slot(std::string_view name) const
+{
+    int const idx(find_slot_index(name));
+    return idx < 0 ? nullptr : &f_slots[idx];
+}
+
+
+/** \brief Find the index of the slot of an option.
+ *
+ * Like getopt::get_option(), underscores in \p name are viewed as
+ * dashes.
+ *
+ * \param[in] name  The long name of the option.
+ *
+ * \return The index of the slot or -1 if the option does not exist.
+ */
+int parse_session::find_slot_index(std::string_view name) const
+{
+    auto it(f_by_name.find(name));
+    if(it == f_by_name.end())
+    {
+        if(name.find('_') == std::string_view::npos)
+        {
+            return -1;
+        }
+        f_name.assign(name);
+        std::replace(f_name.begin(), f_name.end(), '_', '-');
+        it = f_by_name.find(f_name);
+        if(it == f_by_name.end())
+        {
+            return -1;
+        }
+    }
+
+    return it->second;
+}
+
+
+/** \brief Split the command line in arguments.
+ *
+ * This function splits the command line the same way as
+ * getopt::split_environment() except that it reuses the argument
+ * buffers of the previous command lines.
+ *
+ * \param[in] command_line  The command line to split.
+ */
+void parse_session::split(std::string_view command_line)
+{
+    f_argument_count = 0;
+    auto next_argument = [this]() -> std::string &
+    {
+        if(f_argument_count >= f_arguments.size())
+        {
+            f_arguments.emplace_back();
+        }
+        std::string & a(f_arguments[f_argument_count]);
+        a.clear();
+        return a;
+    };
+
+    std::string * a(&next_argument());
+    char const * s(command_line.data());
+    char const * const end(s + command_line.length());
+    while(s < end)
+    {
+        if(isspace(static_cast<unsigned char>(*s)))
+        {
+            if(!a->empty())
+            {
+                ++f_argument_count;
+                a = &next_argument();
+            }
+            do
+            {
+                ++s;
+            }
+            while(s < end && isspace(static_cast<unsigned char>(*s)));
+        }
+        else if(*s == '"'
+             || *s == '\'')
+        {
+            char const quote(*s++);
+            char const * const start(s);
+            while(s < end
+               && *s != quote)
+            {
+                ++s;
+            }
+            a->append(start, s);
+            if(s < end)
+            {
+                ++s;
+            }
+        }
+        else
+        {
+            *a += *s++;
+        }
+    }
+
+    if(!a->empty())
+    {
+        ++f_argument_count;
+    }
+}
+
+
+/** \brief Add one value to an option.
+ *
+ * The value is saved in the next buffer of the slot. If the option does
+ * not support multiple values, the new value replaces the existing one.
+ *
+ * \param[in] slot  The slot of the option.
+ * \param[in] value  The value to add.
+ *
+ * \return true if the value is valid.
+ */
+bool parse_session::add_value(slot_t & slot, std::string_view value)
+{
+    if(!slot.f_option->has_flag(GETOPT_FLAG_MULTIPLE))
+    {
+        slot.f_size = 0;
+    }
+    if(slot.f_size >= slot.f_values.size())
+    {
+        slot.f_values.emplace_back();
+    }
+    std::string & v(slot.f_values[slot.f_size]);
+    v.assign(value);
+
+    validator::const_pointer_t const validator(slot.f_option->get_validator());
+    if(validator != nullptr
+    && !v.empty())
+    {
+        validation_result result;
+        if(!validator->validate_with_result(v, result))
+        {
+            return error(
+                      "input \""
+                    + v
+                    + "\" given to parameter --"
+                    + slot.f_option->get_name()
+                    + " is not considered valid: "
+                    + result.get_message());
+        }
+    }
+
+    ++slot.f_size;
+    return true;
+}
+
+
+/** \brief Add the values following an option.
+ *
+ * This function is the equivalent of getopt::add_options(). It reads
+ * the values following the option at position \p i.
+ *
+ * \param[in] slot  The slot of the option.
+ * \param[in,out] i  The position of the option, updated to the last value.
+ *
+ * \return true if the values are valid.
+ */
+bool parse_session::add_values(slot_t & slot, std::size_t & i)
+{
+    if(slot.f_option->has_flag(GETOPT_FLAG_FLAG))
+    {
+        return add_value(slot, slot.f_option->get_default());
+    }
+
+    if(i + 1 < f_argument_count
+    && !is_arg(f_arguments[i + 1]))
+    {
+        if(slot.f_option->has_flag(GETOPT_FLAG_MULTIPLE))
+        {
+            do
+            {
+                ++i;
+                if(!add_value(slot, f_arguments[i]))
+                {
+                    return false;
+                }
+            }
+            while(i + 1 < f_argument_count
+               && !is_arg(f_arguments[i + 1]));
+            return true;
+        }
+
+        ++i;
+        return add_value(slot, f_arguments[i]);
+    }
+
+    if(slot.f_option->has_flag(GETOPT_FLAG_REQUIRED))
+    {
+        return error(
+                  "option --"
+                + slot.f_option->get_name()
+                + " expects an argument.");
+    }
+
+    return add_value(slot, std::string_view());
+}
+
+
+/** \brief Set the value of an option from `--name=value`.
+ *
+ * This function is the equivalent of getopt::add_option_from_string().
+ * Options with multiple values get their value split with their
+ * separators and the result replaces the existing values.
+ *
+ * \param[in] slot  The slot of the option.
+ * \param[in] value  The value after the equal sign.
+ *
+ * \return true if the value is valid.
+ */
+bool parse_session::set_value(slot_t & slot, std::string_view value)
+{
+    if(value.empty())
+    {
+        if(slot.f_option->has_flag(GETOPT_FLAG_REQUIRED))
+        {
+            return error(
+                      "option --"
+                    + slot.f_option->get_name()
+                    + " must be given a value.");
+        }
+        return add_value(slot, value);
+    }
+
+    if(slot.f_option->has_flag(GETOPT_FLAG_FLAG))
+    {
+        f_name.assign(value);
+        if(is_false(f_name))
+        {
+            slot.f_size = 0;
+            return true;
+        }
+        if(is_true(f_name))
+        {
+            return add_value(slot, std::string_view());
+        }
+        return error(
+                  "option --"
+                + slot.f_option->get_name()
+                + " cannot be given value \""
+                + f_name
+                + "\". It only accepts \"true\" or \"false\".");
+    }
+
+    if(!slot.f_option->has_flag(GETOPT_FLAG_MULTIPLE))
+    {
+        return add_value(slot, value);
+    }
+
+    f_name.assign(value);
+    f_split.clear();
+    split_string(unquote(f_name, "[]"), f_split, slot.f_option->get_multiple_separators());
+    slot.f_size = 0;
+    for(auto const & v : f_split)
+    {
+        if(!add_value(slot, v))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/** \brief Save an error message.
+ *
+ * \param[in] message  The error message.
+ *
+ * \return Always false so the caller can return the result as is.
+ */
+bool parse_session::error(std::string const & message)
+{
+    f_error = message;
+    return false;
+}
+
+
+
+} // namespace advgetopt
+// vim: ts=4 sw=4 et
@@ -0,0 +1,100 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#pragma once
+
+/** \file
+ * \brief Declaration of the parse_session class.
+ *
+ * A parse session parses command lines against the options of a
+ * prototype getopt object without modifying that object. It is used by
+ * daemons which receive many small command lines (i.e. over a control
+ * socket).
+ */
+
+// self
+//
+#include    <advgetopt/advgetopt.h>
+
+
+// C++
+//
+#include    <optional>
+#include    <string_view>
+#include    <unordered_map>
+#include    <vector>
+
+
+
+namespace advgetopt
+{
+
+
+
+class parse_session
+{
+public:
+    typedef std::shared_ptr<parse_session>  pointer_t;
+
+                                parse_session(getopt const & prototype);
+
+    bool                        parse(std::string_view command_line);
+    void                        clear();
+    std::string const &         get_error() const;
+
+    bool                        is_defined(std::string_view name) const;
+    std::size_t                 size(std::string_view name) const;
+    std::optional<std::string_view>
+                                get_string(std::string_view name, int idx = 0) const;
+    std::optional<long>         get_long(std::string_view name, int idx = 0) const;
+
+private:
+    struct slot_t
+    {
+        option_info::pointer_t  f_option = option_info::pointer_t();
+        string_list_t           f_values = string_list_t();
+        std::size_t             f_size = 0;
+    };
+
+    slot_t const *              find_slot(std::string_view name) const;
+    int                         find_slot_index(std::string_view name) const;
+    void                        split(std::string_view command_line);
+    bool                        add_value(slot_t & slot, std::string_view value);
+    bool                        add_values(slot_t & slot, std::size_t & i);
+    bool                        set_value(slot_t & slot, std::string_view value);
+    bool                        error(std::string const & message);
+
+    std::vector<slot_t>         f_slots = std::vector<slot_t>();
+    std::unordered_map<std::string_view, int>
+                                f_by_name = std::unordered_map<std::string_view, int>();
+    std::unordered_map<short_name_t, int>
+                                f_by_short_name = std::unordered_map<short_name_t, int>();
+    std::vector<option_info::definition_pointer_t>
+                                f_definitions = std::vector<option_info::definition_pointer_t>();
+    int                         f_default_slot = -1;
+    string_list_t               f_arguments = string_list_t();
+    std::size_t                 f_argument_count = 0;
+    string_list_t               f_split = string_list_t();
+    mutable std::string         f_name = std::string();
+    std::string                 f_error = std::string();
+};
+
+
+
+}   // namespace advgetopt
+// vim: ts=4 sw=4 et
@@ -48,6 +48,7 @@
 
 // C++
 //
+#include    <cstdint>
 #include    <cstring>
 #include    <iomanip>
 #include    <set>
@@ -60,6 +61,10 @@
 #include    <sys/stat.h>
 #include    <unistd.h>
 
+#ifdef __SSE2__
+#include    <emmintrin.h>
+#endif
+
 
 
 
@@ -99,6 +104,72 @@ constexpr char const *  g_simple_characters = "+-./0123456789=ABCEFGHIJKLMNOPQRS
 
 
 
+/** \brief Get a mask of the UTF-8 lead bytes of a block.
+ *
+ * The function returns a mask with one bit per byte of the block. A bit
+ * is set when the corresponding byte is not a continuation byte, i.e.
+ * each bit represents the start of a code point.
+ *
+ * With SSE2, the block is 16 bytes. Otherwise, it is 8 bytes and the
+ * test is done with plain 64 bit arithmetic.
+ *
+ * \param[in] s  The start of the block.
+ *
+ * \return The mask of the lead bytes.
+ */
+#ifdef __SSE2__
+constexpr std::size_t const g_utf8_block_size = 16;
+
+inline std::uint32_t utf8_lead_mask(char const * s)
+{
+    // continuation bytes are 0x80 to 0xBF which as signed bytes are
+    // -128 to -65 so anything greater than -65 is a lead byte
+    //
+    __m128i const block(_mm_loadu_si128(reinterpret_cast<__m128i const *>(s)));
+    __m128i const lead(_mm_cmpgt_epi8(block, _mm_set1_epi8(-65)));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(lead));
+}
+#else
+constexpr std::size_t const g_utf8_block_size = 8;
+
+inline std::uint32_t utf8_lead_mask(char const * s)
+{
+    std::uint32_t mask(0);
+    for(std::size_t idx(0); idx < g_utf8_block_size; ++idx)
+    {
+        if((static_cast<unsigned char>(s[idx]) & 0xC0) != 0x80)
+        {
+            mask |= 1U << idx;
+        }
+    }
+    return mask;
+}
+#endif
+
+
+/** \brief Count the UTF-8 lead bytes of a block.
+ *
+ * \param[in] s  The start of the block.
+ *
+ * \return The number of code points starting in this block.
+ */
+inline std::size_t utf8_block_length(char const * s)
+{
+#ifdef __SSE2__
+    return __builtin_popcount(utf8_lead_mask(s));
+#else
+    // a continuation byte has bit 7 set and bit 6 cleared; shifting the
+    // word by one moves bit 6 of each byte in bit 7 of the same byte
+    //
+    std::uint64_t w(0);
+    std::memcpy(&w, s, sizeof(w));
+    std::uint64_t const continuation(w & ~(w << 1) & 0x8080808080808080ULL);
+    return g_utf8_block_size - __builtin_popcountll(continuation);
+#endif
+}
+
+
+
 }
 // no name namespace
 
@@ -773,13 +844,103 @@ size_t get_screen_width()
 }
 
 
+/** \brief Count the number of characters in a UTF-8 string.
+ *
+ * This function counts the number of code points found in \p s. It
+ * gives the same result as libutf8::u8length(): all the bytes which are
+ * not continuation bytes are counted. It does not otherwise validate
+ * the string.
+ *
+ * The string is processed in blocks (16 bytes with SSE2) so pure ASCII
+ * and mostly ASCII inputs are counted at close to memory bandwidth.
+ *
+ * \param[in] s  The UTF-8 string to measure.
+ *
+ * \return The number of characters in \p s.
+ */
+std::size_t utf8_length(std::string_view s)
+{
+    char const * p(s.data());
+    std::size_t size(s.length());
+    std::size_t result(0);
+    while(size >= g_utf8_block_size)
+    {
+        result += utf8_block_length(p);
+        p += g_utf8_block_size;
+        size -= g_utf8_block_size;
+    }
+    for(; size > 0; --size, ++p)
+    {
+        if((static_cast<unsigned char>(*p) & 0xC0) != 0x80)
+        {
+            ++result;
+        }
+    }
+
+    return result;
+}
+
+
+/** \brief Get the byte offset of a character in a UTF-8 string.
+ *
+ * This function skips \p characters code points in \p s and returns
+ * the offset of the following one. If \p s has \p characters or fewer
+ * code points, the function returns the size of \p s.
+ *
+ * This is the counterpart of utf8_length() used to cut a string at
+ * a given width without breaking a multibyte character.
+ *
+ * \param[in] s  The UTF-8 string.
+ * \param[in] characters  The number of characters to skip.
+ *
+ * \return The offset in bytes of the character following the first
+ * \p characters code points.
+ */
+std::size_t utf8_offset(std::string_view s, std::size_t characters)
+{
+    std::size_t offset(0);
+    std::size_t const size(s.length());
+    while(offset + g_utf8_block_size <= size)
+    {
+        std::uint32_t mask(utf8_lead_mask(s.data() + offset));
+        std::size_t const count(__builtin_popcount(mask));
+        if(count > characters)
+        {
+            // the character we are looking for is in this block
+            //
+            for(; characters > 0; --characters)
+            {
+                mask &= mask - 1;
+            }
+            return offset + __builtin_ctz(mask);
+        }
+        characters -= count;
+        offset += g_utf8_block_size;
+    }
+    for(; offset < size; ++offset)
+    {
+        if((static_cast<unsigned char>(s[offset]) & 0xC0) != 0x80)
+        {
+            if(characters == 0)
+            {
+                return offset;
+            }
+            --characters;
+        }
+    }
+
+    return size;
+}
+
+
 /** \brief Breakup a string on multiple lines.
  *
  * This function breaks up the specified \p line of text in one or more
  * strings to fit your output.
  *
  * The \p line_width represents the maximum number of characters that get
- * printed in a row.
+ * printed in a row. The \p line is expected to be UTF-8 and the width
+ * is counted in characters, not bytes.
  *
  * The \p option_width parameter is the number of characters in the left
  * margin. When dealing with a very long argument, this width is 3 characters.
@@ -808,24 +969,28 @@ std::string breakup_line(
     //
     for(;;)
     {
+        // the width is in characters, get the corresponding byte offset
+        //
+        std::string::size_type const edge(utf8_offset(line, width));
+
         std::string l;
         std::string::size_type const nl(line.find('\n'));
         if(nl != std::string::npos
-        && nl < width)
+        && nl < edge)
         {
             l = line.substr(0, nl);
             line = line.substr(nl + 1);
         }
-        else if(line.size() <= width)
+        else if(edge >= line.size())
         {
             break;
         }
-        else if(std::isspace(line[width]))
+        else if(std::isspace(line[edge]))
         {
             // special case when the space is right at the edge
             //
-            l = line.substr(0, width);
-            size_t pos(width);
+            l = line.substr(0, edge);
+            size_t pos(edge);
             do
             {
                 ++pos;
@@ -837,14 +1002,14 @@ std::string breakup_line(
         {
             // search for the last space before the edge of the screen
             //
-            std::string::size_type pos(line.find_last_of(' ', width));
+            std::string::size_type pos(line.find_last_of(' ', edge));
             if(pos == std::string::npos)
             {
                 // no space found, cut right at the edge...
                 // (this should be really rare)
                 //
-                l = line.substr(0, width);
-                line = line.substr(width);
+                l = line.substr(0, edge);
+                line = line.substr(edge);
             }
             else
             {
@@ -29,6 +29,7 @@
 //
 #include    <set>
 #include    <string>
+#include    <string_view>
 #include    <vector>
 
 
@@ -62,6 +63,8 @@ std::string         default_group_name(std::string const & filename
 std::string         handle_user_directory(std::string const & filename);
 bool                is_true(std::string s);
 bool                is_false(std::string s);
+std::size_t         utf8_length(std::string_view s);
+std::size_t         utf8_offset(std::string_view s, std::size_t characters);
 std::string         breakup_line(std::string line
                                , std::size_t const option_width
                                , std::size_t const line_width);
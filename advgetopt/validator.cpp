@@ -38,7 +38,9 @@
 
 // cppthread
 //
+#include    <cppthread/guard.h>
 #include    <cppthread/log.h>
+#include    <cppthread/mutex.h>
 
 
 // snapdev
@@ -50,6 +52,14 @@
 // C++
 //
 #include    <map>
+#include    <set>
+
+
+// C
+//
+#include    <dlfcn.h>
+#include    <stdlib.h>
+#include    <unistd.h>
 
 
 // last include
@@ -63,6 +73,12 @@ namespace advgetopt
 
 
 
+// from utils.cpp
+//
+cppthread::mutex &  get_global_mutex();
+
+
+
 namespace
 {
 
@@ -72,6 +88,30 @@ typedef std::map<std::string, validator_factory const *>    factory_map_t;
 factory_map_t * g_validator_factories;
 
 
+/** \brief The default path to the validator plugins.
+ *
+ * The heavy validators (i.e. the ones depending on other libraries such
+ * as libtld) are compiled as plugins. This is the default path where
+ * these plugins get installed. It can be changed with the
+ * ADVGETOPT_VALIDATOR_PLUGINS_PATH environment variable (ignored in
+ * setuid/setgid and other secure execution programs) or a call to
+ * validator::set_plugins_path().
+ */
+#ifndef ADVGETOPT_VALIDATOR_PLUGINS_PATH
+#define ADVGETOPT_VALIDATOR_PLUGINS_PATH "/usr/lib/advgetopt/validators"
+#endif
+
+std::string *   g_plugins_path = nullptr;
+
+
+/** \brief The names of the plugins we already tried to load.
+ *
+ * A plugin gets loaded at most once. If loading fails, we do not try
+ * again on the next create() call.
+ */
+std::set<std::string> * g_plugins_tried = nullptr;
+
+
 enum class token_t
 {
     TOK_EOF,
@@ -514,11 +554,190 @@ private:
 };
 
 
+/** \brief Create the validators once parsed.
+ *
+ * \param[in] validators  The list of validators with their parameters.
+ *
+ * \return The validator or a validator_list if more than one validator
+ * was specified.
+ */
+validator::pointer_t create_validators(validator_with_params::vector_t const & validators)
+{
+    if(validators.size() == 0)
+    {
+        return validator::pointer_t();
+    }
+
+    if(validators.size() == 1)
+    {
+        return validator::create(validators[0].get_name(), validators[0].get_params());
+    }
+
+    // we need a list validator to handle this case
+    //
+    validator::pointer_t lst(validator::create("list", string_list_t()));
+    validator_list::pointer_t list(std::dynamic_pointer_cast<validator_list>(lst));
+    if(list == nullptr)
+    {
+        throw getopt_logic_error("we just created a list and the dynamic cast failed.");    // LCOV_EXCL_LINE
+    }
+    for(auto const & v : validators)
+    {
+        list->add_validator(validator::create(v.get_name(), v.get_params()));
+    }
+
+    return list;
+}
+
+
+/** \brief Transform a parsed specification in a cache key.
+ *
+ * Two specifications which only differ by spaces or quotes generate
+ * the same key. The names and parameters are separated by control
+ * characters which can't appear in a parameter.
+ *
+ * \param[in] validators  The list of validators with their parameters.
+ *
+ * \return The normalized specification.
+ */
+std::string normalized_spec(validator_with_params::vector_t const & validators)
+{
+    std::string key;
+    for(auto const & v : validators)
+    {
+        if(!key.empty())
+        {
+            key += '\x1E';
+        }
+        key += v.get_name();
+        for(auto const & p : v.get_params())
+        {
+            key += '\x1F';
+            key += p;
+        }
+    }
+    return key;
+}
+
+
+/** \brief The process wide cache of shared validators.
+ *
+ * The get_shared() function saves the validators it creates in this
+ * map. The key is the specification as given by the caller and the
+ * normalized specification so both can be found quickly.
+ *
+ * The cache is never cleared. The specifications come from the option
+ * definitions so the number of entries is small and bounded.
+ */
+typedef std::map<std::string, validator::const_pointer_t>   shared_validators_t;
+
+shared_validators_t *   g_shared_validators = nullptr;
+
+
+/** \brief The last error of the validators of the current thread.
+ *
+ * The validators returned by get_shared() are used by any number of
+ * options and threads. The error message is therefore saved per thread
+ * along with the validator which generated it.
+ */
+thread_local validator const *  g_error_validator = nullptr;
+
+
+/** \brief The validator running its default validate() function.
+ *
+ * A validator must reimplement validate() or validate_with_result(). If
+ * it does not, the default implementations would call each other
+ * forever. This pointer is used to detect that case.
+ */
+thread_local validator const *  g_validating = nullptr;
+thread_local std::string        g_error_message = std::string();
+
+std::string const               g_undefined_error = std::string("<error undefined>");
+
+
 
 } // no name namespace
 
 
 
+/** \brief Check whether the result represents a valid value.
+ *
+ * \return true if no error was set in this result.
+ */
+bool validation_result::is_valid() const
+{
+    return f_code == validation_error_t::VALIDATION_ERROR_NONE;
+}
+
+
+/** \brief Get the error code.
+ *
+ * \return The error code or VALIDATION_ERROR_NONE.
+ */
+validation_error_t validation_result::get_code() const
+{
+    return f_code;
+}
+
+
+/** \brief Get the error message.
+ *
+ * The validators generally use static messages. The result only keeps
+ * a pointer to those and the std::string gets created only when the
+ * message is actually requested (i.e. to print an error).
+ *
+ * \return The error message or an empty string if there is no error.
+ */
+std::string validation_result::get_message() const
+{
+    if(f_static_message != nullptr)
+    {
+        return f_static_message;
+    }
+    return f_message;
+}
+
+
+/** \brief Set the error using a static message.
+ *
+ * The \p message must remain valid for the lifetime of the result,
+ * which is the case of string literals.
+ *
+ * \param[in] code  The error code.
+ * \param[in] message  The static error message.
+ */
+void validation_result::set_error(validation_error_t code, char const * message)
+{
+    f_code = code;
+    f_static_message = message;
+}
+
+
+/** \brief Set the error using a dynamic message.
+ *
+ * \param[in] code  The error code.
+ * \param[in] message  The error message, which gets copied.
+ */
+void validation_result::set_error(validation_error_t code, std::string const & message)
+{
+    f_code = code;
+    f_static_message = nullptr;
+    f_message = message;
+}
+
+
+/** \brief Reset the result to a valid state.
+ */
+void validation_result::clear()
+{
+    f_code = validation_error_t::VALIDATION_ERROR_NONE;
+    f_static_message = nullptr;
+    f_message.clear();
+}
+
+
+
+
 /** \brief The destructor to ease derived classes.
  *
  * At this point this destructor does nothing more than help with the
@@ -557,30 +776,158 @@ validator::~validator()
  */
 
 
-/** \fn bool validator::validate(std::string const & value) const;
- * \brief Return true if \p value validates against this validator.
+/** \brief Return true if \p value validates against this validator.
  *
  * The function parses the \p value parameter and if it matches the
  * allowed parameters, then it returns true.
  *
- * The validator may save an error message when the validation fails.
- * See the set_error() and get_error() functions.
+ * The default implementation calls the validate_with_result() function
+ * and saves its message with set_error() when the validation fails. See
+ * the set_error() and get_error() functions.
+ *
+ * A validator has to reimplement at least one of validate() or
+ * validate_with_result(). The built-in validators reimplement the
+ * latter which does not require any state in the validator. The two
+ * functions have different names so a validator reimplementing only
+ * one of them does not hide the other.
+ *
+ * \param[in] value  The value to validate.
+ *
+ * \return true if the value validates.
+ */
+bool validator::validate(std::string const & value) const
+{
+    validation_result result;
+    if(validate_with_result(value, result))
+    {
+        return true;
+    }
+    set_error(result.get_message());
+    return false;
+}
+
+
+/** \brief Validate \p value and return the error in \p result.
+ *
+ * This function verifies \p value like validate() does. When the
+ * value is not valid, the error code and message get saved in
+ * \p result instead of the validator so the same validator can be
+ * used by any number of threads without locks.
+ *
+ * The \p result is only modified when the function returns false.
+ *
+ * The default implementation calls the validate() function and copies
+ * the error from get_error(). It is used by validators which only
+ * implement that older function.
+ *
+ * \exception getopt_logic_error
+ * This exception is raised if the validator does not reimplement
+ * validate() or validate_with_result().
  *
  * \param[in] value  The value to validate.
+ * \param[out] result  The result with the error when \p value is invalid.
  *
  * \return true if the value validates.
  */
+bool validator::validate_with_result(std::string const & value, validation_result & result) const
+{
+    if(g_validating == this)
+    {
+        throw getopt_logic_error(
+                  "validator \""
+                + name()
+                + "\" must implement validate() or validate_with_result().");
+    }
+
+    validator const * const saved(g_validating);
+    g_validating = this;
+    bool valid(false);
+    try
+    {
+        valid = validate(value);
+    }
+    catch(...)
+    {
+        g_validating = saved;
+        throw;
+    }
+    g_validating = saved;
+
+    if(!valid)
+    {
+        result.set_error(validation_error_t::VALIDATION_ERROR_INVALID, get_error());
+    }
+    return valid;
+}
+
+
+/** \brief Validate a list of values at once.
+ *
+ * This function checks all the \p values and saves the index of each
+ * value which does not validate in the \p invalid list, in increasing
+ * order. The \p invalid list is cleared first.
+ *
+ * The default implementation calls validate_with_result() on each
+ * value. Validators can reimplement this function to avoid the virtual
+ * call for each value. The error message of a batch is undefined. To
+ * get the error of a specific value, call validate_with_result() on
+ * that value.
+ *
+ * \param[in] values  The list of values to validate.
+ * \param[out] invalid  The indexes of the values that did not validate.
+ *
+ * \return true if all the values validate.
+ */
+bool validator::validate_batch(
+      string_list_t const & values
+    , index_list_t & invalid) const
+{
+    invalid.clear();
+    validation_result result;
+    for(std::size_t idx(0); idx < values.size(); ++idx)
+    {
+        if(!validate_with_result(values[idx], result))
+        {
+            invalid.push_back(idx);
+        }
+    }
+
+    return invalid.empty();
+}
 
 
+/** \brief Save an error message.
+ *
+ * The validate() function calls this function to explain why a value
+ * is not valid.
+ *
+ * The message is saved per thread so the same validator can safely be
+ * used by multiple threads (see get_shared()).
+ *
+ * \param[in] msg  The error message.
+ */
 void validator::set_error(std::string const & msg) const
 {
-    f_error = msg;
+    g_error_validator = this;
+    g_error_message = msg;
 }
 
 
+/** \brief Retrieve the last error message.
+ *
+ * This function returns the error message of the last validate() call
+ * of this validator which failed in this thread. If another validator
+ * failed since, the function returns "<error undefined>".
+ *
+ * \return The last error message of this validator.
+ */
 std::string const & validator::get_error() const
 {
-    return f_error;
+    if(g_error_validator != this)
+    {
+        return g_undefined_error;
+    }
+    return g_error_message;
 }
 
 
@@ -604,6 +951,10 @@ void validator::register_validator(validator_factory const & factory)
 
 validator::pointer_t validator::create(std::string const & name, string_list_t const & data)
 {
+    // plugins register their factory when loaded so the map may change
+    //
+    cppthread::guard lock(get_global_mutex());
+
     if(g_validator_factories == nullptr)
     {
         return validator::pointer_t();  // LCOV_EXCL_LINE
@@ -612,7 +963,17 @@ validator::pointer_t validator::create(std::string const & name, string_list_t c
     auto it(g_validator_factories->find(name));
     if(it == g_validator_factories->end())
     {
-        return validator::pointer_t();
+        // not built in, try to load it as a plugin
+        //
+        if(!load_plugin(name))
+        {
+            return validator::pointer_t();
+        }
+        it = g_validator_factories->find(name);
+        if(it == g_validator_factories->end())
+        {
+            return validator::pointer_t();
+        }
     }
 
     return it->second->create(data);
@@ -677,32 +1038,237 @@ validator::pointer_t validator::create(std::string const & name_and_params)
         return validator::pointer_t();
     }
 
-    validator_with_params::vector_t const & validators(p.get_validators());
+    return create_validators(p.get_validators());
+}
 
-    if(validators.size() == 0)
+
+/** \brief Get a shared validator.
+ *
+ * This function returns a validator like create() does, except that the
+ * validators are saved in a process wide cache. All the options using
+ * the same specification (i.e. "integer(1...65535)") share the same
+ * validator instance. The specification gets normalized so differences
+ * in spaces or quotes still return the same validator.
+ *
+ * The returned validators are immutable (i.e. you can't add validators
+ * to a shared validator_list). Use create() when you need a validator
+ * of your own.
+ *
+ * Specifications which fail to parse or name an unknown validator are
+ * not cached so the errors get reported on each call.
+ *
+ * \param[in] name_and_params  The validator specification.
+ *
+ * \return The shared validator or a nullptr.
+ */
+validator::const_pointer_t validator::get_shared(std::string const & name_and_params)
+{
+    if(name_and_params.empty())
     {
-        return validator::pointer_t();
+        return validator::const_pointer_t();
     }
 
-    if(validators.size() == 1)
+    cppthread::guard lock(get_global_mutex());
+
+    if(g_shared_validators == nullptr)
     {
-        return create(validators[0].get_name(), validators[0].get_params());
+        g_shared_validators = new shared_validators_t();
     }
 
-    // we need a list validator to handle this case
+    auto it(g_shared_validators->find(name_and_params));
+    if(it != g_shared_validators->end())
+    {
+        return it->second;
+    }
+
+    lexer l(name_and_params.c_str());
+    parser p(l);
+    if(!p.parse())
+    {
+        return validator::const_pointer_t();
+    }
+
+    // the normalized key starts with '\x1D' so it can't match a
+    // specification as given by a caller
     //
-    validator::pointer_t lst(create("list", string_list_t()));
-    validator_list::pointer_t list(std::dynamic_pointer_cast<validator_list>(lst));
-    if(list == nullptr)
+    std::string const key('\x1D' + normalized_spec(p.get_validators()));
+    it = g_shared_validators->find(key);
+    if(it != g_shared_validators->end())
     {
-        throw getopt_logic_error("we just created a list and the dynamic cast failed.");    // LCOV_EXCL_LINE
+        (*g_shared_validators)[name_and_params] = it->second;
+        return it->second;
     }
-    for(auto const & v : validators)
+
+    validator::const_pointer_t v(create_validators(p.get_validators()));
+    if(v != nullptr)
     {
-        list->add_validator(create(v.get_name(), v.get_params()));
+        (*g_shared_validators)[key] = v;
+        (*g_shared_validators)[name_and_params] = v;
     }
 
-    return list;
+    return v;
+}
+
+
+/** \brief Change the path to the validator plugins.
+ *
+ * The validators which depend on other libraries are compiled as plugins
+ * and loaded only when a validator definition names them. This function
+ * changes the directories searched for these plugins. The \p path can
+ * include multiple directories separated by colons.
+ *
+ * An empty \p path restores the default: the
+ * ADVGETOPT_VALIDATOR_PLUGINS_PATH environment variable if defined,
+ * the installation directory otherwise.
+ *
+ * \warning
+ * The plugins found in \p path get loaded in this process. Only use
+ * directories which can't be written by untrusted users.
+ *
+ * \param[in] path  The colon separated list of directories.
+ */
+void validator::set_plugins_path(std::string const & path)
+{
+    cppthread::guard lock(get_global_mutex());
+
+    if(path.empty())
+    {
+        delete g_plugins_path;
+        g_plugins_path = nullptr;
+    }
+    else if(g_plugins_path == nullptr)
+    {
+        g_plugins_path = new std::string(path);
+    }
+    else
+    {
+        *g_plugins_path = path;
+    }
+}
+
+
+/** \brief Get the path to the validator plugins.
+ *
+ * The path set with set_plugins_path() has priority. Otherwise the
+ * ADVGETOPT_VALIDATOR_PLUGINS_PATH environment variable is used. That
+ * variable is read with secure_getenv() so it is ignored when the
+ * process runs in secure execution mode (i.e. a setuid or setcap
+ * binary) since it would otherwise let a user load any code in that
+ * process. Finally, it falls back to the installation directory.
+ *
+ * \return The colon separated list of directories searched for plugins.
+ */
+std::string validator::get_plugins_path()
+{
+    cppthread::guard lock(get_global_mutex());
+
+    if(g_plugins_path != nullptr)
+    {
+        return *g_plugins_path;
+    }
+
+    char const * path(secure_getenv("ADVGETOPT_VALIDATOR_PLUGINS_PATH"));
+    if(path != nullptr
+    && *path != '\0')
+    {
+        return path;
+    }
+
+    return ADVGETOPT_VALIDATOR_PLUGINS_PATH;
+}
+
+
+/** \brief Load a validator plugin.
+ *
+ * This function searches the plugins path for a file named
+ * `validator_<name>.so` and loads it. The plugin registers its factory
+ * with register_validator() while it gets loaded.
+ *
+ * The function is called by create() when no factory is registered
+ * for \p name so tools which do not use such validators never load them
+ * (nor the libraries they depend on).
+ *
+ * A plugin is loaded at most once. Plugins are never unloaded.
+ *
+ * \warning
+ * The global mutex is held while the plugin gets loaded so the
+ * constructors of the plugin (and of the libraries it depends on) run
+ * under that lock. The mutex is recursive so the plugin can call
+ * register_validator() and other advgetopt functions from its own
+ * thread, but a plugin constructor must not wait on another thread
+ * which uses advgetopt or it will deadlock.
+ *
+ * \param[in] name  The name of the validator.
+ *
+ * \return true if a factory named \p name is now registered.
+ */
+bool validator::load_plugin(std::string const & name)
+{
+    cppthread::guard lock(get_global_mutex());
+
+    if(g_validator_factories != nullptr
+    && g_validator_factories->find(name) != g_validator_factories->end())
+    {
+        return true;
+    }
+
+    // only accept simple names so a definition can't be used to load
+    // a file from anywhere
+    //
+    if(name.empty()
+    || name.find_first_not_of("abcdefghijklmnopqrstuvwxyz0123456789_") != std::string::npos)
+    {
+        return false;
+    }
+
+    if(g_plugins_tried == nullptr)
+    {
+        g_plugins_tried = new std::set<std::string>();
+    }
+    if(!g_plugins_tried->insert(name).second)
+    {
+        return false;
+    }
+
+    string_list_t paths;
+    split_string(get_plugins_path(), paths, {":"});
+    for(auto const & p : paths)
+    {
+        std::string const filename(p + "/validator_" + name + ".so");
+        if(access(filename.c_str(), R_OK) != 0)
+        {
+            continue;
+        }
+
+        void * h(dlopen(filename.c_str(), RTLD_NOW | RTLD_LOCAL));
+        if(h == nullptr)
+        {
+            cppthread::log << cppthread::log_level_t::error
+                           << "validator plugin \""
+                           << filename
+                           << "\" could not be loaded: "
+                           << dlerror()
+                           << cppthread::end;
+            return false;
+        }
+
+        if(g_validator_factories != nullptr
+        && g_validator_factories->find(name) != g_validator_factories->end())
+        {
+            return true;
+        }
+
+        cppthread::log << cppthread::log_level_t::error
+                       << "validator plugin \""
+                       << filename
+                       << "\" did not register a validator named \""
+                       << name
+                       << "\"."
+                       << cppthread::end;
+        return false;
+    }
+
+    return false;
 }
 
 
@@ -47,6 +47,34 @@ namespace advgetopt
 
 class validator;
 
+
+enum class validation_error_t
+{
+    VALIDATION_ERROR_NONE,
+    VALIDATION_ERROR_INVALID,           // value does not have a valid format
+    VALIDATION_ERROR_OUT_OF_RANGE,      // value is not in the allowed ranges
+    VALIDATION_ERROR_NO_MATCH,          // value does not match the keywords, regex...
+};
+
+
+class validation_result
+{
+public:
+    bool                        is_valid() const;
+    validation_error_t          get_code() const;
+    std::string                 get_message() const;
+
+    void                        set_error(validation_error_t code, char const * message);
+    void                        set_error(validation_error_t code, std::string const & message);
+    void                        clear();
+
+private:
+    validation_error_t          f_code = validation_error_t::VALIDATION_ERROR_NONE;
+    char const *                f_static_message = nullptr;
+    std::string                 f_message = std::string();
+};
+
+
 class validator_factory
 {
 public:
@@ -62,14 +90,21 @@ class validator
 {
 public:
     typedef std::shared_ptr<validator>      pointer_t;
+    typedef std::shared_ptr<validator const>
+                                            const_pointer_t;
     typedef std::vector<pointer_t>          vector_t;
+    typedef std::vector<std::size_t>        index_list_t;
 
     virtual                     ~validator();
 
     // virtuals
     //
     virtual std::string         name() const = 0;
-    virtual bool                validate(std::string const & value) const = 0;
+    virtual bool                validate(std::string const & value) const;
+    virtual bool                validate_with_result(std::string const & value, validation_result & result) const;
+    virtual bool                validate_batch(
+                                      string_list_t const & values
+                                    , index_list_t & invalid) const;
 
     void                        set_error(std::string const & msg) const;
     std::string const &         get_error() const;
@@ -77,9 +112,11 @@ public:
     static void                 register_validator(validator_factory const & factory);
     static pointer_t            create(std::string const & name, string_list_t const & data);
     static pointer_t            create(std::string const & name_and_params);
+    static const_pointer_t      get_shared(std::string const & name_and_params);
 
-private:
-    mutable std::string         f_error = std::string("<error undefined>");
+    static void                 set_plugins_path(std::string const & path);
+    static std::string          get_plugins_path();
+    static bool                 load_plugin(std::string const & name);
 };
 
 
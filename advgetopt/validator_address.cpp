@@ -0,0 +1,554 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+/** \file
+ * \brief Implementation of the network address validator.
+ *
+ * This validator is used to verify that a parameter represents a valid
+ * IPv4 or IPv6 address. The address may be followed by a port or a
+ * CIDR mask depending on the parameters of the validator.
+ *
+ * The supported formats are:
+ *
+ * \li a.b.c.d -- an IPv4 address
+ * \li a.b.c.d:port -- an IPv4 address and a port
+ * \li a.b.c.d/mask -- an IPv4 network (the mask is a number from 0 to 32)
+ * \li x:x::x -- an IPv6 address
+ * \li x:x::x/mask -- an IPv6 network (the mask is a number from 0 to 128)
+ * \li [x:x::x] -- an IPv6 address between square brackets
+ * \li [x:x::x]:port -- an IPv6 address and a port
+ *
+ * The address is converted to a binary form (see
+ * validator_address::address_t). The option_info object keeps that
+ * binary form (see option_info::get_address()) so the value does not
+ * need to be parsed again each time it gets used.
+ */
+
+// self
+//
+#include    "advgetopt/validator_address.h"
+
+
+// cppthread
+//
+#include    <cppthread/log.h>
+
+
+// snapdev
+//
+#include    <snapdev/trim_string.h>
+
+
+// C++
+//
+#include    <charconv>
+#include    <cstring>
+
+
+// C
+//
+#include    <arpa/inet.h>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+
+namespace advgetopt
+{
+
+
+
+namespace
+{
+
+
+
+class validator_address_factory
+    : public validator_factory
+{
+public:
+    validator_address_factory()
+    {
+        validator::register_validator(*this);
+    }
+
+    virtual std::string get_name() const override
+    {
+        return std::string("address");
+    }
+
+    virtual std::shared_ptr<validator> create(string_list_t const & data) const override
+    {
+        return std::make_shared<validator_address>(data);
+    }
+};
+
+validator_address_factory       g_validator_address_factory;
+
+
+
+/** \brief Convert a decimal number.
+ *
+ * This function converts a port or a mask. The number must be composed
+ * of 1 to 5 digits and be at most \p maximum.
+ *
+ * \param[in] s  The string to convert.
+ * \param[in] maximum  The largest acceptable value.
+ * \param[out] result  The resulting number.
+ *
+ * \return true if \p s is a valid number.
+ */
+bool convert_number(std::string_view s, int maximum, int & result)
+{
+    if(s.empty()
+    || s.length() > 5)
+    {
+        return false;
+    }
+
+    int number(0);
+    std::from_chars_result const r(std::from_chars(s.data(), s.data() + s.length(), number));
+    if(r.ec != std::errc()
+    || r.ptr != s.data() + s.length()
+    || number < 0
+    || number > maximum)
+    {
+        return false;
+    }
+
+    result = number;
+    return true;
+}
+
+
+/** \brief Convert an address with inet_pton().
+ *
+ * The inet_pton() function expects a null terminated string so the
+ * address gets copied in a small buffer first.
+ *
+ * \param[in] family  The family (AF_INET or AF_INET6).
+ * \param[in] s  The address to convert.
+ * \param[out] address  The binary address, IPv4 addresses are mapped.
+ *
+ * \return true if the address is valid.
+ */
+bool convert_address(int family, std::string_view s, validator_address::address_t & address)
+{
+    char buf[INET6_ADDRSTRLEN + 1];
+    if(s.empty()
+    || s.length() >= sizeof(buf))
+    {
+        return false;
+    }
+    std::memcpy(buf, s.data(), s.length());
+    buf[s.length()] = '\0';
+
+    if(family == AF_INET)
+    {
+        address.f_address = {};
+        address.f_address[10] = 0xFF;
+        address.f_address[11] = 0xFF;
+        return inet_pton(AF_INET, buf, address.f_address.data() + 12) == 1;
+    }
+
+    return inet_pton(AF_INET6, buf, address.f_address.data()) == 1;
+}
+
+
+/** \brief Get one bit of an address.
+ *
+ * \param[in] address  The address to read.
+ * \param[in] bit  The bit to read, 0 being the most significant bit.
+ *
+ * \return 0 or 1.
+ */
+int address_bit(validator_address::address_t const & address, int bit)
+{
+    return (address.f_address[bit >> 3] >> (7 - (bit & 7))) & 1;
+}
+
+
+
+} // no name namespace
+
+
+
+
+/** \brief Check whether this address is an IPv4 address.
+ *
+ * IPv4 addresses are saved as IPv4 mapped IPv6 addresses (::ffff:a.b.c.d).
+ * This function returns true when the address uses that format.
+ *
+ * \return true if the address represents an IPv4 address.
+ */
+bool network_address_t::is_ipv4() const
+{
+    static constexpr std::uint8_t const g_ipv4_prefix[12] = {
+            0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF
+        };
+    return std::memcmp(f_address.data(), g_ipv4_prefix, sizeof(g_ipv4_prefix)) == 0;
+}
+
+
+/** \brief Check whether a port was specified with this address.
+ *
+ * \return true if the address was followed by a port.
+ */
+bool network_address_t::has_port() const
+{
+    return f_port >= 0;
+}
+
+
+/** \brief Check whether a CIDR mask was specified with this address.
+ *
+ * \return true if the prefix is not the full address.
+ */
+bool network_address_t::is_cidr() const
+{
+    return f_prefix != 128;
+}
+
+
+
+
+/** \brief Initialize the address validator.
+ *
+ * The constructor accepts a list of parameters. The following keywords
+ * are supported:
+ *
+ * \li ipv4 -- accept IPv4 addresses
+ * \li ipv6 -- accept IPv6 addresses
+ * \li port -- a port is required
+ * \li noport -- a port is not allowed
+ * \li cidr -- a CIDR mask is allowed
+ *
+ * When neither "ipv4" nor "ipv6" is specified, both are accepted. By
+ * default, the port is optional and a CIDR mask is not allowed.
+ *
+ * Any other parameter is viewed as a network (an address with an optional
+ * CIDR mask). When at least one network is defined, the values must be
+ * included in one of these networks. The networks are saved in a binary
+ * prefix trie so checking an address costs at most 128 steps whatever
+ * the number of networks.
+ *
+ * \code
+ *     address(ipv4, port, 10.0.0.0/8, 192.168.0.0/16)
+ * \endcode
+ *
+ * \param[in] data  The list of parameters.
+ */
+validator_address::validator_address(string_list_t const & data)
+{
+    flag_t families(0);
+    for(auto const & p : data)
+    {
+        std::string const param(snapdev::trim_string(p));
+        if(param == "ipv4")
+        {
+            families |= VALIDATOR_ADDRESS_IPV4;
+        }
+        else if(param == "ipv6")
+        {
+            families |= VALIDATOR_ADDRESS_IPV6;
+        }
+        else if(param == "port")
+        {
+            f_flags |= VALIDATOR_ADDRESS_PORT_REQUIRED;
+        }
+        else if(param == "noport")
+        {
+            f_flags |= VALIDATOR_ADDRESS_PORT_FORBIDDEN;
+        }
+        else if(param == "cidr")
+        {
+            f_flags |= VALIDATOR_ADDRESS_CIDR;
+        }
+        else
+        {
+            address_t network;
+            if(!convert_string(param, network)
+            || network.has_port())
+            {
+                cppthread::log << cppthread::log_level_t::error
+                               << "\""
+                               << param
+                               << "\" is not a valid network for the address validator;"
+                                  " it must be an IP address with an optional CIDR mask."
+                               << cppthread::end;
+                continue;
+            }
+            add_network(network);
+        }
+    }
+
+    if(families != 0)
+    {
+        f_flags = (f_flags & ~VALIDATOR_ADDRESS_DEFAULT_FLAGS) | families;
+    }
+
+    if((f_flags & VALIDATOR_ADDRESS_PORT_REQUIRED) != 0
+    && (f_flags & VALIDATOR_ADDRESS_PORT_FORBIDDEN) != 0)
+    {
+        cppthread::log << cppthread::log_level_t::error
+                       << "the address validator cannot at the same time require and forbid a port."
+                       << cppthread::end;
+        f_flags &= ~(VALIDATOR_ADDRESS_PORT_REQUIRED | VALIDATOR_ADDRESS_PORT_FORBIDDEN);
+    }
+}
+
+
+/** \brief Return the name of this validator.
+ *
+ * This function returns "address".
+ *
+ * \return "address".
+ */
+std::string validator_address::name() const
+{
+    return std::string("address");
+}
+
+
+/** \brief Determine whether value is a valid address.
+ *
+ * This function converts the value to a binary address and then checks
+ * it against the parameters of this validator: the family, the port,
+ * the CIDR mask, and the list of allowed networks.
+ *
+ * \param[in] value  The value to validate.
+ * \param[out] result  The error when \p value is not valid.
+ *
+ * \return true if the value validates.
+ */
+bool validator_address::validate_with_result(std::string const & value, validation_result & result) const
+{
+    address_t address;
+    if(!convert_string(value, address))
+    {
+        result.set_error(validation_error_t::VALIDATION_ERROR_INVALID, "not a valid IP address.");
+        return false;
+    }
+
+    if((f_flags & (address.is_ipv4() ? VALIDATOR_ADDRESS_IPV4 : VALIDATOR_ADDRESS_IPV6)) == 0)
+    {
+        result.set_error(
+                  validation_error_t::VALIDATION_ERROR_NO_MATCH
+                , address.is_ipv4()
+                    ? "IPv4 addresses are not allowed."
+                    : "IPv6 addresses are not allowed.");
+        return false;
+    }
+
+    if(address.has_port())
+    {
+        if((f_flags & VALIDATOR_ADDRESS_PORT_FORBIDDEN) != 0)
+        {
+            result.set_error(validation_error_t::VALIDATION_ERROR_INVALID, "a port is not allowed.");
+            return false;
+        }
+    }
+    else if((f_flags & VALIDATOR_ADDRESS_PORT_REQUIRED) != 0)
+    {
+        result.set_error(validation_error_t::VALIDATION_ERROR_INVALID, "a port is required.");
+        return false;
+    }
+
+    if(address.is_cidr()
+    && (f_flags & VALIDATOR_ADDRESS_CIDR) == 0)
+    {
+        result.set_error(validation_error_t::VALIDATION_ERROR_INVALID, "a CIDR mask is not allowed.");
+        return false;
+    }
+
+    if(!is_allowed(address))
+    {
+        result.set_error(validation_error_t::VALIDATION_ERROR_OUT_OF_RANGE, "address is not in the allowed networks.");
+        return false;
+    }
+
+    return true;
+}
+
+
+/** \brief Check whether an address is part of the allowed networks.
+ *
+ * This function walks the prefix trie built from the list of networks.
+ * The walk stops as soon as a network including \p address is found.
+ * When \p address is itself a network, it has to be fully included in
+ * one of the allowed networks.
+ *
+ * If no networks were specified, then all the addresses are allowed.
+ *
+ * \param[in] address  The address to check.
+ *
+ * \return true if \p address is included in one of the allowed networks.
+ */
+bool validator_address::is_allowed(address_t const & address) const
+{
+    if(f_allowed_networks.empty())
+    {
+        return true;
+    }
+
+    std::int32_t node(0);
+    for(int bit(0);; ++bit)
+    {
+        if(f_allowed_networks[node].f_match)
+        {
+            return true;
+        }
+        if(bit >= address.f_prefix)
+        {
+            return false;
+        }
+        node = f_allowed_networks[node].f_child[address_bit(address, bit)];
+        if(node < 0)
+        {
+            return false;
+        }
+    }
+}
+
+
+/** \brief Add a network to the prefix trie.
+ *
+ * The first f_prefix bits of \p network are added to the trie and the
+ * last node is marked as a match.
+ *
+ * \param[in] network  The network to add.
+ */
+void validator_address::add_network(address_t const & network)
+{
+    if(f_allowed_networks.empty())
+    {
+        f_allowed_networks.emplace_back();
+    }
+
+    std::int32_t node(0);
+    for(int bit(0); bit < network.f_prefix; ++bit)
+    {
+        int const b(address_bit(network, bit));
+        std::int32_t next(f_allowed_networks[node].f_child[b]);
+        if(next < 0)
+        {
+            next = static_cast<std::int32_t>(f_allowed_networks.size());
+            f_allowed_networks.emplace_back();
+            f_allowed_networks[node].f_child[b] = next;
+        }
+        node = next;
+    }
+    f_allowed_networks[node].f_match = true;
+}
+
+
+/** \brief Convert a string to a binary address.
+ *
+ * This function converts the specified string to a binary address.
+ * See the top of this file for the supported formats.
+ *
+ * IPv4 addresses are saved as IPv4 mapped IPv6 addresses and their
+ * mask is increased by 96.
+ *
+ * \param[in] address  The address to convert.
+ * \param[out] result  The resulting binary address.
+ *
+ * \return true if the conversion succeeded.
+ */
+bool validator_address::convert_string(std::string_view address, address_t & result)
+{
+    address_t a;
+
+    if(!address.empty()
+    && address[0] == '[')
+    {
+        std::string_view::size_type const end(address.find(']'));
+        if(end == std::string_view::npos
+        || !convert_address(AF_INET6, address.substr(1, end - 1), a))
+        {
+            return false;
+        }
+        if(end + 1 != address.length())
+        {
+            if(address[end + 1] != ':'
+            || !convert_number(address.substr(end + 2), 65535, a.f_port))
+            {
+                return false;
+            }
+        }
+        result = a;
+        return true;
+    }
+
+    std::string_view::size_type const slash(address.find('/'));
+    std::string_view const ip(address.substr(0, slash));
+    std::string_view::size_type const colon(ip.find(':'));
+    if(colon == std::string_view::npos
+    || (ip.find('.') != std::string_view::npos && ip.find(':', colon + 1) == std::string_view::npos))
+    {
+        // IPv4, with a port or a mask
+        //
+        if(!convert_address(AF_INET, ip.substr(0, colon), a))
+        {
+            return false;
+        }
+        if(colon != std::string_view::npos)
+        {
+            if(slash != std::string_view::npos
+            || !convert_number(ip.substr(colon + 1), 65535, a.f_port))
+            {
+                return false;
+            }
+        }
+        else if(slash != std::string_view::npos)
+        {
+            if(!convert_number(address.substr(slash + 1), 32, a.f_prefix))
+            {
+                return false;
+            }
+            a.f_prefix += 96;
+        }
+    }
+    else
+    {
+        // IPv6, with a mask
+        //
+        if(!convert_address(AF_INET6, ip, a))
+        {
+            return false;
+        }
+        if(slash != std::string_view::npos
+        && !convert_number(address.substr(slash + 1), 128, a.f_prefix))
+        {
+            return false;
+        }
+    }
+
+    result = a;
+    return true;
+}
+
+
+
+} // namespace advgetopt
+// vim: ts=4 sw=4 et
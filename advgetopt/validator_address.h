@@ -0,0 +1,110 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#pragma once
+
+/** \file
+ * \brief Declaration of the network address validator.
+ *
+ * The address validator verifies IPv4 and IPv6 addresses with an optional
+ * port or CIDR mask. It can also limit the addresses to a list of
+ * networks (an allow-list).
+ */
+
+// advgetopt
+//
+#include    <advgetopt/validator.h>
+
+
+// C++
+//
+#include    <array>
+#include    <cstdint>
+#include    <string_view>
+#include    <vector>
+
+
+
+namespace advgetopt
+{
+
+
+
+struct network_address_t
+{
+    // IPv4 addresses are saved as IPv4 mapped IPv6 addresses
+    // (::ffff:a.b.c.d) with a prefix of 96 + mask
+    //
+    std::array<std::uint8_t, 16>
+                            f_address = {};
+    int                     f_prefix = 128;
+    int                     f_port = -1;
+
+    bool                    is_ipv4() const;
+    bool                    has_port() const;
+    bool                    is_cidr() const;
+};
+
+
+class validator_address
+    : public validator
+{
+public:
+    typedef std::uint32_t       flag_t;
+    typedef network_address_t   address_t;
+
+    static constexpr flag_t     VALIDATOR_ADDRESS_IPV4          = 0x01;
+    static constexpr flag_t     VALIDATOR_ADDRESS_IPV6          = 0x02;
+    static constexpr flag_t     VALIDATOR_ADDRESS_PORT_REQUIRED = 0x04;
+    static constexpr flag_t     VALIDATOR_ADDRESS_PORT_FORBIDDEN= 0x08;
+    static constexpr flag_t     VALIDATOR_ADDRESS_CIDR          = 0x10;
+
+    static constexpr flag_t     VALIDATOR_ADDRESS_DEFAULT_FLAGS = VALIDATOR_ADDRESS_IPV4
+                                                                | VALIDATOR_ADDRESS_IPV6;
+
+                                validator_address(string_list_t const & data);
+
+    // validator implementation
+    //
+    virtual std::string         name() const override;
+    using validator::validate;
+    virtual bool                validate_with_result(std::string const & value, validation_result & result) const override;
+
+    bool                        is_allowed(address_t const & address) const;
+
+    static bool                 convert_string(std::string_view address
+                                             , address_t & result);
+
+private:
+    struct node_t
+    {
+        std::int32_t            f_child[2] = { -1, -1 };
+        bool                    f_match = false;
+    };
+    typedef std::vector<node_t> trie_t;
+
+    void                        add_network(address_t const & network);
+
+    flag_t                      f_flags = VALIDATOR_ADDRESS_DEFAULT_FLAGS;
+    trie_t                      f_allowed_networks = trie_t();
+};
+
+
+
+}   // namespace advgetopt
+// vim: ts=4 sw=4 et
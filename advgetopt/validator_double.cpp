@@ -28,6 +28,8 @@
 //
 #include    "advgetopt/validator_double.h"
 
+#include    "advgetopt/validator_ranges.h"
+
 
 // cppthread
 //
@@ -39,6 +41,12 @@
 #include    <snapdev/trim_string.h>
 
 
+// C++
+//
+#include    <charconv>
+#include    <cmath>
+
+
 // last include
 //
 #include    <snapdev/poison.h>
@@ -193,6 +201,8 @@ validator_double::validator_double(string_list_t const & range_list)
         }
         f_allowed_values.push_back(range);
     }
+
+    normalize_ranges(f_allowed_values);
 }
 
 
@@ -222,33 +232,74 @@ std::string validator_double::name() const
  * value is within at least one of the ranges.
  *
  * \param[in] value  The value to validate.
+ * \param[out] result  The error when \p value is not valid.
  *
  * \return true if the value validates.
  */
-bool validator_double::validate(std::string const & value) const
+bool validator_double::validate_with_result(std::string const & value, validation_result & result) const
 {
-    double result(0.0);
-    if(convert_string(value, result))
+    double number(0.0);
+    if(convert_string(value, number))
     {
-        if(f_allowed_values.empty())
+        if(in_range(number))
         {
             return true;
         }
+        result.set_error(validation_error_t::VALIDATION_ERROR_OUT_OF_RANGE, "out of range.");
+        return false;
+    }
+
+    result.set_error(validation_error_t::VALIDATION_ERROR_INVALID, "not a valid floating point number.");
+    return false;
+}
+
 
-        for(auto f : f_allowed_values)
+/** \brief Validate a list of doubles.
+ *
+ * This function validates all the \p values at once. It avoids the
+ * virtual call and the error message of each validate() call.
+ *
+ * Contrary to validate(), this function does not set an error message.
+ *
+ * \param[in] values  The list of values to validate.
+ * \param[out] invalid  The indexes of the values that did not validate.
+ *
+ * \return true if all the values validate.
+ */
+bool validator_double::validate_batch(
+      string_list_t const & values
+    , index_list_t & invalid) const
+{
+    invalid.clear();
+    for(std::size_t idx(0); idx < values.size(); ++idx)
+    {
+        double result(0.0);
+        if(!convert_string(values[idx], result)
+        || !in_range(result))
         {
-            if(result >= f.f_minimum
-            && result <= f.f_maximum)
-            {
-                return true;
-            }
+            invalid.push_back(idx);
         }
-        set_error("out of range.");
-        return false;
     }
 
-    set_error("not a valid floating point number.");
-    return false;
+    return invalid.empty();
+}
+
+
+/** \brief Check whether a value is in one of the ranges.
+ *
+ * \param[in] value  The value to check.
+ *
+ * \return true if there are no ranges or \p value is in at least one
+ * of them.
+ */
+bool validator_double::in_range(double value) const
+{
+    if(f_allowed_values.empty())
+    {
+        return true;
+    }
+
+    return find_range(f_allowed_values, value);
 }
 
 
@@ -257,9 +308,14 @@ bool validator_double::validate(std::string const & value) const
  * This function is used to convert a string to a double with full
  * boundary verification.
  *
- * \todo
- * This function calls std::strtod() which interprets the decimal separator
- * depending on the current locale. We really want to only accept periods.
+ * The function works on a view of the value so it can be used on part
+ * of a string without a copy. The conversion uses std::from_chars()
+ * which is correctly rounded, does not allocate, and does not depend
+ * on the current locale (i.e. the decimal separator is always a
+ * period).
+ *
+ * The forms std::from_chars() does not support (i.e. hexadecimal
+ * numbers, "inf", "nan") are converted with std::strtod() as before.
  *
  * \warning
  * There is no range checks in this function since it does not have access
@@ -270,27 +326,57 @@ bool validator_double::validate(std::string const & value) const
  *
  * \return true if the conversion succeeded.
  */
-bool validator_double::convert_string(std::string const & value, double & result)
+bool validator_double::convert_string(std::string_view value, double & result)
 {
-    char const * start(value.c_str());
-
     // do not allow spaces before the number
     //
-    if(start[0] != '+'
-    && start[0] != '-'
-    && (start[0] < '0' || start[0] > '9'))
+    if(value.empty()
+    || (value[0] != '+'
+        && value[0] != '-'
+        && (value[0] < '0' || value[0] > '9')))
     {
         return false;
     }
 
-    char * end(nullptr);
+    // std::from_chars() does not accept a '+'
+    //
+    char const * s(value.data());
+    char const * const end(s + value.length());
+    if(*s == '+')
+    {
+        ++s;
+        if(s == end
+        || *s == '-')
+        {
+            return false;
+        }
+    }
+
+    std::from_chars_result const r(std::from_chars(s, end, result));
+    if(r.ec == std::errc()
+    && r.ptr == end)
+    {
+        // like std::strtod(), consider subnormal numbers as an underflow
+        //
+        return std::fpclassify(result) != FP_SUBNORMAL;
+    }
+    if(r.ec == std::errc::result_out_of_range)
+    {
+        return false;
+    }
+
+    // forms not supported by std::from_chars() need a null terminated
+    // string for std::strtod()
+    //
+    std::string const number(value);
+    char * number_end(nullptr);
     errno = 0;
-    result = std::strtod(start, &end);
+    result = std::strtod(number.c_str(), &number_end);
 
     // do not allow anything after the last digit
     // also return false on an overflow
     //
-    return end == start + value.length()
+    return number_end == number.c_str() + number.length()
         && errno != ERANGE;
 }
 
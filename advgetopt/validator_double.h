@@ -37,6 +37,7 @@
 // C++
 //
 #include    <limits>
+#include    <string_view>
 
 
 
@@ -49,7 +50,7 @@ class validator_double
     : public validator
 {
 public:
-    typedef bool (*to_double_t)(std::string const & number
+    typedef bool (*to_double_t)(std::string_view number
                                , double & result);
 
                                 validator_double(string_list_t const & data);
@@ -57,9 +58,13 @@ public:
     // validator implementation
     //
     virtual std::string         name() const override;
-    virtual bool                validate(std::string const & value) const override;
+    using validator::validate;
+    virtual bool                validate_with_result(std::string const & value, validation_result & result) const override;
+    virtual bool                validate_batch(
+                                      string_list_t const & values
+                                    , index_list_t & invalid) const override;
 
-    static bool                 convert_string(std::string const & number
+    static bool                 convert_string(std::string_view number
                                              , double & result);
 
 private:
@@ -71,6 +76,8 @@ private:
         double            f_maximum = std::numeric_limits<double>::max();
     };
 
+    bool                        in_range(double value) const;
+
     range_t::vector_t           f_allowed_values = range_t::vector_t();
 };
 
@@ -33,6 +33,7 @@
 #include    "advgetopt/validator_duration.h"
 
 #include    "advgetopt/validator_double.h"
+#include    "advgetopt/validator_ranges.h"
 
 
 // cppthread
@@ -219,6 +220,8 @@ validator_duration::validator_duration(string_list_t const & flag_list)
             f_allowed_values.push_back(range);
         }
     }
+
+    normalize_ranges(f_allowed_values);
 }
 
 
@@ -243,15 +246,16 @@ std::string validator_duration::name() const
  * measurement suffix.
  *
  * \param[in] value  The value to validate.
+ * \param[out] result  The error when \p value is not valid.
  *
  * \return true if the value validates.
  */
-bool validator_duration::validate(std::string const & value) const
+bool validator_duration::validate_with_result(std::string const & value, validation_result & result) const
 {
-    double result(0);
-    if(!convert_string(value, f_flags, result))
+    double duration(0);
+    if(!convert_string(value, f_flags, duration))
     {
-        set_error("not a valid duration.");
+        result.set_error(validation_error_t::VALIDATION_ERROR_INVALID, "not a valid duration.");
         return false;
     }
 
@@ -260,16 +264,12 @@ bool validator_duration::validate(std::string const & value) const
         return true;
     }
 
-    for(auto f : f_allowed_values)
+    if(find_range(f_allowed_values, duration))
     {
-        if(result >= f.f_minimum
-        && result <= f.f_maximum)
-        {
-            return true;
-        }
+        return true;
     }
 
-    set_error("out of range.");
+    result.set_error(validation_error_t::VALIDATION_ERROR_OUT_OF_RANGE, "out of range.");
     return false;
 }
 
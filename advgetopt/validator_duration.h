@@ -60,7 +60,8 @@ public:
     // validator implementation
     //
     virtual std::string         name() const override;
-    virtual bool                validate(std::string const & value) const override;
+    using validator::validate;
+    virtual bool                validate_with_result(std::string const & value, validation_result & result) const override;
 
     static bool                 convert_string(std::string const & duration
                                              , flag_t flags
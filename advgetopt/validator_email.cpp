@@ -21,6 +21,12 @@
  * \brief Implementation of the email validator.
  *
  * The email validator allows us to check the input as an email address.
+ *
+ * This validator depends on libtld. To avoid loading that library in
+ * all the tools using advgetopt, it is compiled as a plugin which
+ * validator::create() loads the first time an "email" validator is
+ * requested. The domain cache lives in the main library (see
+ * validator_email_cache.cpp).
  */
 
 // self
@@ -37,7 +43,6 @@
 //
 #include    <libtld/tld.h>
 
-
 // last include
 //
 #include    <snapdev/poison.h>
@@ -79,6 +84,101 @@ validator_email_factory         g_validator_email_factory;
 
 
 
+/** \brief Check whether the local part of an address is a simple atom.
+ *
+ * The fast path only applies to local parts composed of letters, digits,
+ * underscores, plus and minus signs, and dots (not at the start, at
+ * the end, or repeated). Anything else, such as quoted strings or
+ * comments, goes through the full libtld parser.
+ *
+ * \param[in] local  The part before the '@'.
+ *
+ * \return true if \p local is a simple atom.
+ */
+bool is_simple_local_part(std::string_view local)
+{
+    if(local.empty()
+    || local.length() > 64
+    || local.front() == '.'
+    || local.back() == '.')
+    {
+        return false;
+    }
+
+    char previous('\0');
+    for(char const c : local)
+    {
+        if(c == '.')
+        {
+            if(previous == '.')
+            {
+                return false;
+            }
+        }
+        else if((c < 'a' || c > 'z')
+             && (c < 'A' || c > 'Z')
+             && (c < '0' || c > '9')
+             && c != '_'
+             && c != '+'
+             && c != '-')
+        {
+            return false;
+        }
+        previous = c;
+    }
+
+    return true;
+}
+
+
+/** \brief Check whether a domain only uses the usual characters.
+ *
+ * \param[in] domain  The part after the '@'.
+ *
+ * \return true if \p domain only includes letters, digits, dashes,
+ * and dots.
+ */
+bool is_simple_domain(std::string_view domain)
+{
+    if(domain.empty())
+    {
+        return false;
+    }
+
+    for(char const c : domain)
+    {
+        if((c < 'a' || c > 'z')
+        && (c < 'A' || c > 'Z')
+        && (c < '0' || c > '9')
+        && c != '-'
+        && c != '.')
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+/** \brief Verify a domain with libtld.
+ *
+ * The local part of an address does not change the verdict of the
+ * domain so we verify the domain with a local part known to be valid.
+ *
+ * \param[in] domain  The domain to verify.
+ *
+ * \return true if libtld accepts the domain.
+ */
+bool check_domain(std::string const & domain)
+{
+    tld_email_list list;
+    return list.parse("a@" + domain, 0) == TLD_RESULT_SUCCESS
+        && list.count() == 1;
+}
+
+
+
 } // no name namespace
 
 
@@ -137,15 +237,114 @@ std::string validator_email::name() const
  * This function is used to verify the value for a valid email.
  *
  * \param[in] value  The value to be validated.
+ * \param[out] result  The error when \p value is not valid.
  *
  * \return true on a match.
  */
-bool validator_email::validate(std::string const & value) const
+bool validator_email::validate_with_result(std::string const & value, validation_result & result) const
+{
+    return check(value, result);
+}
+
+
+/** \brief Validate a list of emails.
+ *
+ * This function validates all the \p values at once. Addresses sharing
+ * the same domain as the previous value do not even need to search the
+ * domain cache.
+ *
+ * Contrary to validate(), this function does not set an error message.
+ *
+ * \param[in] values  The list of values to validate.
+ * \param[out] invalid  The indexes of the values that did not validate.
+ *
+ * \return true if all the values validate.
+ */
+bool validator_email::validate_batch(
+      string_list_t const & values
+    , index_list_t & invalid) const
+{
+    invalid.clear();
+    validation_result result;
+    std::string_view last_domain;
+    for(std::size_t idx(0); idx < values.size(); ++idx)
+    {
+        std::string const & v(values[idx]);
+        std::string::size_type const pos(v.find('@'));
+        if(!last_domain.empty()
+        && pos != std::string::npos
+        && std::string_view(v).substr(pos + 1) == last_domain
+        && is_simple_local_part(std::string_view(v).substr(0, pos)))
+        {
+            // same simple domain as a previous valid address
+            //
+            continue;
+        }
+
+        if(!check(v, result))
+        {
+            invalid.push_back(idx);
+            continue;
+        }
+
+        if(pos != std::string::npos
+        && v.find('@', pos + 1) == std::string::npos
+        && is_simple_domain(std::string_view(v).substr(pos + 1)))
+        {
+            last_domain = std::string_view(v).substr(pos + 1);
+        }
+    }
+
+    return invalid.empty();
+}
+
+
+/** \brief Check one value.
+ *
+ * When the value is one simple address (a local part without quotes or
+ * comments, an '@', and a domain name) the verdict of the domain is
+ * searched in the domain cache. Only new domains get verified by libtld.
+ *
+ * Other values go through the full libtld parser.
+ *
+ * \param[in] value  The value to check.
+ * \param[out] result  The error when the function returns false.
+ *
+ * \return true if \p value is valid.
+ */
+bool validator_email::check(std::string const & value, validation_result & result) const
 {
+    std::string::size_type const pos(value.find('@'));
+    if(pos != std::string::npos
+    && value.find('@', pos + 1) == std::string::npos)
+    {
+        std::string_view const v(value);
+        if(is_simple_local_part(v.substr(0, pos))
+        && is_simple_domain(v.substr(pos + 1)))
+        {
+            std::string const domain(value.substr(pos + 1));
+            int verdict(find_cached_domain(domain));
+            if(verdict == DOMAIN_UNKNOWN)
+            {
+                bool const valid(check_domain(domain));
+                verdict = valid ? DOMAIN_VALID : DOMAIN_INVALID;
+                cache_domain(domain, valid);
+            }
+            if(verdict == DOMAIN_VALID)
+            {
+                // one address is valid in single and multiple modes
+                //
+                return true;
+            }
+            result.set_error(validation_error_t::VALIDATION_ERROR_INVALID, "invalid list of emails.");
+            return false;
+        }
+    }
+
     tld_email_list list;
     if(list.parse(value, 0) != TLD_RESULT_SUCCESS)
     {
-        set_error("invalid list of emails.");
+        result.set_error(validation_error_t::VALIDATION_ERROR_INVALID, "invalid list of emails.");
         return false;
     }
 
@@ -155,7 +354,7 @@ bool validator_email::validate(std::string const & value) const
         {
             return true;
         }
-        set_error("at least one email address is required.");
+        result.set_error(validation_error_t::VALIDATION_ERROR_OUT_OF_RANGE, "at least one email address is required.");
         return false;
     }
 
@@ -163,7 +362,7 @@ bool validator_email::validate(std::string const & value) const
     {
         return true;
     }
-    set_error("exactly one email address is required.");
+    result.set_error(validation_error_t::VALIDATION_ERROR_OUT_OF_RANGE, "exactly one email address is required.");
     return false;
 }
 
@@ -49,9 +49,28 @@ public:
     // validator implementation
     //
     virtual std::string         name() const override;
-    virtual bool                validate(std::string const & value) const override;
+    using validator::validate;
+    virtual bool                validate_with_result(std::string const & value, validation_result & result) const override;
+    virtual bool                validate_batch(
+                                      string_list_t const & values
+                                    , index_list_t & invalid) const override;
+
+    static constexpr std::size_t
+                                DEFAULT_DOMAIN_CACHE_SIZE = 1024;
+
+    static void                 set_domain_cache_size(std::size_t size);
+    static std::size_t          get_cached_domains();
 
 private:
+    static constexpr int        DOMAIN_UNKNOWN = -1;
+    static constexpr int        DOMAIN_INVALID = 0;
+    static constexpr int        DOMAIN_VALID   = 1;
+
+    static int                  find_cached_domain(std::string const & domain);
+    static void                 cache_domain(std::string const & domain, bool valid);
+
+    bool                        check(std::string const & value, validation_result & result) const;
+
     bool                        f_multiple = false;
 };
 
@@ -0,0 +1,234 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+/** \file
+ * \brief Implementation of the email domain cache.
+ *
+ * The email validator is a plugin (it depends on libtld). The cache of
+ * domain verdicts is kept in the main library so the cache can be
+ * configured before the plugin gets loaded and shared by all the
+ * email validators.
+ */
+
+// self
+//
+#include    "advgetopt/validator_email.h"
+
+
+// cppthread
+//
+#include    <cppthread/guard.h>
+#include    <cppthread/mutex.h>
+
+
+// C++
+//
+#include    <list>
+#include    <unordered_map>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+
+namespace advgetopt
+{
+
+
+
+namespace
+{
+
+
+
+/** \brief Cache of the domain verdicts.
+ *
+ * The libtld library verifies the domain name of each email address
+ * which is the expensive part of the validation. Most applications
+ * validate many addresses sharing a small number of domains so we
+ * keep the verdict of the last few domains in an LRU cache.
+ *
+ * The cache is process wide. It has its own mutex so the validators
+ * running in separate threads do not contend on the global mutex.
+ *
+ * Domain names are case insensitive so the keys are saved in lowercase.
+ */
+class domain_cache
+{
+public:
+    bool find(std::string const & domain, bool & valid)
+    {
+        std::string const key(to_key(domain));
+
+        cppthread::guard lock(f_mutex);
+
+        auto it(f_index.find(key));
+        if(it == f_index.end())
+        {
+            return false;
+        }
+
+        // move to the front (most recently used)
+        //
+        f_entries.splice(f_entries.begin(), f_entries, it->second);
+        valid = it->second->second;
+        return true;
+    }
+
+    void insert(std::string const & domain, bool valid)
+    {
+        std::string key(to_key(domain));
+
+        cppthread::guard lock(f_mutex);
+
+        if(f_capacity == 0
+        || f_index.find(key) != f_index.end())
+        {
+            return;
+        }
+
+        f_entries.emplace_front(std::move(key), valid);
+        f_index[f_entries.front().first] = f_entries.begin();
+        trim();
+    }
+
+    void set_capacity(std::size_t capacity)
+    {
+        cppthread::guard lock(f_mutex);
+
+        f_capacity = capacity;
+        trim();
+    }
+
+    std::size_t size()
+    {
+        cppthread::guard lock(f_mutex);
+
+        return f_index.size();
+    }
+
+private:
+    typedef std::list<std::pair<std::string, bool>>     entries_t;
+
+    static std::string to_key(std::string const & domain)
+    {
+        std::string key(domain);
+        for(auto & c : key)
+        {
+            if(c >= 'A' && c <= 'Z')
+            {
+                c = static_cast<char>(c + ('a' - 'A'));
+            }
+        }
+        return key;
+    }
+
+    void trim()
+    {
+        while(f_index.size() > f_capacity)
+        {
+            f_index.erase(f_entries.back().first);
+            f_entries.pop_back();
+        }
+    }
+
+    cppthread::mutex        f_mutex = cppthread::mutex();
+    std::size_t             f_capacity = validator_email::DEFAULT_DOMAIN_CACHE_SIZE;
+    entries_t               f_entries = entries_t();
+    std::unordered_map<std::string, entries_t::iterator>
+                            f_index = std::unordered_map<std::string, entries_t::iterator>();
+};
+
+
+domain_cache & get_domain_cache()
+{
+    // the initialization of a static is thread safe; the cache is never
+    // deleted so validators can still be used while exiting
+    //
+    static domain_cache * g_domain_cache(new domain_cache());
+    return *g_domain_cache;
+}
+
+
+
+}
+// no name namespace
+
+
+
+/** \brief Change the number of domains kept in the cache.
+ *
+ * The email validators share a cache of domain verdicts. This function
+ * changes the maximum number of domains kept in that cache. The least
+ * recently used domains get removed first. Setting the size to zero
+ * clears and turns off the cache.
+ *
+ * \param[in] size  The maximum number of domains to keep.
+ */
+void validator_email::set_domain_cache_size(std::size_t size)
+{
+    get_domain_cache().set_capacity(size);
+}
+
+
+/** \brief Get the number of domains currently cached.
+ *
+ * \return The number of domains in the cache.
+ */
+std::size_t validator_email::get_cached_domains()
+{
+    return get_domain_cache().size();
+}
+
+
+/** \brief Search the verdict of a domain in the cache.
+ *
+ * \param[in] domain  The domain to search.
+ *
+ * \return DOMAIN_VALID or DOMAIN_INVALID if the domain is in the cache,
+ * DOMAIN_UNKNOWN otherwise.
+ */
+int validator_email::find_cached_domain(std::string const & domain)
+{
+    bool valid(false);
+    if(!get_domain_cache().find(domain, valid))
+    {
+        return DOMAIN_UNKNOWN;
+    }
+    return valid ? DOMAIN_VALID : DOMAIN_INVALID;
+}
+
+
+/** \brief Save the verdict of a domain in the cache.
+ *
+ * \param[in] domain  The domain which was verified.
+ * \param[in] valid  Whether libtld accepted the domain.
+ */
+void validator_email::cache_domain(std::string const & domain, bool valid)
+{
+    get_domain_cache().insert(domain, valid);
+}
+
+
+
+} // namespace advgetopt
+// vim: ts=4 sw=4 et
@@ -45,6 +45,8 @@
 //
 #include    "advgetopt/validator_integer.h"
 
+#include    "advgetopt/validator_ranges.h"
+
 
 // cppthread
 //
@@ -56,6 +58,12 @@
 #include    <snapdev/trim_string.h>
 
 
+// C++
+//
+#include    <charconv>
+#include    <cstring>
+
+
 // last include
 //
 #include    <snapdev/poison.h>
@@ -97,6 +105,96 @@ validator_integer_factory       g_validator_integer_factory;
 
 
 
+/** \brief Check whether 8 characters are all decimal digits.
+ *
+ * This function checks the 8 characters loaded in \p chunk at once
+ * (SWAR: SIMD within a register).
+ *
+ * \param[in] chunk  Eight characters.
+ *
+ * \return true if all 8 characters are digits.
+ */
+bool is_eight_digits(std::uint64_t chunk)
+{
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ULL)
+          | (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4))
+                == 0x3333333333333333ULL;
+}
+
+
+/** \brief Convert 8 digits at once.
+ *
+ * This function converts the 8 digits found in \p chunk to an integer
+ * using three multiplications instead of eight. The first digit must
+ * be in the lowest byte.
+ *
+ * \param[in] chunk  Eight digits as verified by is_eight_digits().
+ *
+ * \return The value of the 8 digits.
+ */
+std::uint64_t parse_eight_digits(std::uint64_t chunk)
+{
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32)))
+           + (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return chunk & 0xFFFFFFFFULL;
+}
+
+
+/** \brief Convert a string of decimal digits.
+ *
+ * Numbers of up to 16 digits can't overflow so they are converted 8
+ * digits at a time without overflow checks. Longer numbers are
+ * converted with std::from_chars() which detects overflows.
+ *
+ * \param[in] s  The start of the digits.
+ * \param[in] end  The end of the digits.
+ * \param[out] result  The resulting integer.
+ *
+ * \return true if the string was only composed of digits and did not
+ * overflow.
+ */
+bool convert_decimal(char const * s, char const * end, std::uint64_t & result)
+{
+    std::size_t length(end - s);
+    if(length > 16)
+    {
+        std::from_chars_result const r(std::from_chars(s, end, result));
+        return r.ec == std::errc()
+            && r.ptr == end;
+    }
+
+    std::uint64_t integer(0);
+    for(; length >= 8; s += 8, length -= 8)
+    {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, s, sizeof(chunk));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        chunk = __builtin_bswap64(chunk);
+#endif
+        if(!is_eight_digits(chunk))
+        {
+            return false;
+        }
+        integer = integer * 100'000'000 + parse_eight_digits(chunk);
+    }
+    for(; s < end; ++s)
+    {
+        unsigned char const digit(*s - '0');
+        if(digit > 9)
+        {
+            return false;
+        }
+        integer = integer * 10 + digit;
+    }
+
+    result = integer;
+    return true;
+}
+
+
+
 } // no name namespace
 
 
@@ -150,9 +248,9 @@ validator_integer_factory       g_validator_integer_factory;
  */
 validator_integer::validator_integer(string_list_t const & range_list)
 {
-    range_t range;
     for(auto r : range_list)
     {
+        range_t range;
         std::string::size_type const pos(r.find("..."));
         if(pos == std::string::npos)
         {
@@ -213,6 +311,8 @@ validator_integer::validator_integer(string_list_t const & range_list)
         }
         f_allowed_values.push_back(range);
     }
+
+    normalize_ranges(f_allowed_values);
 }
 
 
@@ -244,33 +344,74 @@ std::string validator_integer::name() const
  * Add support for binary, octal, hexadecimal.
  *
  * \param[in] value  The value to validate.
+ * \param[out] result  The error when \p value is not valid.
  *
  * \return true if the value validates.
  */
-bool validator_integer::validate(std::string const & value) const
+bool validator_integer::validate_with_result(std::string const & value, validation_result & result) const
 {
-    std::int64_t result(0);
-    if(convert_string(value, result))
+    std::int64_t number(0);
+    if(convert_string(value, number))
     {
-        if(f_allowed_values.empty())
+        if(in_range(number))
         {
             return true;
         }
+        result.set_error(validation_error_t::VALIDATION_ERROR_OUT_OF_RANGE, "out of range.");
+        return false;
+    }
+
+    result.set_error(validation_error_t::VALIDATION_ERROR_INVALID, "not a valid number.");
+    return false;
+}
+
 
-        for(auto f : f_allowed_values)
+/** \brief Validate a list of integers.
+ *
+ * This function validates all the \p values at once. It avoids the
+ * virtual call and the error message of each validate() call.
+ *
+ * Contrary to validate(), this function does not set an error message.
+ *
+ * \param[in] values  The list of values to validate.
+ * \param[out] invalid  The indexes of the values that did not validate.
+ *
+ * \return true if all the values validate.
+ */
+bool validator_integer::validate_batch(
+      string_list_t const & values
+    , index_list_t & invalid) const
+{
+    invalid.clear();
+    for(std::size_t idx(0); idx < values.size(); ++idx)
+    {
+        std::int64_t result(0);
+        if(!convert_string(values[idx], result)
+        || !in_range(result))
         {
-            if(result >= f.f_minimum
-            && result <= f.f_maximum)
-            {
-                return true;
-            }
+            invalid.push_back(idx);
         }
-        set_error("out of range.");
-        return false;
     }
 
-    set_error("not a valid number.");
-    return false;
+    return invalid.empty();
+}
+
+
+/** \brief Check whether a value is in one of the ranges.
+ *
+ * \param[in] value  The value to check.
+ *
+ * \return true if there are no ranges or \p value is in at least one
+ * of them.
+ */
+bool validator_integer::in_range(std::int64_t value) const
+{
+    if(f_allowed_values.empty())
+    {
+        return true;
+    }
+
+    return find_range(f_allowed_values, value);
 }
 
 
@@ -279,6 +420,11 @@ bool validator_integer::validate(std::string const & value) const
  * This function is used to convert a string to an integer with full
  * boundary verification.
  *
+ * The function works on a view of the value so it can be used on
+ * part of a string without a copy. Decimal numbers (the vast majority)
+ * are converted 8 digits at a time. The other bases and very long
+ * numbers use std::from_chars().
+ *
  * \warning
  * There is no range checks in this function since it does not have access
  * to the ranges (i.e. it is static).
@@ -288,20 +434,22 @@ bool validator_integer::validate(std::string const & value) const
  *
  * \return true if the conversion succeeded.
  */
-bool validator_integer::convert_string(std::string const & value, std::int64_t & result)
+bool validator_integer::convert_string(std::string_view value, std::int64_t & result)
 {
-    std::uint64_t integer(0);
-    char const * s(value.c_str());
+    char const * s(value.data());
+    char const * const end(s + value.length());
 
     char sign('\0');
-    if(*s == '-' || *s == '+')
+    if(s < end
+    && (*s == '-' || *s == '+'))
     {
         sign = *s;
         ++s;
     }
 
     int base(10);
-    if(*s == '0')
+    if(end - s >= 2
+    && *s == '0')
     {
         switch(s[1])
         {
@@ -333,68 +481,48 @@ bool validator_integer::convert_string(std::string const & value, std::int64_t &
         }
     }
 
-    if(*s == '\0')
+    if(s == end)
     {
         // empty string or just the introducer, not considered valid
         //
         return false;
     }
 
-    for(;;)
+    std::uint64_t integer(0);
+    if(base == 10)
     {
-        char const c(*s++);
-        if(c == '\0')
-        {
-            // valid
-            //
-            if(sign == '-')
-            {
-                if(integer > 0x8000000000000000ULL)
-                {
-                    return false;
-                }
-                result = -integer;
-            }
-            else
-            {
-                if(integer > 0x7FFFFFFFFFFFFFFFULL)
-                {
-                    return false;
-                }
-                result = integer;
-            }
-            return true;
-        }
-
-        std::int64_t digit(std::numeric_limits<std::int64_t>::max());
-        if(c >= '0' && c <= '9')
+        if(!convert_decimal(s, end, integer))
         {
-            digit = c - '0';
-        }
-        else if(c >= 'a' && c <= 'f')
-        {
-            digit = c - ('a' - 10);
+            return false;
         }
-        else if(c >= 'A' && c <= 'F')
+    }
+    else
+    {
+        std::from_chars_result const r(std::from_chars(s, end, integer, base));
+        if(r.ec != std::errc()
+        || r.ptr != end)
         {
-            digit = c - ('A' - 10);
+            return false;
         }
-        if(digit >= base)
+    }
+
+    if(sign == '-')
+    {
+        if(integer > 0x8000000000000000ULL)
         {
-            // invalid digit
-            //
             return false;
         }
-
-        std::uint64_t const old(integer);
-        integer = integer * base + digit;
-        if(integer < old)
+        result = -integer;
+    }
+    else
+    {
+        if(integer > 0x7FFFFFFFFFFFFFFFULL)
         {
-            // overflow
-            //
             return false;
         }
+        result = integer;
     }
+    return true;
 }
 
 
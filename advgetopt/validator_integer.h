@@ -38,6 +38,7 @@
 //
 #include    <cstdint>
 #include    <limits>
+#include    <string_view>
 
 
 
@@ -50,7 +51,7 @@ class validator_integer
     : public validator
 {
 public:
-    typedef bool (*to_integer_t)(std::string const & number
+    typedef bool (*to_integer_t)(std::string_view number
                                , std::int64_t & result);
 
                                 validator_integer(string_list_t const & data);
@@ -58,9 +59,13 @@ public:
     // validator implementation
     //
     virtual std::string         name() const override;
-    virtual bool                validate(std::string const & value) const override;
+    using validator::validate;
+    virtual bool                validate_with_result(std::string const & value, validation_result & result) const override;
+    virtual bool                validate_batch(
+                                      string_list_t const & values
+                                    , index_list_t & invalid) const override;
 
-    static bool                 convert_string(std::string const & number
+    static bool                 convert_string(std::string_view number
                                              , std::int64_t & result);
 
 private:
@@ -72,6 +77,8 @@ private:
         std::int64_t            f_maximum = std::numeric_limits<std::int64_t>::max();
     };
 
+    bool                        in_range(std::int64_t value) const;
+
     range_t::vector_t           f_allowed_values = range_t::vector_t();
 };
 
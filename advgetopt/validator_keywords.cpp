@@ -23,18 +23,29 @@
  * The keywords validator allows us to check words in a very simple manner
  * (compared to the regular expression validator). It is also likely going
  * to be faster.
+ *
+ * The keywords are saved in a perfect hash table built by the constructor.
+ * This means a validation computes two hashes of the value and compares
+ * it against at most one keyword, whatever the number of keywords.
  */
 
 // self
 //
 #include    "advgetopt/validator_keywords.h"
 
+#include    "advgetopt/exception.h"
+
 
 // cppthread
 //
 #include    <cppthread/log.h>
 
 
+// C++
+//
+#include    <algorithm>
+
+
 // last include
 //
 #include    <snapdev/poison.h>
@@ -56,23 +67,46 @@ class validator_keywords_factory
     : public validator_factory
 {
 public:
-    validator_keywords_factory()
+    validator_keywords_factory(std::string const & name, bool case_insensitive)
+        : f_name(name)
+        , f_case_insensitive(case_insensitive)
     {
         validator::register_validator(*this);
     }
 
     virtual std::string get_name() const override
     {
-        return std::string("keywords");
+        return f_name;
     }
 
     virtual std::shared_ptr<validator> create(string_list_t const & data) const override
     {
-        return std::make_shared<validator_keywords>(data);
+        return std::make_shared<validator_keywords>(data, f_case_insensitive);
     }
+
+private:
+    std::string const   f_name;
+    bool const          f_case_insensitive;
 };
 
-validator_keywords_factory         g_validator_keywords_factory;
+validator_keywords_factory         g_validator_keywords_factory("keywords", false);
+validator_keywords_factory         g_validator_ikeywords_factory("ikeywords", true);
+
+
+/** \brief The maximum number of seeds to try for one bucket.
+ *
+ * While building the perfect hash table, each bucket of keywords gets
+ * assigned a seed such that all of its keywords land in free slots.
+ * If no such seed is found after this many attempts, the table gets
+ * enlarged and we start over.
+ */
+constexpr std::uint32_t             g_max_seed_attempts = 100'000;
+
+
+char to_lower(char c)
+{
+    return c >= 'A' && c <= 'Z' ? c | 0x20 : c;
+}
 
 
 
@@ -82,32 +116,77 @@ validator_keywords_factory         g_validator_keywords_factory;
 
 
 
-validator_keywords::validator_keywords(string_list_t const & keywords_list)
+/** \brief Initialize the keywords validator.
+ *
+ * The constructor saves the keywords and builds a perfect hash table
+ * used to find them.
+ *
+ * Each keyword is assigned an identifier which is its position in the
+ * \p keywords_list (duplicates are ignored). These identifiers can be
+ * retrieved with the get_id() function.
+ *
+ * When \p case_insensitive is true, the ASCII letters are compared
+ * without regard to their case. Other characters (i.e. UTF-8) have to
+ * match exactly.
+ *
+ * \param[in] keywords_list  The list of keywords.
+ * \param[in] case_insensitive  Whether to ignore the case of the letters.
+ */
+validator_keywords::validator_keywords(
+          string_list_t const & keywords_list
+        , bool case_insensitive)
+    : f_case_insensitive(case_insensitive)
 {
     if(keywords_list.empty())
     {
         cppthread::log << cppthread::log_level_t::error
-                       << "validator_keywords() requires at least one parameter."
+                       << "validator_" << name() << "() requires at least one parameter."
                        << cppthread::end;
         return;
     }
 
-    std::copy(
-          keywords_list.begin()
-        , keywords_list.end()
-        , std::inserter(f_keywords, f_keywords.begin()));
+    string_set_t found;
+    f_keywords.reserve(keywords_list.size());
+    for(auto const & k : keywords_list)
+    {
+        std::string key(k);
+        if(f_case_insensitive)
+        {
+            std::transform(key.begin(), key.end(), key.begin(), to_lower);
+        }
+        if(found.insert(key).second)
+        {
+            f_keywords.push_back(k);
+        }
+    }
+
+    // the table size is a power of two at least as large as the number
+    // of keywords; it rarely needs to grow
+    //
+    std::size_t table_size(1);
+    while(table_size < f_keywords.size())
+    {
+        table_size <<= 1;
+    }
+    while(!build_table(table_size))
+    {
+        table_size <<= 1;
+    }
 }
 
 
 /** \brief Return the name of this validator.
  *
- * This function returns "keywords".
+ * This function returns "keywords" or "ikeywords" when the validator
+ * is case insensitive.
  *
- * \return "keywords".
+ * \return "keywords" or "ikeywords".
  */
 std::string validator_keywords::name() const
 {
-    return std::string("keywords");
+    return f_case_insensitive
+                ? std::string("ikeywords")
+                : std::string("keywords");
 }
 
 
@@ -117,14 +196,15 @@ std::string validator_keywords::name() const
  * list of keywords. It returns true when it does match.
  *
  * \param[in] value  The value to be validated.
+ * \param[out] result  The error when \p value is not valid.
  *
  * \return true on a match.
  */
-bool validator_keywords::validate(std::string const & value) const
+bool validator_keywords::validate_with_result(std::string const & value, validation_result & result) const
 {
-    if(f_keywords.find(value) == f_keywords.end())
+    if(get_id(value) == NO_KEYWORD)
     {
-        set_error("not a known keyword.");
+        result.set_error(validation_error_t::VALIDATION_ERROR_NO_MATCH, "not a known keyword.");
         return false;
     }
 
@@ -132,6 +212,253 @@ bool validator_keywords::validate(std::string const & value) const
 }
 
 
+/** \brief Check whether this validator ignores the case.
+ *
+ * \return true if the validator was created as "ikeywords".
+ */
+bool validator_keywords::is_case_insensitive() const
+{
+    return f_case_insensitive;
+}
+
+
+/** \brief Get the number of keywords.
+ *
+ * This function returns the number of distinct keywords. The identifiers
+ * go from 0 to size() - 1.
+ *
+ * \return The number of keywords.
+ */
+std::size_t validator_keywords::size() const
+{
+    return f_keywords.size();
+}
+
+
+/** \brief Convert a value to its keyword identifier.
+ *
+ * This function searches for \p value in the perfect hash table and
+ * returns the identifier of that keyword. The identifier is the position
+ * of the keyword in the list of parameters, ignoring duplicates.
+ *
+ * This allows callers to use a switch() on the result instead of
+ * comparing strings.
+ *
+ * \param[in] value  The value to convert.
+ *
+ * \return The keyword identifier or NO_KEYWORD if \p value is not one
+ * of the keywords.
+ */
+int validator_keywords::get_id(std::string const & value) const
+{
+    if(f_slots.empty())
+    {
+        return NO_KEYWORD;
+    }
+
+    std::uint32_t const bucket(hash(value, 0) & (f_seeds.size() - 1));
+    std::uint32_t const slot(hash(value, f_seeds[bucket]) & (f_slots.size() - 1));
+    int const id(f_slots[slot]);
+    if(id == NO_KEYWORD
+    || !equal(f_keywords[id], value))
+    {
+        return NO_KEYWORD;
+    }
+
+    return id;
+}
+
+
+/** \brief Retrieve a keyword from its identifier.
+ *
+ * This function returns the keyword as it was defined in the list of
+ * parameters. In case insensitive mode, it may differ in case from the
+ * value that was validated.
+ *
+ * \exception getopt_logic_error
+ * The function raises this exception if \p id is out of range.
+ *
+ * \param[in] id  The identifier as returned by get_id().
+ *
+ * \return A reference to the keyword.
+ */
+std::string const & validator_keywords::get_keyword(int id) const
+{
+    if(id < 0
+    || static_cast<std::size_t>(id) >= f_keywords.size())
+    {
+        throw getopt_logic_error(
+                  "keyword identifier "
+                + std::to_string(id)
+                + " is out of range.");
+    }
+
+    return f_keywords[id];
+}
+
+
+/** \brief Compute the hash of a value.
+ *
+ * This function computes a seeded FNV-1a hash of \p value followed by
+ * a final mix so the lower bits are usable as an index. In case
+ * insensitive mode, the ASCII letters are hashed in lowercase.
+ *
+ * \param[in] value  The value to hash.
+ * \param[in] seed  The seed to use.
+ *
+ * \return The hash.
+ */
+std::uint32_t validator_keywords::hash(std::string const & value, std::uint32_t seed) const
+{
+    std::uint32_t h(2166136261U ^ (seed * 0x9E3779B9U));
+    if(f_case_insensitive)
+    {
+        for(char const c : value)
+        {
+            h ^= static_cast<unsigned char>(to_lower(c));
+            h *= 16777619U;
+        }
+    }
+    else
+    {
+        for(char const c : value)
+        {
+            h ^= static_cast<unsigned char>(c);
+            h *= 16777619U;
+        }
+    }
+
+    h ^= h >> 16;
+    h *= 0x7FEB352DU;
+    h ^= h >> 15;
+    h *= 0x846CA68BU;
+    h ^= h >> 16;
+
+    return h;
+}
+
+
+/** \brief Compare two strings.
+ *
+ * This function compares two strings taking the case insensitive flag
+ * in account.
+ *
+ * \param[in] lhs  The left hand side string.
+ * \param[in] rhs  The right hand side string.
+ *
+ * \return true if both strings are considered equal.
+ */
+bool validator_keywords::equal(std::string const & lhs, std::string const & rhs) const
+{
+    if(!f_case_insensitive)
+    {
+        return lhs == rhs;
+    }
+
+    return lhs.length() == rhs.length()
+        && std::equal(
+                  lhs.begin()
+                , lhs.end()
+                , rhs.begin()
+                , [](char a, char b)
+                  {
+                      return to_lower(a) == to_lower(b);
+                  });
+}
+
+
+/** \brief Build the perfect hash table.
+ *
+ * This function implements the "hash and displace" algorithm. The
+ * keywords are first distributed in buckets (about two per bucket).
+ * Then, starting with the largest buckets, we search a seed such that
+ * all the keywords of the bucket fall in distinct free slots of the
+ * table.
+ *
+ * A lookup then requires one hash to find the bucket and one hash
+ * with the bucket seed to find the slot.
+ *
+ * \param[in] table_size  The number of slots, a power of two.
+ *
+ * \return true if the table could be built, false if a larger table
+ * is necessary.
+ */
+bool validator_keywords::build_table(std::size_t table_size)
+{
+    std::size_t bucket_count(1);
+    while(bucket_count * 2 < f_keywords.size())
+    {
+        bucket_count <<= 1;
+    }
+
+    std::vector<std::vector<int>> buckets(bucket_count);
+    for(std::size_t idx(0); idx < f_keywords.size(); ++idx)
+    {
+        buckets[hash(f_keywords[idx], 0) & (bucket_count - 1)].push_back(static_cast<int>(idx));
+    }
+
+    std::vector<std::size_t> order(bucket_count);
+    for(std::size_t idx(0); idx < bucket_count; ++idx)
+    {
+        order[idx] = idx;
+    }
+    std::stable_sort(
+          order.begin()
+        , order.end()
+        , [&buckets](std::size_t a, std::size_t b)
+          {
+              return buckets[a].size() > buckets[b].size();
+          });
+
+    std::vector<std::uint32_t> seeds(bucket_count, 1);
+    std::vector<int> slots(table_size, NO_KEYWORD);
+    std::vector<std::uint32_t> positions;
+    for(auto const b : order)
+    {
+        if(buckets[b].empty())
+        {
+            break;
+        }
+
+        std::uint32_t seed(1);
+        for(;; ++seed)
+        {
+            if(seed > g_max_seed_attempts)
+            {
+                return false;
+            }
+
+            positions.clear();
+            for(auto const id : buckets[b])
+            {
+                std::uint32_t const pos(hash(f_keywords[id], seed) & (table_size - 1));
+                if(slots[pos] != NO_KEYWORD
+                || std::find(positions.begin(), positions.end(), pos) != positions.end())
+                {
+                    break;
+                }
+                positions.push_back(pos);
+            }
+            if(positions.size() == buckets[b].size())
+            {
+                break;
+            }
+        }
+
+        seeds[b] = seed;
+        for(std::size_t idx(0); idx < positions.size(); ++idx)
+        {
+            slots[positions[idx]] = buckets[b][idx];
+        }
+    }
+
+    f_seeds.swap(seeds);
+    f_slots.swap(slots);
+
+    return true;
+}
+
+
 
 } // namespace advgetopt
 // vim: ts=4 sw=4 et
@@ -30,6 +30,13 @@
  * \code
  *     keywords(on,off)
  * \endcode
+ *
+ * The ikeywords validator does the same thing, only it ignores the case
+ * of the (ASCII) letters:
+ *
+ * \code
+ *     ikeywords(yes,no)
+ * \endcode
  */
 
 // self
@@ -37,6 +44,11 @@
 #include    <advgetopt/validator.h>
 
 
+// C++
+//
+#include    <cstdint>
+
+
 
 namespace advgetopt
 {
@@ -47,15 +59,34 @@ class validator_keywords
     : public validator
 {
 public:
-                                validator_keywords(string_list_t const & data);
+    typedef std::shared_ptr<validator_keywords>  pointer_t;
+
+    static constexpr int        NO_KEYWORD = -1;
+
+                                validator_keywords(
+                                      string_list_t const & data
+                                    , bool case_insensitive = false);
 
     // validator implementation
     //
     virtual std::string         name() const override;
-    virtual bool                validate(std::string const & value) const override;
+    using validator::validate;
+    virtual bool                validate_with_result(std::string const & value, validation_result & result) const override;
+
+    bool                        is_case_insensitive() const;
+    std::size_t                 size() const;
+    int                         get_id(std::string const & value) const;
+    std::string const &         get_keyword(int id) const;
 
 private:
-    string_set_t                f_keywords = string_set_t();
+    std::uint32_t               hash(std::string const & value, std::uint32_t seed) const;
+    bool                        equal(std::string const & lhs, std::string const & rhs) const;
+    bool                        build_table(std::size_t table_size);
+
+    string_list_t               f_keywords = string_list_t();
+    std::vector<std::uint32_t>  f_seeds = std::vector<std::uint32_t>();
+    std::vector<int>            f_slots = std::vector<int>();
+    bool                        f_case_insensitive = false;
 };
 
 
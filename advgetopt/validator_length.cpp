@@ -30,6 +30,7 @@
 #include    "advgetopt/validator_length.h"
 
 #include    "advgetopt/validator_integer.h"
+#include    "advgetopt/validator_ranges.h"
 
 
 // cppthread
@@ -37,11 +38,6 @@
 #include    <cppthread/log.h>
 
 
-// libutf8
-//
-#include    <libutf8/libutf8.h>
-
-
 // snapdev
 //
 #include    <snapdev/trim_string.h>
@@ -96,9 +92,9 @@ validator_length_factory         g_validator_length_factory;
 
 validator_length::validator_length(string_list_t const & length_list)
 {
-    range_t range;
     for(auto r : length_list)
     {
+        range_t range;
         std::string::size_type const pos(r.find("..."));
         if(pos == std::string::npos)
         {
@@ -159,6 +155,8 @@ validator_length::validator_length(string_list_t const & length_list)
         }
         f_allowed_lengths.push_back(range);
     }
+
+    normalize_ranges(f_allowed_lengths);
 }
 
 
@@ -179,10 +177,11 @@ std::string validator_length::name() const
  * This function is used to verify the length of \p value in characters.
  *
  * \param[in] value  The value to be validated.
+ * \param[out] result  The error when \p value is not valid.
  *
  * \return true on a match.
  */
-bool validator_length::validate(std::string const & value) const
+bool validator_length::validate_with_result(std::string const & value, validation_result & result) const
 {
     if(f_allowed_lengths.empty())
     {
@@ -191,17 +190,13 @@ bool validator_length::validate(std::string const & value) const
 
     // get the number of characters assuming the input string is UTF-8
     //
-    std::int64_t const length(static_cast<std::int64_t>(libutf8::u8length(value)));
-    for(auto f : f_allowed_lengths)
+    std::int64_t const length(static_cast<std::int64_t>(utf8_length(value)));
+    if(find_range(f_allowed_lengths, length))
     {
-        if(length >= f.f_minimum
-        && length <= f.f_maximum)
-        {
-            return true;
-        }
+        return true;
     }
 
-    set_error("length (in character) of value is out of range.");
+    result.set_error(validation_error_t::VALIDATION_ERROR_OUT_OF_RANGE, "length (in character) of value is out of range.");
     return false;
 }
 
@@ -25,6 +25,11 @@
  *
  * This is especially useful if a parameter supports a value such as an
  * integer and a few keywords (i.e. "off", "disabled", "maximum", etc.)
+ *
+ * The list accepts a value as soon as one of its validators does. The
+ * validators are therefore run by increasing estimated cost. The order
+ * is computed once, when the validators get added, so validate() does
+ * not modify the list and one list can be shared between threads.
  */
 
 // self
@@ -37,6 +42,11 @@
 #include    <cppthread/log.h>
 
 
+// C++
+//
+#include    <algorithm>
+
+
 // last include
 //
 #include    <snapdev/poison.h>
@@ -78,6 +88,61 @@ validator_list_factory         g_validator_list_factory;
 
 
 
+struct default_cost_t
+{
+    char const *    f_name = nullptr;
+    std::uint64_t   f_cost = 0;
+};
+
+
+/** \brief Static ranking of the validators by cost.
+ *
+ * The validators of a list are sorted using this static heuristic. The
+ * numbers were not measured. They only rank the validators by the amount
+ * of work they do to check a value:
+ *
+ * \li 1 -- compare the value or its length against a small set;
+ * \li 2 -- convert the value to a number and check the ranges;
+ * \li 3 -- parse a number followed by a unit;
+ * \li 4 -- run a regular expression (also used for unknown validators);
+ * \li 5 -- run a list of validators;
+ * \li 6 -- parse the value with an external library (libtld).
+ *
+ * Validators not listed here are given the g_unknown_cost.
+ */
+constexpr default_cost_t        g_default_costs[] =
+{
+    { "double",     2 },
+    { "duration",   3 },
+    { "email",      6 },
+    { "ikeywords",  1 },
+    { "integer",    2 },
+    { "keywords",   1 },
+    { "length",     1 },
+    { "list",       5 },
+    { "regex",      4 },
+    { "size",       3 },
+};
+
+
+constexpr std::uint64_t         g_unknown_cost = 4;
+
+
+std::uint64_t default_cost(std::string const & name)
+{
+    for(auto const & c : g_default_costs)
+    {
+        if(name == c.f_name)
+        {
+            return c.f_cost;
+        }
+    }
+
+    return g_unknown_cost;
+}
+
+
+
 } // no name namespace
 
 
@@ -96,15 +161,64 @@ validator_list::validator_list(string_list_t const & param_list)
 }
 
 
+validator_list::entry_t::entry_t(validator::pointer_t v, std::uint64_t cost) noexcept
+    : f_validator(v)
+    , f_cost(cost)
+{
+}
+
+
+/** \brief Add a validator to the list.
+ *
+ * This function adds \p v to the list of validators. The validators are
+ * not run in the order they are added. Instead the validators ranked
+ * as the cheapest are run first (see validate_with_result() for details).
+ *
+ * Validators must all be added before the list gets used.
+ *
+ * \param[in] v  The validator to add. If nullptr, it is ignored.
+ */
 void validator_list::add_validator(validator::pointer_t v)
 {
     if(v != nullptr)
     {
-        f_validators.push_back(v);
+        // insert after the validators with the same cost so the order
+        // of declaration is kept between equivalent validators
+        //
+        std::uint64_t const cost(default_cost(v->name()));
+        auto const it(std::upper_bound(
+                  f_validators.begin()
+                , f_validators.end()
+                , cost
+                , [](std::uint64_t c, entry_t const & e)
+                  {
+                      return c < e.f_cost;
+                  }));
+        f_validators.emplace(it, v, cost);
     }
 }
 
 
+/** \brief Get the list of validators.
+ *
+ * This function returns the validators in the order they get run by
+ * the validate_with_result() function.
+ *
+ * \return The validators of this list.
+ */
+validator::vector_t validator_list::get_validators() const
+{
+    validator::vector_t result;
+    result.reserve(f_validators.size());
+    for(auto const & e : f_validators)
+    {
+        result.push_back(e.f_validator);
+    }
+
+    return result;
+}
+
+
 /** \brief Return the name of this validator.
  *
  * This function returns "list".
@@ -123,21 +237,32 @@ std::string validator_list::name() const
  * at least one of these validators returns true, then the function
  * considers that input value as valid and it returns true.
  *
+ * Since the first validator returning true decides the result, the
+ * order does not change the result, only the time it takes to get it.
+ * The validators are run by increasing cost as defined by a static
+ * ranking (see g_default_costs). For example,
+ * with `length(...) | regex(...)`, the length is checked first and the
+ * regex only runs when the length is not acceptable.
+ *
  * \param[in] value  The value to be validated.
+ * \param[out] result  The error when \p value is not valid.
  *
  * \return true on a match.
  */
-bool validator_list::validate(std::string const & value) const
+bool validator_list::validate_with_result(std::string const & value, validation_result & result) const
 {
-    for(auto const & v : f_validators)
+    // the errors of the sub-validators are ignored
+    //
+    validation_result ignored;
+    for(auto const & e : f_validators)
     {
-        if(v->validate(value))
+        if(e.f_validator->validate_with_result(value, ignored))
         {
             return true;
         }
     }
 
-    set_error("none of the validators could accept the input value.");
+    result.set_error(validation_error_t::VALIDATION_ERROR_NO_MATCH, "none of the validators could accept the input value.");
     return false;
 }
 
@@ -33,6 +33,12 @@
 #include    <advgetopt/validator.h>
 
 
+// C++
+//
+#include    <cstdint>
+#include    <vector>
+
+
 
 namespace advgetopt
 {
@@ -48,14 +54,24 @@ public:
                                 validator_list(string_list_t const & data);
 
     void                        add_validator(validator::pointer_t v);
+    validator::vector_t         get_validators() const;
 
     // validator implementation
     //
     virtual std::string         name() const override;
-    virtual bool                validate(std::string const & value) const override;
+    using validator::validate;
+    virtual bool                validate_with_result(std::string const & value, validation_result & result) const override;
 
 private:
-    validator::vector_t         f_validators = validator::vector_t();
+    struct entry_t
+    {
+                                    entry_t(validator::pointer_t v, std::uint64_t cost) noexcept;
+
+        validator::pointer_t        f_validator = validator::pointer_t();
+        std::uint64_t               f_cost = 0;
+    };
+
+    std::vector<entry_t>        f_validators = std::vector<entry_t>();
 };
 
 
@@ -0,0 +1,164 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+#pragma once
+
+/** \file
+ * \brief Helper functions used by the validators supporting ranges.
+ *
+ * The integer, double, length, and duration validators all accept a list
+ * of ranges. Some applications define hundreds of such ranges (i.e. a
+ * list of allowed ports). Instead of testing each value against each
+ * range, these validators normalize their list once at construction time
+ * and then use a binary search.
+ *
+ * The range structures are expected to have an `f_minimum` and an
+ * `f_maximum` field of the same type.
+ *
+ * This header is private to the library.
+ */
+
+// C++
+//
+#include    <algorithm>
+#include    <cmath>
+#include    <limits>
+#include    <type_traits>
+#include    <vector>
+
+
+
+namespace advgetopt
+{
+
+
+
+/** \brief Sort and merge a list of ranges.
+ *
+ * This function sorts the ranges by their minimum and then merges the
+ * ranges which overlap. With integers, ranges which are adjacent (such
+ * as 1...5 and 6...10) get merged too.
+ *
+ * Ranges including a NaN are removed since they can never match (unless
+ * that would leave the list empty).
+ *
+ * Once this function returned, the ranges are disjoint and sorted in
+ * increasing order, which is what find_range() expects.
+ *
+ * \param[in,out] ranges  The ranges to normalize.
+ */
+template<typename R>
+void normalize_ranges(std::vector<R> & ranges)
+{
+    typedef std::remove_cv_t<decltype(R::f_minimum)> value_t;
+
+    if constexpr(std::is_floating_point_v<value_t>)
+    {
+        // a range with a NaN never matches and would break the sort;
+        // keep one if there is nothing else so the validator still
+        // rejects all the values (an empty list accepts everything)
+        //
+        auto const end(std::remove_if(
+                  ranges.begin()
+                , ranges.end()
+                , [](R const & r)
+                {
+                    return std::isnan(r.f_minimum)
+                        || std::isnan(r.f_maximum);
+                }));
+        ranges.erase(
+              end == ranges.begin() && !ranges.empty()
+                    ? end + 1
+                    : end
+            , ranges.end());
+    }
+
+    if(ranges.size() < 2)
+    {
+        return;
+    }
+
+    std::sort(
+          ranges.begin()
+        , ranges.end()
+        , [](R const & a, R const & b)
+        {
+            return a.f_minimum < b.f_minimum;
+        });
+
+    std::size_t last(0);
+    for(std::size_t idx(1); idx < ranges.size(); ++idx)
+    {
+        bool merge(ranges[idx].f_minimum <= ranges[last].f_maximum);
+        if constexpr(std::is_integral_v<value_t>)
+        {
+            if(!merge
+            && ranges[last].f_maximum != std::numeric_limits<value_t>::max())
+            {
+                merge = ranges[idx].f_minimum == ranges[last].f_maximum + 1;
+            }
+        }
+        if(merge)
+        {
+            ranges[last].f_maximum = std::max(ranges[last].f_maximum, ranges[idx].f_maximum);
+        }
+        else
+        {
+            ++last;
+            ranges[last] = ranges[idx];
+        }
+    }
+    ranges.resize(last + 1);
+    ranges.shrink_to_fit();
+}
+
+
+/** \brief Search for the range including \p value.
+ *
+ * The \p ranges must have been normalized with normalize_ranges().
+ *
+ * The function uses a binary search so the cost is O(log n) whatever
+ * the number of ranges.
+ *
+ * \param[in] ranges  The normalized ranges.
+ * \param[in] value  The value to search.
+ *
+ * \return true if \p value is included in one of the ranges.
+ */
+template<typename R, typename T>
+bool find_range(std::vector<R> const & ranges, T value)
+{
+    // first range which ends at or after value
+    //
+    auto const it(std::lower_bound(
+          ranges.begin()
+        , ranges.end()
+        , value
+        , [](R const & r, T v)
+        {
+            return r.f_maximum < v;
+        }));
+
+    return it != ranges.end()
+        && it->f_minimum <= value;
+}
+
+
+
+}   // namespace advgetopt
+// vim: ts=4 sw=4 et
@@ -25,6 +25,17 @@
  *
  * This validator does not offer a convertor since a regular expression
  * does not really offer such a feature.
+ *
+ * The expressions are POSIX extended regular expressions. They get
+ * compiled with the C library regcomp() function. Unlike std::regex,
+ * the glibc matcher does not recurse once per input character, so long
+ * inputs do not blow up the stack. Expressions without back references
+ * are matched without backtracking. Back references are not regular
+ * though and glibc has to backtrack to match them, which can take
+ * exponential time on some inputs. Avoid them on untrusted values.
+ *
+ * Compiled expressions are kept in a small cache so the same expression
+ * used by many options gets compiled only once.
  */
 
 // self
@@ -34,7 +45,21 @@
 
 // cppthread
 //
+#include    <cppthread/guard.h>
 #include    <cppthread/log.h>
+#include    <cppthread/mutex.h>
+
+
+// C++
+//
+#include    <list>
+#include    <map>
+#include    <regex>
+
+
+// C
+//
+#include    <regex.h>
 
 
 // last include
@@ -49,11 +74,216 @@ namespace advgetopt
 
 
 
+// from utils.cpp
+//
+cppthread::mutex &  get_global_mutex();
+
+
+
+/** \brief A compiled regular expression.
+ *
+ * This class holds a POSIX regular expression as compiled by regcomp().
+ * The objects are immutable once created and the C library regexec()
+ * function is thread safe so one instance can be shared between any
+ * number of validators and threads.
+ */
+class compiled_regex
+{
+public:
+    typedef std::shared_ptr<compiled_regex>     pointer_t;
+
+                                compiled_regex(std::string const & pattern, int flags);
+                                compiled_regex(compiled_regex const &) = delete;
+                                ~compiled_regex();
+    compiled_regex &            operator = (compiled_regex const &) = delete;
+
+    static pointer_t            get(std::string const & pattern, int flags);
+
+    bool                        match(std::string const & value) const;
+
+private:
+    regex_t                     f_regex = regex_t();
+    bool                        f_anchored = false;
+};
+
+
+
 namespace
 {
 
 
 
+/** \brief Maximum number of compiled expressions kept in the cache.
+ *
+ * The cache keeps the most recently used expressions. Once full, the
+ * least recently used one is dropped. Validators still using it keep
+ * their own reference so it remains valid for them.
+ */
+constexpr std::size_t const     g_regex_cache_limit = 100;
+
+
+typedef std::pair<std::string, int>     regex_key_t;
+typedef std::pair<regex_key_t, compiled_regex::pointer_t>
+                                        regex_cache_entry_t;
+typedef std::list<regex_cache_entry_t>  regex_cache_list_t;
+typedef std::map<regex_key_t, regex_cache_list_t::iterator>
+                                        regex_cache_index_t;
+
+regex_cache_list_t              g_regex_cache_list = regex_cache_list_t();
+regex_cache_index_t             g_regex_cache_index = regex_cache_index_t();
+
+
+
+/** \brief Convert a regcomp() error to a std::regex error code.
+ *
+ * The validator used to compile its expression with std::regex, which
+ * throws a std::regex_error on an invalid expression. We keep throwing
+ * that same exception so existing callers still catch it. This function
+ * gives the closest std::regex error code for a regcomp() error.
+ *
+ * \param[in] r  The error returned by regcomp().
+ *
+ * \return The corresponding std::regex error code.
+ */
+std::regex_constants::error_type to_regex_error(int r)
+{
+    switch(r)
+    {
+    case REG_ECOLLATE:
+        return std::regex_constants::error_collate;
+
+    case REG_ECTYPE:
+        return std::regex_constants::error_ctype;
+
+    case REG_EESCAPE:
+        return std::regex_constants::error_escape;
+
+    case REG_ESUBREG:
+        return std::regex_constants::error_backref;
+
+    case REG_EBRACK:
+        return std::regex_constants::error_brack;
+
+    case REG_EPAREN:
+        return std::regex_constants::error_paren;
+
+    case REG_EBRACE:
+        return std::regex_constants::error_brace;
+
+    case REG_BADBR:
+        return std::regex_constants::error_badbrace;
+
+    case REG_ERANGE:
+        return std::regex_constants::error_range;
+
+    case REG_ESPACE:
+        return std::regex_constants::error_space;
+
+    case REG_BADRPT:
+        return std::regex_constants::error_badrepeat;
+
+    default:
+        return std::regex_constants::error_complexity;
+
+    }
+}
+
+
+
+/** \brief Check whether a pattern can be wrapped in a group.
+ *
+ * This function checks whether \p pattern can safely be written as
+ * "^(\<pattern>)$". This is not the case if the pattern includes
+ * back references (the numbering would change) or a closing parenthesis
+ * without a corresponding opening parenthesis (POSIX makes it a literal
+ * which would now close our group).
+ *
+ * \param[in] pattern  The pattern to check.
+ *
+ * \return true if the pattern can be anchored.
+ */
+bool can_anchor(std::string const & pattern)
+{
+    int depth(0);
+    for(auto it(pattern.begin()); it != pattern.end(); ++it)
+    {
+        switch(*it)
+        {
+        case '\\':
+            ++it;
+            if(it == pattern.end())
+            {
+                return true;
+            }
+            if(*it >= '1' && *it <= '9')
+            {
+                return false;
+            }
+            break;
+
+        case '[':
+            // skip the bracket expression; a ']' right after the '['
+            // or "[^" is a literal and "[:", "[.", "[=" are sub-items
+            //
+            ++it;
+            if(it != pattern.end() && *it == '^')
+            {
+                ++it;
+            }
+            if(it != pattern.end() && *it == ']')
+            {
+                ++it;
+            }
+            for(; it != pattern.end() && *it != ']'; ++it)
+            {
+                if(*it == '['
+                && it + 1 != pattern.end()
+                && (it[1] == ':' || it[1] == '.' || it[1] == '='))
+                {
+                    char const c(it[1]);
+                    for(it += 2; it != pattern.end(); ++it)
+                    {
+                        if(*it == c
+                        && it + 1 != pattern.end()
+                        && it[1] == ']')
+                        {
+                            ++it;
+                            break;
+                        }
+                    }
+                    if(it == pattern.end())
+                    {
+                        return true;
+                    }
+                }
+            }
+            if(it == pattern.end())
+            {
+                return true;
+            }
+            break;
+
+        case '(':
+            ++depth;
+            break;
+
+        case ')':
+            if(depth == 0)
+            {
+                return false;
+            }
+            --depth;
+            break;
+
+        }
+    }
+
+    return true;
+}
+
+
+
+
 class validator_regex_factory
     : public validator_factory
 {
@@ -82,6 +312,133 @@ validator_regex_factory         g_validator_regex_factory;
 
 
 
+/** \brief Compile a regular expression.
+ *
+ * This constructor compiles the \p pattern with the regcomp() function.
+ *
+ * The validator has to match the entire value. When possible, the
+ * pattern gets anchored (i.e. "^(\<pattern>)$") and compiled with
+ * REG_NOSUB, which lets the C library use its DFA without tracking
+ * any sub-expressions. If the pattern includes back references or
+ * unmatched closing parenthesis, the extra group would change their
+ * meaning so instead we keep the pattern as is and verify the position
+ * of the match.
+ *
+ * \param[in] pattern  The POSIX extended regular expression.
+ * \param[in] flags  Extra regcomp() flags (i.e. REG_ICASE).
+ *
+ * \exception std::regex_error
+ * The pattern is not a valid POSIX extended regular expression.
+ */
+compiled_regex::compiled_regex(std::string const & pattern, int flags)
+{
+    int r(regcomp(&f_regex, pattern.c_str(), REG_EXTENDED | flags));
+    if(r != 0)
+    {
+        throw std::regex_error(to_regex_error(r));
+    }
+
+    if(can_anchor(pattern))
+    {
+        std::string const anchored("^(" + pattern + ")$");
+        regex_t a;
+        if(regcomp(&a, anchored.c_str(), REG_EXTENDED | REG_NOSUB | flags) == 0)
+        {
+            regfree(&f_regex);
+            f_regex = a;
+            f_anchored = true;
+        }
+    }
+}
+
+
+/** \brief Release the compiled regular expression.
+ *
+ * The destructor frees the resources allocated by regcomp().
+ */
+compiled_regex::~compiled_regex()
+{
+    regfree(&f_regex);
+}
+
+
+/** \brief Retrieve a compiled regular expression.
+ *
+ * This function searches the process wide cache of compiled regular
+ * expressions for \p pattern compiled with \p flags. If not found,
+ * the expression gets compiled and saved in the cache.
+ *
+ * The cache is limited to g_regex_cache_limit entries. When full, the
+ * least recently used expression gets removed from the cache. An
+ * invalid expression is never added to the cache.
+ *
+ * \param[in] pattern  The POSIX extended regular expression.
+ * \param[in] flags  Extra regcomp() flags (i.e. REG_ICASE).
+ *
+ * \return A shared pointer to the compiled regular expression.
+ *
+ * \exception std::regex_error
+ * The pattern is not a valid POSIX extended regular expression.
+ */
+compiled_regex::pointer_t compiled_regex::get(std::string const & pattern, int flags)
+{
+    cppthread::guard lock(get_global_mutex());
+
+    regex_key_t key(pattern, flags);
+    auto it(g_regex_cache_index.find(key));
+    if(it != g_regex_cache_index.end())
+    {
+        g_regex_cache_list.splice(g_regex_cache_list.begin(), g_regex_cache_list, it->second);
+        return it->second->second;
+    }
+
+    pointer_t r(std::make_shared<compiled_regex>(pattern, flags));
+    g_regex_cache_list.emplace_front(key, r);
+    g_regex_cache_index[std::move(key)] = g_regex_cache_list.begin();
+    if(g_regex_cache_list.size() > g_regex_cache_limit)
+    {
+        g_regex_cache_index.erase(g_regex_cache_list.back().first);
+        g_regex_cache_list.pop_back();
+    }
+    return r;
+}
+
+
+/** \brief Check whether \p value matches this regular expression.
+ *
+ * The whole value must match the expression, as with std::regex_match().
+ *
+ * When the pattern could not be anchored, we ask regexec() for the
+ * position of the match. Since POSIX returns the leftmost longest match,
+ * the value matches if and only if that match covers the entire value.
+ *
+ * The REG_STARTEND flag is used so the value may include '\\0' characters.
+ *
+ * \param[in] value  The value to be matched.
+ *
+ * \return true if the entire value matches.
+ */
+bool compiled_regex::match(std::string const & value) const
+{
+    regmatch_t m[1];
+    m[0].rm_so = 0;
+    m[0].rm_eo = static_cast<regoff_t>(value.length());
+    if(f_anchored)
+    {
+        return regexec(&f_regex, value.c_str(), 0, m, REG_STARTEND) == 0;
+    }
+
+    if(regexec(&f_regex, value.c_str(), 1, m, REG_STARTEND) != 0)
+    {
+        return false;
+    }
+
+    return m[0].rm_so == 0
+        && m[0].rm_eo == static_cast<regoff_t>(value.length());
+}
+
+
+
 
 
 validator_regex::validator_regex(string_list_t const & regex_list)
@@ -101,7 +458,7 @@ validator_regex::validator_regex(string_list_t const & regex_list)
     {
         regex = regex_list[0];
     }
-    std::regex::flag_type flags =  std::regex_constants::extended;
+    int flags(0);
     if(regex.length() >= 2
     && regex[0] == '/')
     {
@@ -115,7 +472,7 @@ validator_regex::validator_regex(string_list_t const & regex_list)
             switch(*it)
             {
             case 'i':
-                flags |= std::regex_constants::icase;
+                flags |= REG_ICASE;
                 break;
 
             default:
@@ -138,16 +495,16 @@ validator_regex::validator_regex(string_list_t const & regex_list)
                            << "\"."
                            << cppthread::end;
 
-            f_regex = std::regex(std::string(regex.begin() + 1, regex.end()), flags);
+            f_regex = compiled_regex::get(std::string(regex.begin() + 1, regex.end()), flags);
         }
         else
         {
-            f_regex = std::regex(std::string(regex.begin() + 1, it), flags);
+            f_regex = compiled_regex::get(std::string(regex.begin() + 1, it), flags);
         }
     }
     else
     {
-        f_regex = std::regex(regex, flags);
+        f_regex = compiled_regex::get(regex, flags);
     }
 }
 
@@ -170,18 +527,19 @@ std::string validator_regex::name() const
  * regular expression. It returns true when it does match.
  *
  * \param[in] value  The value to be validated.
+ * \param[out] result  The error when \p value is not valid.
  *
  * \return true on a match.
  */
-bool validator_regex::validate(std::string const & value) const
+bool validator_regex::validate_with_result(std::string const & value, validation_result & result) const
 {
-    std::smatch info;
-    if(std::regex_match(value, info, f_regex))
+    if(f_regex != nullptr
+    && f_regex->match(value))
     {
         return true;
     }
 
-    set_error("did not match the regex.");
+    result.set_error(validation_error_t::VALIDATION_ERROR_NO_MATCH, "did not match the regex.");
     return false;
 }
 
@@ -36,7 +36,7 @@
 
 // C++
 //
-#include    <regex>
+#include    <memory>
 
 
 
@@ -45,6 +45,9 @@ namespace advgetopt
 
 
 
+class compiled_regex;
+
+
 class validator_regex
     : public validator
 {
@@ -54,10 +57,12 @@ public:
     // validator implementation
     //
     virtual std::string         name() const override;
-    virtual bool                validate(std::string const & value) const override;
+    using validator::validate;
+    virtual bool                validate_with_result(std::string const & value, validation_result & result) const override;
 
 private:
-    std::regex                  f_regex = std::regex();
+    std::shared_ptr<compiled_regex>
+                                f_regex = std::shared_ptr<compiled_regex>();
 };
 
 
@@ -171,21 +171,22 @@ std::string validator_size::name() const
  * measurement suffix.
  *
  * \param[in] value  The value to validate.
+ * \param[out] result  The error when \p value is not valid.
  *
  * \return true if the value validates.
  */
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpedantic"
-bool validator_size::validate(std::string const & value) const
+bool validator_size::validate_with_result(std::string const & value, validation_result & result) const
 {
     using namespace snapdev::literals;
-    __int128 result(0_int128);
-    if(convert_string(value, f_flags, result))
+    __int128 size(0_int128);
+    if(convert_string(value, f_flags, size))
     {
         return true;
     }
 
-    set_error("invalid size suffix or number.");
+    result.set_error(validation_error_t::VALIDATION_ERROR_INVALID, "invalid size suffix or number.");
     return false;
 }
 #pragma GCC diagnostic pop
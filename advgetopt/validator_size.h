@@ -59,7 +59,8 @@ public:
     // validator implementation
     //
     virtual std::string         name() const override;
-    virtual bool                validate(std::string const & value) const override;
+    using validator::validate;
+    virtual bool                validate_with_result(std::string const & value, validation_result & result) const override;
 
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wpedantic"
@@ -1413,6 +1413,46 @@ CATCH_TEST_CASE("require_arguments", "[arguments][valid][required][multiple][get
             CATCH_REQUIRE(opt.get_program_name() == "arguments");
             CATCH_REQUIRE(opt.get_program_fullname() == "/usr/bin/arguments");
         }
+
+        CATCH_WHEN("parsing strings larger than the stack buffer")
+        {
+            snapdev::safe_setenv env("ADVGETOPT_TEST_OPTIONS", "--out \"my filename.out\" another.out last.out");
+
+            char const * cargv[] =
+            {
+                "/usr/bin/arguments",
+                nullptr
+            };
+            int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+            char ** argv = const_cast<char **>(cargv);
+
+            advgetopt::getopt opt(environment_options, argc, argv);
+
+            // check that the result is valid
+
+            // the valid parameter
+            CATCH_REQUIRE(opt.get_option("out") != nullptr);
+            CATCH_REQUIRE(opt.is_defined("out"));
+            CATCH_REQUIRE(opt.get_string("out", 0) == "my filename.out");
+            CATCH_REQUIRE(opt.get_string("out", 1) == "another.out");
+            CATCH_REQUIRE(opt.get_string("out", 2) == "last.out");
+            CATCH_REQUIRE(opt.size("out") == 3);
+
+            // the values survive the buffers which only live for the
+            // duration of one parse_string() call
+            opt.reset();
+            CATCH_REQUIRE_FALSE(opt.is_defined("out"));
+            opt.parse_string("--out again.out", advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+            CATCH_REQUIRE(opt.get_string("out") == "again.out");
+
+            // a string larger than the buffer on the stack
+            std::string const large(2'000, 'l');
+            opt.reset();
+            opt.parse_string("--out " + large + " small.out", advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+            CATCH_REQUIRE(opt.size("out") == 2);
+            CATCH_REQUIRE(opt.get_string("out", 0) == large);
+            CATCH_REQUIRE(opt.get_string("out", 1) == "small.out");
+        }
     }
     CATCH_END_SECTION()
 }
@@ -4911,6 +4951,31 @@ CATCH_TEST_CASE("individual_argument_variable", "[arguments][valid][variable][ge
             CATCH_REQUIRE(opt->is_defined("--"));
             CATCH_REQUIRE(opt->get_string("--", 0) == "name1 other-name more-names");
         }
+
+        CATCH_WHEN("Testing that the environment is read when parsed")
+        {
+            char const * cargv[] =
+            {
+                "tests/system-arguments",
+                nullptr
+            };
+            int const argc = sizeof(cargv) / sizeof(cargv[0]) - 1;
+            char ** argv = const_cast<char **>(cargv);
+
+            advgetopt::getopt::pointer_t opt(std::make_shared<advgetopt::getopt>(environment_options, argc, argv));
+            CATCH_REQUIRE(opt != nullptr);
+
+            CATCH_REQUIRE_FALSE(opt->is_defined("size"));
+
+            // a variable set after the getopt object was created is
+            // still found by parse_environment_variable()
+            //
+            snapdev::safe_setenv env_size("SIZE", "7070");
+
+            opt->parse_environment_variable();
+            CATCH_REQUIRE(opt->is_defined("size"));
+            CATCH_REQUIRE(opt->get_string("size") == "7070");
+        }
     }
     CATCH_END_SECTION()
 }
@@ -0,0 +1,789 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+// advgetopt
+//
+#include    <advgetopt/exception.h>
+#include    <advgetopt/option_overlay.h>
+#include    <advgetopt/option_schema.h>
+#include    <advgetopt/parse_session.h>
+#include    <advgetopt/validator_double.h>
+#include    <advgetopt/validator_email.h>
+#include    <advgetopt/validator_integer.h>
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// snapdev
+//
+#include    <snapdev/safe_setenv.h>
+
+
+// C++
+//
+#include    <atomic>
+#include    <chrono>
+#include    <cstring>
+#include    <iomanip>
+#include    <iterator>
+#include    <new>
+#include    <regex>
+#include    <thread>
+
+
+// C
+//
+#include    <link.h>
+#include    <stdlib.h>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+// the benchmarks replace the global operator new() to count allocations
+// so they are compiled in their own executable instead of the unittest:
+//
+//     advgetopt_benchmark
+//
+
+
+
+namespace
+{
+
+
+std::atomic<std::size_t>    g_allocations(0);
+
+
+struct benchmark_result_t
+{
+    std::size_t             f_allocations = 0;
+    double                  f_seconds = 0.0;
+};
+
+
+class option_table
+{
+public:
+    option_table(std::size_t count)
+    {
+        f_names.reserve(count);
+        f_options.reserve(count + 1);
+        for(std::size_t idx(0); idx < count; ++idx)
+        {
+            f_names.push_back("option-" + std::to_string(idx));
+        }
+        for(auto const & n : f_names)
+        {
+            advgetopt::option o;
+            o.f_flags = advgetopt::GETOPT_FLAG_COMMAND_LINE
+                      | advgetopt::GETOPT_FLAG_ENVIRONMENT_VARIABLE
+                      | advgetopt::GETOPT_FLAG_REQUIRED;
+            o.f_name = n.c_str();
+            o.f_help = "benchmark option.";
+            f_options.push_back(o);
+        }
+        f_options.push_back(advgetopt::end_options());
+    }
+
+    advgetopt::option const * options() const
+    {
+        return f_options.data();
+    }
+
+    std::string arguments(std::size_t count) const
+    {
+        std::string result;
+        for(std::size_t idx(0); idx < count && idx < f_names.size(); ++idx)
+        {
+            result += " --" + f_names[idx] + " \"value number " + std::to_string(idx) + " used by the benchmark\"";
+        }
+        return result;
+    }
+
+private:
+    std::vector<std::string>        f_names = std::vector<std::string>();
+    std::vector<advgetopt::option>  f_options = std::vector<advgetopt::option>();
+};
+
+
+template<typename F>
+benchmark_result_t run_benchmark(std::size_t repeat, F f)
+{
+    benchmark_result_t result;
+    std::size_t const start_allocations(g_allocations);
+    auto const start(std::chrono::steady_clock::now());
+    for(std::size_t idx(0); idx < repeat; ++idx)
+    {
+        f();
+    }
+    auto const end(std::chrono::steady_clock::now());
+    result.f_allocations = g_allocations - start_allocations;
+    result.f_seconds = std::chrono::duration<double>(end - start).count();
+    return result;
+}
+
+
+void show_result(std::string const & name, std::size_t repeat, benchmark_result_t const & r)
+{
+    std::cout << std::left << std::setw(40) << name
+              << std::right
+              << std::setw(12) << r.f_allocations / repeat << " allocs/run "
+              << std::setw(12) << std::fixed << std::setprecision(3)
+              << r.f_seconds * 1'000'000.0 / static_cast<double>(repeat) << " us/run\n";
+}
+
+
+}
+// no name namespace
+
+
+
+// count the allocations so benchmarks can report them
+//
+void * operator new(std::size_t size)
+{
+    ++g_allocations;
+    void * ptr(malloc(size == 0 ? 1 : size));
+    if(ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+
+void operator delete(void * ptr) noexcept
+{
+    free(ptr);
+}
+
+
+void operator delete(void * ptr, std::size_t size) noexcept
+{
+    snapdev::NOT_USED(size);
+    free(ptr);
+}
+
+
+
+CATCH_TEST_CASE("benchmark_startup", "[benchmark]")
+{
+    CATCH_START_SECTION("benchmark_startup: getopt startup")
+    {
+        std::size_t const repeat(200);
+        option_table const table(250);
+        snapdev::safe_setenv env("ADVGETOPT_BENCHMARK_OPTIONS", table.arguments(250));
+
+        char const * cargv[] =
+        {
+            "/usr/bin/benchmark",
+            "--option-3",
+            "command line value",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = table.options();
+        environment_options.f_environment_variable_name = "ADVGETOPT_BENCHMARK_OPTIONS";
+
+        benchmark_result_t const startup(run_benchmark(repeat, [&]()
+            {
+                advgetopt::getopt opt(environment_options, argc, argv);
+                CATCH_REQUIRE(opt.get_string("option-3") == "command line value");
+            }));
+
+        show_result("getopt startup", repeat, startup);
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+CATCH_TEST_CASE("benchmark_conversions", "[benchmark]")
+{
+    CATCH_START_SECTION("benchmark_conversions: convert 1M integers and doubles")
+    {
+        std::size_t const count(1'000'000);
+
+        advgetopt::string_list_t integers;
+        advgetopt::string_list_t doubles;
+        integers.reserve(count);
+        doubles.reserve(count);
+        for(std::size_t idx(0); idx < count; ++idx)
+        {
+            std::int64_t const n((static_cast<std::int64_t>(rand()) << 16) ^ rand());
+            integers.push_back(std::to_string(idx % 3 == 0 ? -n : n >> (idx % 40)));
+            doubles.push_back(std::to_string(static_cast<double>(n) / 1000.0));
+        }
+
+        bool valid(true);
+        std::int64_t integer_sum(0);
+        benchmark_result_t const integer_result(run_benchmark(1, [&]()
+            {
+                for(auto const & v : integers)
+                {
+                    std::int64_t n(0);
+                    valid = advgetopt::validator_integer::convert_string(v, n) && valid;
+                    integer_sum += n;
+                }
+            }));
+
+        std::int64_t strtoll_sum(0);
+        benchmark_result_t const strtoll_result(run_benchmark(1, [&]()
+            {
+                for(auto const & v : integers)
+                {
+                    strtoll_sum += strtoll(v.c_str(), nullptr, 10);
+                }
+            }));
+
+        double double_sum(0.0);
+        benchmark_result_t const double_result(run_benchmark(1, [&]()
+            {
+                for(auto const & v : doubles)
+                {
+                    double d(0.0);
+                    valid = advgetopt::validator_double::convert_string(v, d) && valid;
+                    double_sum += d;
+                }
+            }));
+
+        double strtod_sum(0.0);
+        benchmark_result_t const strtod_result(run_benchmark(1, [&]()
+            {
+                for(auto const & v : doubles)
+                {
+                    strtod_sum += strtod(v.c_str(), nullptr);
+                }
+            }));
+
+        show_result("1M integers (convert_string)", 1, integer_result);
+        show_result("1M integers (strtoll)", 1, strtoll_result);
+        show_result("1M doubles (convert_string)", 1, double_result);
+        show_result("1M doubles (strtod)", 1, strtod_result);
+
+        CATCH_REQUIRE(valid);
+        CATCH_REQUIRE(integer_sum == strtoll_sum);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wfloat-equal"
+        CATCH_REQUIRE(double_sum == strtod_sum);
+#pragma GCC diagnostic pop
+
+        // the conversions do not allocate
+        //
+        CATCH_REQUIRE(integer_result.f_allocations == 0);
+        CATCH_REQUIRE(double_result.f_allocations == 0);
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+CATCH_TEST_CASE("benchmark_regex", "[benchmark]")
+{
+    CATCH_START_SECTION("benchmark_regex: regex validator versus std::regex")
+    {
+        std::string const pattern("[a-z][-a-z0-9.]*@[a-z0-9]+(\\.[a-z0-9]+)+");
+        std::size_t const repeat(100'000);
+
+        std::vector<std::string> values;
+        for(std::size_t idx(0); idx < 100; ++idx)
+        {
+            std::string v(std::string(idx % 20 + 1, static_cast<char>('a' + idx % 26)) + "@m2osw.com");
+            if(idx % 3 == 0)
+            {
+                v += ':';
+            }
+            values.push_back(v);
+        }
+
+        advgetopt::validator::pointer_t regex_validator(advgetopt::validator::create("regex", {pattern}));
+        CATCH_REQUIRE(regex_validator != nullptr);
+
+        std::size_t idx(0);
+        std::size_t validator_matches(0);
+        benchmark_result_t const validator_result(run_benchmark(repeat, [&]()
+            {
+                if(regex_validator->validate(values[idx++ % values.size()]))
+                {
+                    ++validator_matches;
+                }
+            }));
+
+        std::regex const re(pattern, std::regex_constants::extended);
+        idx = 0;
+        std::size_t std_matches(0);
+        benchmark_result_t const std_result(run_benchmark(repeat, [&]()
+            {
+                if(std::regex_match(values[idx++ % values.size()], re))
+                {
+                    ++std_matches;
+                }
+            }));
+
+        // creating more validators with the same pattern reuses the
+        // compiled expression
+        //
+        benchmark_result_t const create_result(run_benchmark(1'000, [&]()
+            {
+                regex_validator = advgetopt::validator::create("regex", {pattern});
+            }));
+
+        show_result("regex validator", repeat, validator_result);
+        show_result("std::regex", repeat, std_result);
+        show_result("create regex validator (cached)", 1'000, create_result);
+
+        CATCH_REQUIRE(validator_matches == std_matches);
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+CATCH_TEST_CASE("benchmark_validator_plugins", "[benchmark]")
+{
+    CATCH_START_SECTION("benchmark_validator_plugins: built-in validator versus plugin loaded on demand")
+    {
+        auto is_loaded = [](char const * name)
+        {
+            std::pair<char const *, bool> search(name, false);
+            dl_iterate_phdr([](dl_phdr_info * info, std::size_t, void * data)
+                {
+                    auto s(reinterpret_cast<std::pair<char const *, bool> *>(data));
+                    if(info->dlpi_name != nullptr
+                    && strstr(info->dlpi_name, s->first) != nullptr)
+                    {
+                        s->second = true;
+                    }
+                    return 0;
+                }, &search);
+            return search.second;
+        };
+
+        // the email plugin may already have been loaded by another test
+        //
+        bool const plugin_was_loaded(is_loaded("validator_email.so"));
+        bool const libtld_was_loaded(is_loaded("libtld"));
+
+        advgetopt::validator::pointer_t integer;
+        benchmark_result_t const builtin_result(run_benchmark(1, [&]()
+            {
+                integer = advgetopt::validator::create("integer");
+            }));
+
+        advgetopt::validator::pointer_t email;
+        benchmark_result_t const first_result(run_benchmark(1, [&]()
+            {
+                email = advgetopt::validator::create("email");
+            }));
+
+        std::size_t const repeat(1'000);
+        benchmark_result_t const next_result(run_benchmark(repeat, [&]()
+            {
+                email = advgetopt::validator::create("email");
+            }));
+
+        show_result("create integer (built-in)", 1, builtin_result);
+        show_result(plugin_was_loaded
+                        ? "create email (plugin already loaded)"
+                        : "create email (plugin loaded now)"
+                  , 1
+                  , first_result);
+        show_result("create email (plugin loaded)", repeat, next_result);
+        std::cout
+            << "--- libtld "
+            << (libtld_was_loaded ? "was" : "was not")
+            << " loaded before the first email validator was created.\n";
+
+        CATCH_REQUIRE(integer != nullptr);
+        CATCH_REQUIRE(email != nullptr);
+        CATCH_REQUIRE(is_loaded("validator_email.so"));
+        CATCH_REQUIRE(is_loaded("libtld"));
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("benchmark_emails", "[benchmark]")
+{
+    CATCH_START_SECTION("benchmark_emails: validate 20,000 addresses sharing a few domains")
+    {
+        char const * const domains[] = {
+              "example.com"
+            , "example.net"
+            , "example.org"
+            , "m2osw.com"
+            , "snapwebsites.org"
+            , "mail.example.co.uk"
+        };
+
+        std::size_t const count(20'000);
+        advgetopt::string_list_t addresses;
+        addresses.reserve(count);
+        for(std::size_t idx(0); idx < count; ++idx)
+        {
+            addresses.push_back(
+                      "user" + std::to_string(idx)
+                    + "@"
+                    + domains[idx % std::size(domains)]);
+        }
+
+        advgetopt::validator::pointer_t email(advgetopt::validator::create("email"));
+        CATCH_REQUIRE(email != nullptr);
+
+        // without the cache, each address goes through libtld
+        //
+        advgetopt::validator_email::set_domain_cache_size(0);
+        bool uncached_valid(true);
+        benchmark_result_t const uncached_result(run_benchmark(1, [&]()
+            {
+                for(auto const & a : addresses)
+                {
+                    uncached_valid = email->validate(a) && uncached_valid;
+                }
+            }));
+
+        advgetopt::validator_email::set_domain_cache_size(advgetopt::validator_email::DEFAULT_DOMAIN_CACHE_SIZE);
+        bool cached_valid(true);
+        benchmark_result_t const cached_result(run_benchmark(1, [&]()
+            {
+                for(auto const & a : addresses)
+                {
+                    cached_valid = email->validate(a) && cached_valid;
+                }
+            }));
+
+        advgetopt::validator::index_list_t invalid;
+        bool batch_valid(false);
+        benchmark_result_t const batch_result(run_benchmark(1, [&]()
+            {
+                batch_valid = email->validate_batch(addresses, invalid);
+            }));
+
+        show_result("20,000 emails (no cache)", 1, uncached_result);
+        show_result("20,000 emails (domain cache)", 1, cached_result);
+        show_result("20,000 emails (batch)", 1, batch_result);
+        std::cout
+            << "--- emails per second (no cache / cache / batch): "
+            << static_cast<std::int64_t>(count / uncached_result.f_seconds)
+            << " / "
+            << static_cast<std::int64_t>(count / cached_result.f_seconds)
+            << " / "
+            << static_cast<std::int64_t>(count / batch_result.f_seconds)
+            << "\n";
+
+        CATCH_REQUIRE(uncached_valid);
+        CATCH_REQUIRE(cached_valid);
+        CATCH_REQUIRE(batch_valid);
+        CATCH_REQUIRE(invalid.empty());
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+CATCH_TEST_CASE("benchmark_published_values", "[benchmark]")
+{
+    CATCH_START_SECTION("benchmark_published_values: 4 readers and 1 writer on a dynamic option")
+    {
+        // this benchmark is also a stress test which is expected to be
+        // clean when run with the thread sanitizer (-fsanitize=thread)
+        //
+        advgetopt::option_info range("range");
+        range.add_flag(advgetopt::GETOPT_FLAG_DYNAMIC_CONFIGURATION);
+        range.add_flag(advgetopt::GETOPT_FLAG_REQUIRED);
+        range.add_flag(advgetopt::GETOPT_FLAG_MULTIPLE);
+        range.set_multiple_separators(advgetopt::string_list_t{","});
+
+        std::size_t const reader_count(4);
+        std::int64_t const updates(20'000);
+        std::atomic<bool> done(false);
+        std::atomic<std::size_t> reads(0);
+        std::atomic<std::size_t> inconsistencies(0);
+
+        std::vector<std::thread> readers;
+        for(std::size_t r(0); r < reader_count; ++r)
+        {
+            readers.emplace_back([&]()
+                {
+                    std::size_t count(0);
+                    std::size_t errors(0);
+                    advgetopt::option_info::generation_t last(0);
+                    while(!done.load(std::memory_order_relaxed))
+                    {
+                        // the writer always sets "n,2n" so any other
+                        // combination means we saw a partial update
+                        //
+                        advgetopt::option_info::value_snapshot_pointer_t const values(range.get_snapshot());
+                        if(values->f_generation < last)
+                        {
+                            ++errors;
+                        }
+                        last = values->f_generation;
+                        if(values->f_value.size() == 2)
+                        {
+                            if(!values->f_integer[0].has_value()
+                            || !values->f_integer[1].has_value()
+                            || *values->f_integer[0] * 2 != *values->f_integer[1])
+                            {
+                                ++errors;
+                            }
+                        }
+                        else if(!values->f_value.empty())
+                        {
+                            ++errors;
+                        }
+                        ++count;
+                    }
+                    reads += count;
+                    inconsistencies += errors;
+                });
+        }
+
+        benchmark_result_t const writer_result(run_benchmark(1, [&]()
+            {
+                for(std::int64_t n(1); n <= updates; ++n)
+                {
+                    range.set_multiple_values(
+                              std::to_string(n) + "," + std::to_string(n * 2)
+                            , advgetopt::string_list_t()
+                            , advgetopt::option_source_t::SOURCE_DYNAMIC);
+                }
+            }));
+
+        done = true;
+        for(auto & t : readers)
+        {
+            t.join();
+        }
+
+        show_result("20,000 published updates", 1, writer_result);
+        std::cout
+            << "--- "
+            << reads
+            << " snapshots read by "
+            << reader_count
+            << " readers while updating.\n";
+
+        CATCH_REQUIRE(inconsistencies == 0);
+        advgetopt::option_info::value_snapshot_pointer_t const values(range.get_snapshot());
+        CATCH_REQUIRE(values->f_value.size() == 2);
+        CATCH_REQUIRE(values->f_integer[0] == updates);
+        CATCH_REQUIRE(values->f_integer[1] == updates * 2);
+        CATCH_REQUIRE(values->f_generation == range.get_generation());
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+CATCH_TEST_CASE("benchmark_parse_session", "[benchmark]")
+{
+    CATCH_START_SECTION("benchmark_parse_session: 100,000 command lines with getopt and parse sessions")
+    {
+        std::size_t const repeat(100'000);
+        option_table const table(50);
+        std::string const command_line(table.arguments(10));
+
+        char const * cargv[] =
+        {
+            "/usr/bin/benchmark",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = table.options();
+
+        advgetopt::getopt opt(environment_options, argc, argv);
+        benchmark_result_t const reset(run_benchmark(repeat, [&]()
+            {
+                opt.reset();
+                opt.parse_string(command_line, advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+                CATCH_REQUIRE(opt.is_defined("option-9"));
+            }));
+
+        advgetopt::parse_session session(opt);
+        benchmark_result_t const reuse(run_benchmark(repeat, [&]()
+            {
+                CATCH_REQUIRE(session.parse(command_line));
+                CATCH_REQUIRE(session.is_defined("option-9"));
+            }));
+
+        // one session per thread, all sharing the same prototype
+        //
+        std::size_t const thread_count(4);
+        std::atomic<std::size_t> errors(0);
+        benchmark_result_t const threads(run_benchmark(1, [&]()
+            {
+                std::vector<std::thread> workers;
+                for(std::size_t t(0); t < thread_count; ++t)
+                {
+                    workers.emplace_back([&]()
+                        {
+                            advgetopt::parse_session s(opt);
+                            for(std::size_t idx(0); idx < repeat; ++idx)
+                            {
+                                if(!s.parse(command_line)
+                                || !s.is_defined("option-9"))
+                                {
+                                    ++errors;
+                                }
+                            }
+                        });
+                }
+                for(auto & w : workers)
+                {
+                    w.join();
+                }
+            }));
+
+        show_result("getopt reset() + parse_string()", repeat, reset);
+        show_result("parse_session::parse()", repeat, reuse);
+        show_result("parse_session::parse() x4 threads", repeat * thread_count, threads);
+        std::cout
+            << "--- "
+            << std::fixed << std::setprecision(0)
+            << static_cast<double>(repeat) / reuse.f_seconds
+            << " lines/s with one session, "
+            << static_cast<double>(repeat * thread_count) / threads.f_seconds
+            << " lines/s with "
+            << thread_count
+            << " threads.\n";
+
+        CATCH_REQUIRE(errors == 0);
+        CATCH_REQUIRE(reuse.f_allocations < reset.f_allocations);
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+CATCH_TEST_CASE("benchmark_schema", "[benchmark]")
+{
+    CATCH_START_SECTION("benchmark_schema: getopt with its own definitions versus a shared schema")
+    {
+        std::size_t const repeat(200);
+        option_table const table(250);
+
+        char const * cargv[] =
+        {
+            "/usr/bin/benchmark",
+            "--option-3",
+            "command line value",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = table.options();
+
+        benchmark_result_t const plain(run_benchmark(repeat, [&]()
+            {
+                advgetopt::getopt opt(environment_options, argc, argv);
+                CATCH_REQUIRE(opt.get_string("option-3") == "command line value");
+            }));
+
+        advgetopt::option_schema::pointer_t const schema(std::make_shared<advgetopt::option_schema>(environment_options));
+        benchmark_result_t const shared(run_benchmark(repeat, [&]()
+            {
+                advgetopt::getopt opt(schema, argc, argv);
+                CATCH_REQUIRE(opt.get_string("option-3") == "command line value");
+            }));
+
+        show_result("getopt (own definitions)", repeat, plain);
+        show_result("getopt (shared schema)", repeat, shared);
+
+        CATCH_REQUIRE(shared.f_allocations < plain.f_allocations);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("benchmark_overlay", "[benchmark]")
+{
+    CATCH_START_SECTION("benchmark_overlay: per-request overrides on a shared getopt")
+    {
+        std::size_t const repeat(100'000);
+        option_table const table(250);
+
+        char const * cargv[] =
+        {
+            "/usr/bin/benchmark",
+            "--option-3",
+            "30",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = table.options();
+
+        advgetopt::getopt const base(environment_options, argc, argv);
+
+        std::string const timeout("option-3");
+        std::string const tenant("option-7");
+        std::string const value("5");
+        std::string const name("blue");
+
+        benchmark_result_t const empty(run_benchmark(repeat, [&]()
+            {
+                advgetopt::option_overlay overlay(base);
+                CATCH_REQUIRE(overlay.overrides() == 0);
+            }));
+
+        benchmark_result_t const overrides(run_benchmark(repeat, [&]()
+            {
+                advgetopt::option_overlay overlay(base);
+                overlay.set_value(timeout, value);
+                overlay.set_value(tenant, name);
+                CATCH_REQUIRE(overlay.try_get_long(timeout) == 5);
+                CATCH_REQUIRE(overlay.try_get_raw_string(tenant) == "blue");
+            }));
+
+        show_result("overlay (create/destroy)", repeat, empty);
+        show_result("overlay (two overrides)", repeat, overrides);
+
+        // the values are small enough to fit in the arena
+        //
+        CATCH_REQUIRE(empty.f_allocations == 0);
+        CATCH_REQUIRE(overrides.f_allocations == 0);
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
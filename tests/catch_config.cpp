@@ -995,6 +995,191 @@ CATCH_TEST_CASE("load_multiple_configurations", "[config][getopt][filenames]")
 
 
 
+CATCH_TEST_CASE("reload_configuration_files", "[config][getopt][filenames]")
+{
+    CATCH_START_SECTION("reload_configuration_files: only the configuration layer gets replaced")
+    {
+        SNAP_CATCH2_NAMESPACE::init_tmp_dir("reload", "layers");
+
+        {
+            std::ofstream config_file;
+            config_file.open(SNAP_CATCH2_NAMESPACE::g_config_filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            CATCH_REQUIRE(config_file.good());
+            config_file <<
+                "# Auto-generated\n"
+                "size=132\n"
+                "color=red\n"
+                "tags=a,b\n"
+                "verbose=true\n"
+            ;
+        }
+
+        char const * confs[] =
+        {
+            SNAP_CATCH2_NAMESPACE::g_config_filename.c_str(),
+            nullptr
+        };
+
+        char const * const separators[] {
+            ",",
+            nullptr
+        };
+
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("size")
+                , advgetopt::Flags(advgetopt::all_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("size.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("color")
+                , advgetopt::Flags(advgetopt::all_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("color.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("tags")
+                , advgetopt::Flags(advgetopt::all_flags<advgetopt::GETOPT_FLAG_REQUIRED, advgetopt::GETOPT_FLAG_MULTIPLE>())
+                , advgetopt::Help("list of tags.")
+                , advgetopt::Separators(separators)
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("verbose")
+                , advgetopt::Flags(advgetopt::standalone_all_flags<>())
+                , advgetopt::Help("verbose.")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "reload";
+        environment_options.f_options = options;
+        environment_options.f_environment_flags = advgetopt::GETOPT_ENVIRONMENT_FLAG_RELOAD_CONFIGURATION;
+        environment_options.f_help_header = "Testing reloading configuration files";
+        environment_options.f_configuration_files = confs;
+
+        char const * cargv[] =
+        {
+            "/usr/bin/reload",
+            "--color",
+            "blue",
+            "--tags",
+            "c",
+            "--verbose=false",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::getopt opt(environment_options, argc, argv);
+
+        CATCH_REQUIRE(opt.get_string("size") == "132");
+        CATCH_REQUIRE(opt.get_string("color") == "blue");
+        CATCH_REQUIRE(opt.size("tags") == 3);
+        CATCH_REQUIRE(opt.get_string("tags", 0) == "a");
+        CATCH_REQUIRE(opt.get_string("tags", 1) == "b");
+        CATCH_REQUIRE(opt.get_string("tags", 2) == "c");
+        CATCH_REQUIRE_FALSE(opt.is_defined("verbose"));
+
+        int size_calls(0);
+        opt.get_option("size")->add_callback([&size_calls](advgetopt::option_info const & size)
+            {
+                CATCH_REQUIRE(size.get_name() == "size");
+                ++size_calls;
+            });
+        int batch_calls(0);
+        opt.add_batch_callback([&batch_calls](advgetopt::getopt const &, advgetopt::option_info::vector_t const & changed)
+            {
+                ++batch_calls;
+                CATCH_REQUIRE(changed.size() == 2);
+            });
+        advgetopt::option_info::generation_t const generation(opt.get_global_generation());
+
+        {
+            std::ofstream config_file;
+            config_file.open(SNAP_CATCH2_NAMESPACE::g_config_filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            CATCH_REQUIRE(config_file.good());
+            config_file <<
+                "# Auto-generated\n"
+                "size=200\n"
+                "color=green\n"
+                "tags=x\n"
+                "verbose=true\n"
+            ;
+        }
+
+        // the command line values keep their priority
+        //
+        advgetopt::option_info::vector_t const changed(opt.reload_configuration_files());
+        CATCH_REQUIRE(changed.size() == 2);
+        CATCH_REQUIRE(opt.get_string("size") == "200");
+        CATCH_REQUIRE(opt.get_string("color") == "blue");
+        CATCH_REQUIRE(opt.size("tags") == 2);
+        CATCH_REQUIRE(opt.get_string("tags", 0) == "x");
+        CATCH_REQUIRE(opt.get_string("tags", 1) == "c");
+        CATCH_REQUIRE_FALSE(opt.is_defined("verbose"));
+        CATCH_REQUIRE(opt.get_option("size")->source() == advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        CATCH_REQUIRE(opt.get_option("tags")->source() == advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+
+        // the changes were published once
+        //
+        CATCH_REQUIRE(size_calls == 1);
+        CATCH_REQUIRE(batch_calls == 1);
+        CATCH_REQUIRE(opt.get_global_generation() == generation + 1);
+        CATCH_REQUIRE(opt.get_option("size")->get_generation() == generation + 1);
+        CATCH_REQUIRE(opt.get_option("tags")->get_generation() == generation + 1);
+
+        // nothing changed on disk, nothing changes in memory
+        //
+        CATCH_REQUIRE(opt.reload_configuration_files().empty());
+        CATCH_REQUIRE(size_calls == 1);
+        CATCH_REQUIRE(batch_calls == 1);
+        CATCH_REQUIRE(opt.get_global_generation() == generation + 1);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("reload_configuration_files: the layers must be kept")
+    {
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("size")
+                , advgetopt::Flags(advgetopt::all_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("size.")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "reload";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Testing reloading configuration files";
+
+        char const * cargv[] =
+        {
+            "/usr/bin/reload",
+            "--size",
+            "33",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::getopt opt(environment_options, argc, argv);
+        CATCH_REQUIRE_FALSE(opt.get_option("size")->get_keep_layers());
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  opt.reload_configuration_files()
+                , advgetopt::getopt_logic_error
+                , Catch::Matchers::ExceptionMessage(
+                              "getopt_logic_error: reload_configuration_files() requires the GETOPT_ENVIRONMENT_FLAG_RELOAD_CONFIGURATION flag."));
+        CATCH_REQUIRE(opt.get_string("size") == "33");
+    }
+    CATCH_END_SECTION()
+}
+
+
+
 CATCH_TEST_CASE("load_invalid_configuration_file", "[config][getopt][filenames][invalid]")
 {
     CATCH_START_SECTION("load_invalid_configuration_file: load with unexpected parameter name (one letter--dynamic allowed)")
@@ -462,6 +462,60 @@ CATCH_TEST_CASE("config_reload_tests", "[config][getopt][valid]")
         }
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("config_reload_tests: reset one file, the others remain cached")
+    {
+        SNAP_CATCH2_NAMESPACE::init_tmp_dir("reload", "reset-one");
+        std::string const first_filename(SNAP_CATCH2_NAMESPACE::g_config_filename);
+        SNAP_CATCH2_NAMESPACE::init_tmp_dir("reload", "keep-other");
+        std::string const other_filename(SNAP_CATCH2_NAMESPACE::g_config_filename);
+
+        {
+            std::ofstream config_file;
+            config_file.open(first_filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            CATCH_REQUIRE(config_file.good());
+            config_file <<
+                "# Auto-generated\n"
+                "param=before\n"
+            ;
+        }
+        {
+            std::ofstream config_file;
+            config_file.open(other_filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            CATCH_REQUIRE(config_file.good());
+            config_file <<
+                "# Auto-generated\n"
+                "param=other\n"
+            ;
+        }
+
+        advgetopt::conf_file_setup first_setup(first_filename);
+        advgetopt::conf_file_setup other_setup(other_filename);
+        advgetopt::conf_file::pointer_t first(advgetopt::conf_file::get_conf_file(first_setup));
+        advgetopt::conf_file::pointer_t other(advgetopt::conf_file::get_conf_file(other_setup));
+        CATCH_REQUIRE(first->get_parameter("param") == "before");
+        CATCH_REQUIRE(other->get_parameter("param") == "other");
+
+        {
+            std::ofstream config_file;
+            config_file.open(first_filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            CATCH_REQUIRE(config_file.good());
+            config_file <<
+                "# Auto-generated\n"
+                "param=after\n"
+            ;
+        }
+
+        advgetopt::conf_file::reset_conf_file(first_setup.get_filename());
+
+        advgetopt::conf_file::pointer_t reloaded(advgetopt::conf_file::get_conf_file(first_setup));
+        CATCH_REQUIRE(reloaded != first);
+        CATCH_REQUIRE(reloaded->get_parameter("param") == "after");
+        CATCH_REQUIRE(first->get_parameter("param") == "before");
+
+        CATCH_REQUIRE(advgetopt::conf_file::get_conf_file(other_setup) == other);
+    }
+    CATCH_END_SECTION()
 }
 
 
@@ -742,6 +796,98 @@ CATCH_TEST_CASE("config_callback_calls", "[config][getopt][valid]")
         CATCH_REQUIRE(file->was_modified());
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("config_callback_calls: callbacks attached to a parameter name")
+    {
+        SNAP_CATCH2_NAMESPACE::init_tmp_dir("callback-variable", "named-callback");
+
+        {
+            std::ofstream config_file;
+            config_file.open(SNAP_CATCH2_NAMESPACE::g_config_filename, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            CATCH_REQUIRE(config_file.good());
+            config_file <<
+                "# Auto-generated\n"
+                "color = red\n"
+                "size  = large\n"
+            ;
+        }
+
+        advgetopt::conf_file_setup setup(SNAP_CATCH2_NAMESPACE::g_config_filename
+                            , advgetopt::line_continuation_t::line_continuation_single_line
+                            , advgetopt::ASSIGNMENT_OPERATOR_EQUAL
+                            , advgetopt::COMMENT_SHELL
+                            , advgetopt::SECTION_OPERATOR_NONE);
+
+        advgetopt::conf_file::pointer_t file(advgetopt::conf_file::get_conf_file(setup));
+
+        std::vector<std::string> calls;
+        auto const record = [&calls](std::string const & who)
+        {
+            return [&calls, who](advgetopt::conf_file::pointer_t
+                               , advgetopt::callback_action_t
+                               , std::string const & name
+                               , std::string const & value)
+            {
+                calls.push_back(who + ':' + name + '=' + value);
+            };
+        };
+
+        advgetopt::conf_file::callback_id_t const color_id(file->add_callback(record("color"), "color"));
+        advgetopt::conf_file::callback_id_t const all_id(file->add_callback(record("all")));
+        advgetopt::conf_file::callback_id_t const new_param_id(file->add_callback(record("new"), "new_param"));
+        CATCH_REQUIRE(color_id != all_id);
+        CATCH_REQUIRE(all_id != new_param_id);
+
+        CATCH_REQUIRE(file->set_parameter(std::string(), "size", "small"));
+        CATCH_REQUIRE(calls == std::vector<std::string>{"all:size=small"});
+        calls.clear();
+
+        CATCH_REQUIRE(file->set_parameter(std::string(), "color", "blue"));
+        CATCH_REQUIRE(calls == std::vector<std::string>{"all:color=blue", "color:color=blue"});
+        calls.clear();
+
+        // the name given to add_callback() is canonicalized
+        //
+        CATCH_REQUIRE(file->set_parameter(std::string(), "new-param", "set"));
+        CATCH_REQUIRE(calls == std::vector<std::string>{"all:new-param=set", "new:new-param=set"});
+        calls.clear();
+
+        CATCH_REQUIRE(file->erase_parameter("color"));
+        CATCH_REQUIRE(calls == std::vector<std::string>{"all:color=", "color:color="});
+        calls.clear();
+
+        file->remove_callback(all_id);
+        CATCH_REQUIRE(file->set_parameter(std::string(), "color", "green"));
+        CATCH_REQUIRE(calls == std::vector<std::string>{"color:color=green"});
+        calls.clear();
+
+        // a callback can remove itself while running; it is still
+        // called once since the list was already loaded
+        //
+        advgetopt::conf_file::callback_id_t once_id(0);
+        once_id = file->add_callback(
+                  [&calls, &once_id](advgetopt::conf_file::pointer_t f
+                                   , advgetopt::callback_action_t
+                                   , std::string const & name
+                                   , std::string const &)
+                  {
+                      calls.push_back("once:" + name);
+                      f->remove_callback(once_id);
+                  }
+                , "size");
+        CATCH_REQUIRE(file->set_parameter(std::string(), "size", "medium"));
+        CATCH_REQUIRE(file->set_parameter(std::string(), "size", "huge"));
+        CATCH_REQUIRE(calls == std::vector<std::string>{"once:size"});
+        calls.clear();
+
+        file->remove_callback(color_id);
+        file->remove_callback(new_param_id);
+        file->remove_callback(new_param_id);
+        CATCH_REQUIRE(file->set_parameter(std::string(), "color", "white"));
+        CATCH_REQUIRE(file->set_parameter(std::string(), "new_param", "unnoticed"));
+        CATCH_REQUIRE(calls.empty());
+    }
+    CATCH_END_SECTION()
 }
 
 
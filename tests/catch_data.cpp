@@ -767,6 +767,210 @@ CATCH_TEST_CASE("double_access", "[arguments][valid][getopt]")
 
 
 
+CATCH_TEST_CASE("try_get_access", "[arguments][valid][getopt]")
+{
+    CATCH_START_SECTION("try_get_access: verify the non-throwing accessors")
+    {
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("size")
+                , advgetopt::ShortName('s')
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("define the size.")
+                , advgetopt::DefaultValue("33")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("ratio")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("define the ratio.")
+                , advgetopt::DefaultValue("0.25")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("names")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED
+                                                          , advgetopt::GETOPT_FLAG_MULTIPLE>())
+                , advgetopt::Help("define names.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("level")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("define a level.")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Usage: test try_get_...() functions";
+
+        char const * cargv[] =
+        {
+            "/usr/bin/arguments",
+            "--size",
+            "9821",
+            "--names",
+            "alpha",
+            "7",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::getopt opt(environment_options, argc, argv);
+
+        // a defined value
+        //
+        CATCH_REQUIRE(opt.try_get_long("size") == 9821L);
+        CATCH_REQUIRE(opt.try_get_long("s") == 9821L);
+        CATCH_REQUIRE(opt.try_get_long("size", 0, 0, 10000) == 9821L);
+        CATCH_REQUIRE_FALSE(opt.try_get_long("size", 0, 0, 100).has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_long("size", 1).has_value());
+        CATCH_REQUIRE(opt.try_get_string("size") == std::string("9821"));
+        CATCH_REQUIRE(opt.try_get_raw_string("size") == std::string_view("9821"));
+        CATCH_REQUIRE_FALSE(opt.try_get_string("size", 1).has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_raw_string("size", 1).has_value());
+        CATCH_REQUIRE(opt.try_get_double("size") == 9821.0);
+
+        // a value which is not defined returns the default
+        //
+        CATCH_REQUIRE(opt.try_get_double("ratio") == 0.25);
+        CATCH_REQUIRE_FALSE(opt.try_get_double("ratio", 0, 0.5, 1.0).has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_long("ratio").has_value());
+        CATCH_REQUIRE(opt.try_get_string("ratio") == std::string("0.25"));
+        CATCH_REQUIRE(opt.try_get_raw_string("ratio") == std::string_view("0.25"));
+
+        // multiple values, one of which is not a number
+        //
+        CATCH_REQUIRE(opt.try_get_string("names", 0) == std::string("alpha"));
+        CATCH_REQUIRE(opt.try_get_string("names", 1) == std::string("7"));
+        CATCH_REQUIRE_FALSE(opt.try_get_string("names", 2).has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_string("names", -1).has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_long("names", 0).has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_double("names", 0).has_value());
+
+        // only the requested value needs to be a valid number
+        //
+        CATCH_REQUIRE(opt.try_get_long("names", 1) == 7L);
+        CATCH_REQUIRE(opt.try_get_double("names", 1) == 7.0);
+
+        // no value and no default
+        //
+        CATCH_REQUIRE_FALSE(opt.try_get_long("level").has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_double("level").has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_string("level").has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_raw_string("level").has_value());
+
+        // options that do not exist
+        //
+        CATCH_REQUIRE_FALSE(opt.try_get_long("unknown").has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_double("unknown").has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_string("unknown").has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_raw_string("unknown").has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_long("").has_value());
+        CATCH_REQUIRE_FALSE(opt.try_get_string("").has_value());
+
+        // none of the above generated an error
+        //
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+
+        // option_info level
+        //
+        advgetopt::option_info::pointer_t names(opt.get_option("names"));
+        CATCH_REQUIRE(names != nullptr);
+        CATCH_REQUIRE(names->try_get_value(0) == std::string("alpha"));
+        CATCH_REQUIRE(names->try_get_raw_value(1) == std::string_view("7"));
+        CATCH_REQUIRE_FALSE(names->try_get_value(2).has_value());
+        CATCH_REQUIRE_FALSE(names->try_get_raw_value(2).has_value());
+        CATCH_REQUIRE_FALSE(names->try_get_long(0).has_value());
+        CATCH_REQUIRE(names->try_get_long(1) == 7L);
+        CATCH_REQUIRE_FALSE(names->try_get_long(5).has_value());
+        CATCH_REQUIRE_FALSE(names->try_get_double(5).has_value());
+        CATCH_REQUIRE_FALSE(names->try_get_long(-1).has_value());
+
+        // once fixed, the conversion works
+        //
+        names->set_value(0, "-3", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        CATCH_REQUIRE(names->try_get_long(0) == -3L);
+        CATCH_REQUIRE(names->try_get_long(1) == 7L);
+        CATCH_REQUIRE(names->try_get_double(1) == 7.0);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("try_get_access: before parsing and with views")
+    {
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("buffer-size")
+                , advgetopt::ShortName('b')
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("define the size of the buffer.")
+                , advgetopt::DefaultValue("4096")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("files")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_MULTIPLE
+                                                          , advgetopt::GETOPT_FLAG_DEFAULT_OPTION>())
+                , advgetopt::Help("list of files.")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Usage: test try_get_...() functions";
+
+        // the parser is not done yet, the functions do not throw
+        //
+        {
+            advgetopt::getopt opt(environment_options);
+
+            CATCH_REQUIRE_FALSE(opt.try_get_long("buffer-size").has_value());
+            CATCH_REQUIRE_FALSE(opt.try_get_double("buffer-size").has_value());
+            CATCH_REQUIRE_FALSE(opt.try_get_string("buffer-size").has_value());
+            CATCH_REQUIRE_FALSE(opt.try_get_raw_string("buffer-size").has_value());
+        }
+
+        char const * cargv[] =
+        {
+            "/usr/bin/arguments",
+            "--buffer-size",
+            "1024",
+            "one.txt",
+            "two.txt",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::getopt opt(environment_options, argc, argv);
+
+        // the name can be a view and use underscores
+        //
+        std::string const line("--buffer_size=2048");
+        std::string_view const name(std::string_view(line).substr(2, 11));
+        CATCH_REQUIRE(name == "buffer_size");
+        CATCH_REQUIRE(opt.try_get_long(name) == 1024L);
+        CATCH_REQUIRE(opt.try_get_long(name.substr(0, 6)) == std::nullopt);
+        CATCH_REQUIRE(opt.try_get_raw_string(std::string_view("buffer-size")) == std::string_view("1024"));
+        CATCH_REQUIRE(opt.find_option("buffer_size") == opt.get_option("buffer-size"));
+        CATCH_REQUIRE(opt.find_option("b") == opt.get_option("buffer-size"));
+        CATCH_REQUIRE(opt.find_option(std::string_view()) == nullptr);
+
+        // the default option is found with "--"
+        //
+        CATCH_REQUIRE(opt.find_option("--") == opt.get_option("files"));
+        CATCH_REQUIRE(opt.try_get_string("--", 1) == std::string("two.txt"));
+        CATCH_REQUIRE_FALSE(opt.try_get_string("--", 2).has_value());
+    }
+    CATCH_END_SECTION()
+}
+
+
+
 CATCH_TEST_CASE("system_flags_version", "[arguments][valid][getopt][system_flags]")
 {
     CATCH_START_SECTION("system_flags_version: check with the --version system flag")
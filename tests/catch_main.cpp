@@ -28,6 +28,7 @@
 // advgetopt
 //
 #include    <advgetopt/advgetopt.h>
+#include    <advgetopt/validator.h>
 #include    <advgetopt/version.h>
 
 
@@ -114,6 +115,10 @@ int finish_init(Catch::Session & session)
 
     cppthread::set_log_callback(SNAP_CATCH2_NAMESPACE::log_for_test);
 
+    // load the validator plugins from the build directory
+    //
+    advgetopt::validator::set_plugins_path(ADVGETOPT_TEST_PLUGINS_PATH);
+
     char const * options(getenv("ADVGETOPT_TEST_OPTIONS"));
     if(options != nullptr
     && *options != '\0')
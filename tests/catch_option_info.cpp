@@ -25,6 +25,7 @@
 // advgetopt
 //
 #include    <advgetopt/exception.h>
+#include    <advgetopt/validator_address.h>
 
 
 // C++
@@ -183,6 +184,35 @@ CATCH_TEST_CASE("option_info_basics", "[option_info][valid][basic]")
         CATCH_REQUIRE_FALSE(explicit_default.is_default_option());
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("option_info_basics: definition copied only once shared")
+    {
+        advgetopt::option_info size("size", 's');
+
+        // not shared, the setters do not create a new definition
+        //
+        advgetopt::option_info::definition_t const * const original(size.get_definition().get());
+        size.set_help("the size.");
+        size.set_default("33");
+        size.add_flag(advgetopt::GETOPT_FLAG_REQUIRED);
+        CATCH_REQUIRE(size.get_definition().get() == original);
+
+        // shared, the first setter makes a copy, the next ones reuse it
+        //
+        advgetopt::option_info::definition_pointer_t const shared(size.get_definition());
+        size.set_help("the new size.");
+        advgetopt::option_info::definition_t const * const copy(size.get_definition().get());
+        CATCH_REQUIRE(copy != shared.get());
+        size.set_default("55");
+        CATCH_REQUIRE(size.get_definition().get() == copy);
+
+        CATCH_REQUIRE(shared->f_help == "the size.");
+        CATCH_REQUIRE(shared->f_default_value == "33");
+        CATCH_REQUIRE(size.get_help() == "the new size.");
+        CATCH_REQUIRE(size.get_default() == "55");
+        CATCH_REQUIRE(size.has_flag(advgetopt::GETOPT_FLAG_REQUIRED));
+    }
+    CATCH_END_SECTION()
 }
 
 
@@ -595,6 +625,123 @@ CATCH_TEST_CASE("option_info_validator", "[option_info][valid][validator]")
         CATCH_REQUIRE(auto_validate.get_value(2) == "zoc");
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("option_info_validator: check integer validator with many values")
+    {
+        advgetopt::option_info auto_validate("validator", 'C');
+
+        auto_validate.add_flag(advgetopt::GETOPT_FLAG_MULTIPLE);
+
+        advgetopt::string_list_t list{","};
+        auto_validate.set_multiple_separators(list);
+
+        auto_validate.set_validator("integer(-100...100)");
+        CATCH_REQUIRE(auto_validate.get_validator() != nullptr);
+        CATCH_REQUIRE(auto_validate.get_validator()->name() == "integer");
+
+        std::string values;
+        for(int idx(-100); idx <= 100; ++idx)
+        {
+            values += std::to_string(idx);
+            values += ',';
+        }
+        values += "0x40";
+        CATCH_REQUIRE(auto_validate.set_multiple_values(values, advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(auto_validate.size() == 202);
+        for(int idx(-100); idx <= 100; ++idx)
+        {
+            CATCH_REQUIRE(auto_validate.get_long(idx + 100) == idx);
+        }
+        CATCH_REQUIRE(auto_validate.get_long(201) == 64);
+
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: input \"101\" given to parameter --validator is not considered valid: out of range.");
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: input \"1a\" given to parameter --validator is not considered valid: not a valid number.");
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: input \"-0x65\" given to parameter --validator is not considered valid: out of range.");
+        CATCH_REQUIRE_FALSE(auto_validate.set_multiple_values("5,101,-7,1a,-0x64,-0x65,100", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+        CATCH_REQUIRE(auto_validate.size() == 4);
+        CATCH_REQUIRE(auto_validate.get_long(0) == 5);
+        CATCH_REQUIRE(auto_validate.get_long(1) == -7);
+        CATCH_REQUIRE(auto_validate.get_long(2) == -100);
+        CATCH_REQUIRE(auto_validate.get_long(3) == 100);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("option_info_validator: options with the same validator share it")
+    {
+        advgetopt::option_info port("port");
+        advgetopt::option_info backup_port("backup-port");
+        advgetopt::option_info count("count");
+
+        port.set_validator("integer(1...65535)");
+        backup_port.set_validator("integer( 1...65535 )");
+        count.set_validator("integer(1...100)");
+
+        CATCH_REQUIRE(port.get_validator() != nullptr);
+        CATCH_REQUIRE(port.get_validator() == backup_port.get_validator());
+        CATCH_REQUIRE(port.get_validator() != count.get_validator());
+
+        // the error of one option does not leak in the other
+        //
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: input \"0\" given to parameter --port is not considered valid: out of range.");
+        port.set_value(0, "0", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: input \"port\" given to parameter --backup-port is not considered valid: not a valid number.");
+        backup_port.set_value(0, "port", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+
+        CATCH_REQUIRE(port.set_value(0, "80", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(backup_port.set_value(0, "8080", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(port.get_long() == 80);
+        CATCH_REQUIRE(backup_port.get_long() == 8080);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("option_info_validator: addresses are kept in binary")
+    {
+        advgetopt::option_info listen("listen");
+        listen.add_flag(advgetopt::GETOPT_FLAG_MULTIPLE);
+        listen.set_multiple_separators(advgetopt::string_list_t{","});
+        listen.set_validator("address(port)");
+
+        CATCH_REQUIRE(listen.set_multiple_values("127.0.0.1:4040,[::1]:4041", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(listen.size() == 2);
+
+        advgetopt::validator_address::address_t a(listen.get_address(0));
+        CATCH_REQUIRE(a.is_ipv4());
+        CATCH_REQUIRE(a.f_address[12] == 127);
+        CATCH_REQUIRE(a.f_address[15] == 1);
+        CATCH_REQUIRE(a.f_port == 4040);
+
+        a = listen.get_address(1);
+        CATCH_REQUIRE_FALSE(a.is_ipv4());
+        CATCH_REQUIRE(a.f_address[15] == 1);
+        CATCH_REQUIRE(a.f_port == 4041);
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  listen.get_address(2)
+                , advgetopt::getopt_undefined
+                , Catch::Matchers::ExceptionMessage(
+                          "getopt_exception: option_info::get_address(): no value at index 2 (idx >= 2) for --listen so you can't get this value."));
+
+        // the cache is reset when the value changes
+        //
+        CATCH_REQUIRE(listen.set_value(0, "10.0.0.1:80", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        a = listen.get_address(0);
+        CATCH_REQUIRE(a.f_address[12] == 10);
+        CATCH_REQUIRE(a.f_port == 80);
+
+        // without a validator, the conversion can fail
+        //
+        advgetopt::option_info peer("peer");
+        peer.set_value(0, "not-an-address", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: invalid address (not-an-address) in parameter --peer at offset 0.");
+        a = peer.get_address();
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+        CATCH_REQUIRE_FALSE(a.is_ipv4());
+        CATCH_REQUIRE(a.f_port == -1);
+    }
+    CATCH_END_SECTION()
 }
 
 
@@ -1077,6 +1224,162 @@ CATCH_TEST_CASE("option_info_set_value", "[option_info][valid][set][multiple]")
 
 
 
+CATCH_TEST_CASE("option_info_array", "[option_info][valid][array]")
+{
+    CATCH_START_SECTION("option_info_array: values with keys")
+    {
+        advgetopt::option_info map("map");
+        map.add_flag(advgetopt::GETOPT_FLAG_ARRAY);
+
+        CATCH_REQUIRE(map.set_value(0, "red", {"color"}, advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(map.size() == 1);
+        CATCH_REQUIRE(map.get_value(0) == "color:red");
+
+        CATCH_REQUIRE(map.set_value(0, "large", {"size", "width:"}, advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(map.size() == 3);
+        CATCH_REQUIRE(map.get_value(1) == "size:large");
+        CATCH_REQUIRE(map.get_value(2) == "width:large");
+
+        CATCH_REQUIRE(map.find_value_index_by_key("color") == 0);
+        CATCH_REQUIRE(map.find_value_index_by_key("color:") == 0);
+        CATCH_REQUIRE(map.find_value_index_by_key("size") == 1);
+        CATCH_REQUIRE(map.find_value_index_by_key("width") == 2);
+        CATCH_REQUIRE(map.find_value_index_by_key("height") == -1);
+        CATCH_REQUIRE(map.find_value_index_by_key("colo") == -1);
+        CATCH_REQUIRE(map.find_value_index_by_key("color", 1) == -1);
+        CATCH_REQUIRE(map.find_value_index_by_key("width", 100) == -1);
+
+        // replace an existing key
+        //
+        CATCH_REQUIRE(map.set_value(0, "blue", {"color"}, advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(map.size() == 3);
+        CATCH_REQUIRE(map.get_value(0) == "color:blue");
+        CATCH_REQUIRE(map.find_value_index_by_key("color") == 0);
+
+        // many keys
+        //
+        for(int idx(0); idx < 5000; ++idx)
+        {
+            CATCH_REQUIRE(map.set_value(
+                      0
+                    , std::to_string(idx * 2)
+                    , {"k" + std::to_string(idx)}
+                    , advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        }
+        CATCH_REQUIRE(map.size() == 5003);
+        CATCH_REQUIRE(map.find_value_index_by_key("k4321") == 3 + 4321);
+        CATCH_REQUIRE(map.get_value(3 + 4321) == "k4321:8642");
+        CATCH_REQUIRE(map.find_value_index_by_key("k5000") == -1);
+
+        // keys which include a colon are searched linearly
+        //
+        CATCH_REQUIRE(map.set_value(0, "1", {"a:b"}, advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(map.get_value(5003) == "a:b:1");
+        CATCH_REQUIRE(map.find_value_index_by_key("a:b") == 5003);
+        CATCH_REQUIRE(map.find_value_index_by_key("a") == 5003);
+
+        map.reset();
+        CATCH_REQUIRE(map.size() == 0);
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  map.find_value_index_by_key("color")
+                , advgetopt::getopt_undefined
+                , Catch::Matchers::ExceptionMessage(
+                          "getopt_exception: option_info::find_value_index_by_key(): --map has no values defined."));
+
+        CATCH_REQUIRE(map.set_value(0, "green", {"color"}, advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(map.find_value_index_by_key("color") == 0);
+        CATCH_REQUIRE(map.find_value_index_by_key("size") == -1);
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  map.find_value_index_by_key("color", -1)
+                , advgetopt::getopt_logic_error
+                , Catch::Matchers::ExceptionMessage(
+                          "getopt_logic_error: idx cannot be negative in find_value_index_by_key()"));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("option_info_array: keys with an ending colon work as before")
+    {
+        // before the values were saved as "<key>:<value>", the only way
+        // for a lookup to work was to include the colon in the key; such
+        // keys still give the exact same values and lookups
+        //
+        advgetopt::option_info map("map");
+        map.add_flag(advgetopt::GETOPT_FLAG_ARRAY);
+
+        CATCH_REQUIRE(map.set_value(0, "red", {"color:"}, advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(map.set_value(0, "large", {"size:"}, advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(map.size() == 2);
+        CATCH_REQUIRE(map.get_value(0) == "color:red");
+        CATCH_REQUIRE(map.get_value(1) == "size:large");
+
+        CATCH_REQUIRE(map.find_value_index_by_key("color:") == 0);
+        CATCH_REQUIRE(map.find_value_index_by_key("size:") == 1);
+        CATCH_REQUIRE(map.find_value_index_by_key("color") == 0);
+        CATCH_REQUIRE(map.find_value_index_by_key("size") == 1);
+
+        // with or without the colon, it is the same key
+        //
+        CATCH_REQUIRE(map.set_value(0, "blue", {"color"}, advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(map.size() == 2);
+        CATCH_REQUIRE(map.get_value(0) == "color:blue");
+        CATCH_REQUIRE(map.find_value_index_by_key("color:") == 0);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("option_info_array: multiple values with keys")
+    {
+        advgetopt::option_info map("map");
+        map.add_flag(advgetopt::GETOPT_FLAG_ARRAY | advgetopt::GETOPT_FLAG_MULTIPLE);
+        map.set_multiple_separators(advgetopt::string_list_t{","});
+
+        CATCH_REQUIRE(map.set_multiple_values("a,b", {"x", "y"}, advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(map.size() == 4);
+        CATCH_REQUIRE(map.get_value(0) == "x:a");
+        CATCH_REQUIRE(map.get_value(1) == "x:b");
+        CATCH_REQUIRE(map.get_value(2) == "y:a");
+        CATCH_REQUIRE(map.get_value(3) == "y:b");
+
+        CATCH_REQUIRE(map.find_value_index_by_key("x") == 0);
+        CATCH_REQUIRE(map.find_value_index_by_key("x", 1) == 1);
+        CATCH_REQUIRE(map.find_value_index_by_key("x", 2) == -1);
+        CATCH_REQUIRE(map.find_value_index_by_key("y") == 2);
+        CATCH_REQUIRE(map.find_value_index_by_key("y", 3) == 3);
+
+        // add_value() appends even if the key exists
+        //
+        CATCH_REQUIRE(map.add_value("c", {"x"}, advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(map.size() == 5);
+        CATCH_REQUIRE(map.get_value(4) == "x:c");
+        CATCH_REQUIRE(map.find_value_index_by_key("x") == 0);
+        CATCH_REQUIRE(map.find_value_index_by_key("x", 2) == 4);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("option_info_array: invalid values are removed from the index")
+    {
+        advgetopt::option_info map("map");
+        map.add_flag(advgetopt::GETOPT_FLAG_ARRAY);
+        map.set_validator("/^[a-z]+:[0-9]+$/");
+
+        CATCH_REQUIRE(map.set_value(0, "10", {"first"}, advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(map.find_value_index_by_key("first") == 0);
+
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: input \"second:ten\" given to parameter --map is not considered valid: did not match the regex.");
+        CATCH_REQUIRE_FALSE(map.set_value(0, "ten", {"second"}, advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+
+        CATCH_REQUIRE(map.size() == 1);
+        CATCH_REQUIRE(map.find_value_index_by_key("second") == -1);
+
+        CATCH_REQUIRE(map.set_value(0, "20", {"third"}, advgetopt::option_source_t::SOURCE_COMMAND_LINE));
+        CATCH_REQUIRE(map.find_value_index_by_key("third") == 1);
+    }
+    CATCH_END_SECTION()
+}
+
+
+
 CATCH_TEST_CASE("option_info_section_functions", "[option_info][valid][add][section]")
 {
     CATCH_START_SECTION("option_info_section_functions: value without sections")
@@ -1723,8 +2026,540 @@ CATCH_TEST_CASE("check_option_callbacks", "[arguments][getopt][config][callback]
         print->set_value(0, "cmyk");
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("check_option_callbacks: update the callbacks from a callback")
+    {
+        advgetopt::option_info print("print");
+        print.add_flag(advgetopt::GETOPT_FLAG_DYNAMIC_CONFIGURATION);
+
+        int first(0);
+        int second(0);
+        advgetopt::option_info::callback_id_t first_id(0);
+        first_id = print.add_callback([&](advgetopt::option_info const &)
+            {
+                ++first;
+                print.remove_callback(first_id);
+                print.add_callback([&second](advgetopt::option_info const & opt)
+                    {
+                        CATCH_REQUIRE(opt.get_name() == "print");
+                        ++second;
+                    });
+            });
+
+        // the new callback is not called on the change that added it
+        //
+        print.set_value(0, "color");
+        CATCH_REQUIRE(first == 1);
+        CATCH_REQUIRE(second == 0);
+
+        print.set_value(0, "black & white");
+        CATCH_REQUIRE(first == 1);
+        CATCH_REQUIRE(second == 1);
+
+        print.set_value(0, "stipple");
+        CATCH_REQUIRE(first == 1);
+        CATCH_REQUIRE(second == 2);
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+CATCH_TEST_CASE("check_option_generations", "[option_info][valid][generation]")
+{
+    CATCH_START_SECTION("check_option_generations: each change increments the generations")
+    {
+        advgetopt::option_info print("print");
+        print.add_flag(advgetopt::GETOPT_FLAG_DYNAMIC_CONFIGURATION);
+        print.add_flag(advgetopt::GETOPT_FLAG_MULTIPLE);
+
+        advgetopt::option_info size("size");
+        size.add_flag(advgetopt::GETOPT_FLAG_DYNAMIC_CONFIGURATION);
+
+        CATCH_REQUIRE(print.get_generation() == 0);
+        CATCH_REQUIRE(size.get_generation() == 0);
+
+        advgetopt::option_info::generation_t const start(advgetopt::option_info::get_global_generation());
+
+        print.set_value(0, "color");
+        advgetopt::option_info::generation_t const g1(print.get_generation());
+        CATCH_REQUIRE(g1 > start);
+        CATCH_REQUIRE(advgetopt::option_info::get_global_generation() >= g1);
+        CATCH_REQUIRE(size.get_generation() == 0);
+
+        print.add_value("black & white");
+        advgetopt::option_info::generation_t const g2(print.get_generation());
+        CATCH_REQUIRE(g2 > g1);
+
+        // setting the same value is not a change
+        //
+        print.set_value(1, "black & white");
+        CATCH_REQUIRE(print.get_generation() == g2);
+
+        size.set_value(0, "33");
+        advgetopt::option_info::generation_t const g3(size.get_generation());
+        CATCH_REQUIRE(g3 > g2);
+        CATCH_REQUIRE(print.get_generation() == g2);
+
+        print.reset();
+        CATCH_REQUIRE(print.get_generation() > g3);
+        CATCH_REQUIRE(size.get_generation() == g3);
+
+        // a reset of an undefined option is not a change
+        //
+        advgetopt::option_info::generation_t const g4(print.get_generation());
+        print.reset();
+        CATCH_REQUIRE(print.get_generation() == g4);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("check_option_generations: getopt global generation")
+    {
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("print")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_DYNAMIC_CONFIGURATION>())
+                , advgetopt::Help("output filename.")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Usage: test generations";
+
+        advgetopt::getopt opt(environment_options);
+
+        advgetopt::option_info::generation_t const start(opt.get_global_generation());
+
+        advgetopt::option_info::pointer_t print(opt.get_option("print"));
+        CATCH_REQUIRE(print != nullptr);
+        print->set_value(0, "color");
+
+        CATCH_REQUIRE(opt.get_global_generation() > start);
+        CATCH_REQUIRE(opt.get_global_generation() == print->get_generation());
+
+        // the generation is global; a change to an option which is not
+        // part of this getopt object also increments it
+        //
+        advgetopt::option_info other("other");
+        other.set_value(0, "changed", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        CATCH_REQUIRE(opt.get_global_generation() > print->get_generation());
+        CATCH_REQUIRE(opt.get_global_generation() == other.get_generation());
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("check_option_generations: values snapshot")
+    {
+        advgetopt::option_info size("size");
+        size.add_flag(advgetopt::GETOPT_FLAG_DYNAMIC_CONFIGURATION);
+
+        // no value yet
+        //
+        advgetopt::option_info::value_snapshot_pointer_t const empty(size.get_snapshot());
+        CATCH_REQUIRE(empty != nullptr);
+        CATCH_REQUIRE(empty->f_source == advgetopt::option_source_t::SOURCE_UNDEFINED);
+        CATCH_REQUIRE(empty->f_value.empty());
+
+        size.set_value(0, "33", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_DYNAMIC);
+        advgetopt::option_info::value_snapshot_pointer_t const first(size.get_snapshot());
+        CATCH_REQUIRE(first->f_source == advgetopt::option_source_t::SOURCE_DYNAMIC);
+        CATCH_REQUIRE(first->f_generation == size.get_generation());
+        CATCH_REQUIRE(first->f_value == advgetopt::string_list_t{"33"});
+        CATCH_REQUIRE(first->f_integer.size() == 1);
+        CATCH_REQUIRE(first->f_integer[0] == 33);
+        CATCH_REQUIRE(first->f_double.size() == 1);
+        CATCH_REQUIRE(first->f_double[0] == 33.0);
+
+        // the snapshot does not change until the next change
+        //
+        CATCH_REQUIRE(size.get_snapshot() == first);
+
+        size.set_value(0, "large", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_DYNAMIC);
+        advgetopt::option_info::value_snapshot_pointer_t const second(size.get_snapshot());
+        CATCH_REQUIRE(second != first);
+        CATCH_REQUIRE(second->f_generation > first->f_generation);
+        CATCH_REQUIRE(second->f_value == advgetopt::string_list_t{"large"});
+        CATCH_REQUIRE_FALSE(second->f_integer[0].has_value());
+        CATCH_REQUIRE_FALSE(second->f_double[0].has_value());
+
+        // the old snapshot is still valid and unchanged
+        //
+        CATCH_REQUIRE(first->f_value == advgetopt::string_list_t{"33"});
+
+        size.reset();
+        CATCH_REQUIRE(size.get_snapshot()->f_value.empty());
+        CATCH_REQUIRE(size.get_snapshot()->f_source == advgetopt::option_source_t::SOURCE_UNDEFINED);
+
+        // an option which is not dynamic creates its snapshot on demand
+        //
+        advgetopt::option_info ratio("ratio");
+        ratio.add_flag(advgetopt::GETOPT_FLAG_REQUIRED);
+        ratio.set_value(0, "0.5", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        advgetopt::option_info::value_snapshot_pointer_t const ratio_first(ratio.get_snapshot());
+        CATCH_REQUIRE(ratio_first->f_value == advgetopt::string_list_t{"0.5"});
+        CATCH_REQUIRE_FALSE(ratio_first->f_integer[0].has_value());
+        CATCH_REQUIRE(ratio_first->f_double[0] == 0.5);
+        CATCH_REQUIRE(ratio.get_snapshot() == ratio_first);
+
+        ratio.set_value(0, "0.75", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        CATCH_REQUIRE(ratio.get_snapshot()->f_double[0] == 0.75);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("check_option_generations: dynamic flag added after the values were set")
+    {
+        advgetopt::option_info level("level");
+        level.set_value(0, "7", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        level.add_flag(advgetopt::GETOPT_FLAG_DYNAMIC_CONFIGURATION);
+
+        advgetopt::option_info::value_snapshot_pointer_t const values(level.get_snapshot());
+        CATCH_REQUIRE(values->f_source == advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        CATCH_REQUIRE(values->f_generation == level.get_generation());
+        CATCH_REQUIRE(values->f_value == advgetopt::string_list_t{"7"});
+        CATCH_REQUIRE(values->f_integer[0] == 7);
+        CATCH_REQUIRE(level.get_snapshot() == values);
+
+        level.set_value(0, "9", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_DYNAMIC);
+        CATCH_REQUIRE(level.get_snapshot()->f_value == advgetopt::string_list_t{"9"});
+        CATCH_REQUIRE(level.get_snapshot()->f_integer[0] == 9);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("check_option_generations: appended values keep their conversions")
+    {
+        advgetopt::option_info sizes("sizes");
+        sizes.add_flag(advgetopt::GETOPT_FLAG_DYNAMIC_CONFIGURATION);
+        sizes.add_flag(advgetopt::GETOPT_FLAG_MULTIPLE);
+
+        for(int idx(0); idx < 100; ++idx)
+        {
+            sizes.add_value(std::to_string(idx), advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_DYNAMIC);
+        }
+
+        advgetopt::option_info::value_snapshot_pointer_t const values(sizes.get_snapshot());
+        CATCH_REQUIRE(values->f_value.size() == 100);
+        CATCH_REQUIRE(values->f_integer.size() == 100);
+        CATCH_REQUIRE(values->f_double.size() == 100);
+        for(int idx(0); idx < 100; ++idx)
+        {
+            CATCH_REQUIRE(values->f_value[idx] == std::to_string(idx));
+            CATCH_REQUIRE(values->f_integer[idx] == idx);
+            CATCH_REQUIRE(values->f_double[idx].has_value());
+        }
+
+        // a changed value gets converted again
+        //
+        sizes.set_value(50, "half", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_DYNAMIC);
+        advgetopt::option_info::value_snapshot_pointer_t const changed(sizes.get_snapshot());
+        CATCH_REQUIRE(changed->f_value[50] == "half");
+        CATCH_REQUIRE_FALSE(changed->f_integer[50].has_value());
+        CATCH_REQUIRE_FALSE(changed->f_double[50].has_value());
+        CATCH_REQUIRE(changed->f_integer[49] == 49);
+        CATCH_REQUIRE(changed->f_integer[51] == 51);
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+CATCH_TEST_CASE("check_dynamic_batch", "[option_info][getopt][valid][batch]")
+{
+    CATCH_START_SECTION("check_dynamic_batch: apply a batch of dynamic values")
+    {
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("ip")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED
+                                                          , advgetopt::GETOPT_FLAG_DYNAMIC_CONFIGURATION>())
+                , advgetopt::Help("the IP address.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("port")
+                , advgetopt::ShortName('p')
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED
+                                                          , advgetopt::GETOPT_FLAG_DYNAMIC_CONFIGURATION>())
+                , advgetopt::Help("the port.")
+                , advgetopt::Validator("integer(1...65535)")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("tls")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED
+                                                          , advgetopt::GETOPT_FLAG_DYNAMIC_CONFIGURATION>())
+                , advgetopt::Help("whether to use TLS.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("static")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("not a dynamic option.")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Usage: test batches";
+
+        char const * cargv[] =
+        {
+            "/usr/bin/batch",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::getopt opt(environment_options, argc, argv);
+
+        int ip_calls(0);
+        opt.get_option("ip")->add_callback([&ip_calls](advgetopt::option_info const & ip)
+            {
+                CATCH_REQUIRE(ip.get_name() == "ip");
+                ++ip_calls;
+            });
+
+        int batch_calls(0);
+        advgetopt::option_info::vector_t last_changed;
+        advgetopt::option_info::callback_id_t const id(opt.add_batch_callback(
+            [&](advgetopt::getopt const & o, advgetopt::option_info::vector_t const & changed)
+            {
+                ++batch_calls;
+                last_changed = changed;
+
+                // all the values are already visible
+                //
+                CATCH_REQUIRE(o.get_string("ip") == "10.0.0.1");
+                CATCH_REQUIRE(o.get_long("port") == 443);
+            }));
+
+        CATCH_REQUIRE(opt.set_dynamic_values({
+                  { "ip", "10.0.0.1" }
+                , { "p", "443" }
+                , { "tls", "on" }
+            }));
+        CATCH_REQUIRE(ip_calls == 1);
+        CATCH_REQUIRE(batch_calls == 1);
+        CATCH_REQUIRE(last_changed.size() == 3);
+        CATCH_REQUIRE(opt.get_string("tls") == "on");
+        CATCH_REQUIRE(opt.get_option("ip")->source() == advgetopt::option_source_t::SOURCE_DYNAMIC);
+
+        // all the options share the same generation
+        //
+        std::vector<advgetopt::option_info::value_snapshot_pointer_t> const snapshots(
+                opt.get_snapshots({ "ip", "port", "tls", "unknown" }));
+        CATCH_REQUIRE(snapshots.size() == 4);
+        CATCH_REQUIRE(snapshots[0]->f_value == advgetopt::string_list_t{"10.0.0.1"});
+        CATCH_REQUIRE(snapshots[1]->f_integer[0] == 443);
+        CATCH_REQUIRE(snapshots[2]->f_value == advgetopt::string_list_t{"on"});
+        CATCH_REQUIRE(snapshots[3] == nullptr);
+        CATCH_REQUIRE(snapshots[0]->f_generation == snapshots[1]->f_generation);
+        CATCH_REQUIRE(snapshots[0]->f_generation == snapshots[2]->f_generation);
+
+        // an invalid value rejects the whole batch
+        //
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: input \"https\" given to parameter --port is not considered valid: not a valid number.");
+        CATCH_REQUIRE_FALSE(opt.set_dynamic_values({
+                  { "ip", "10.0.0.2" }
+                , { "port", "https" }
+            }));
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+        CATCH_REQUIRE(opt.get_string("ip") == "10.0.0.1");
+        CATCH_REQUIRE(opt.get_long("port") == 443);
+        CATCH_REQUIRE(ip_calls == 1);
+        CATCH_REQUIRE(batch_calls == 1);
+
+        // a non-dynamic option or an unknown option also rejects the batch
+        //
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: option \"--static\" can't be directly updated.");
+        CATCH_REQUIRE_FALSE(opt.set_dynamic_values({
+                  { "ip", "10.0.0.3" }
+                , { "static", "value" }
+            }));
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: option \"--unknown\" is not defined.");
+        CATCH_REQUIRE_FALSE(opt.set_dynamic_values({
+                  { "ip", "10.0.0.4" }
+                , { "unknown", "value" }
+            }));
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+        CATCH_REQUIRE(opt.get_string("ip") == "10.0.0.1");
+
+        // only the options which changed are reported
+        //
+        CATCH_REQUIRE(opt.set_dynamic_values({
+                  { "ip", "10.0.0.1" }
+                , { "port", "443" }
+                , { "tls", "off" }
+            }));
+        CATCH_REQUIRE(ip_calls == 1);
+        CATCH_REQUIRE(batch_calls == 2);
+        CATCH_REQUIRE(last_changed.size() == 1);
+        CATCH_REQUIRE(last_changed[0]->get_name() == "tls");
+
+        // nothing changed, no notification
+        //
+        CATCH_REQUIRE(opt.set_dynamic_values({
+                  { "tls", "off" }
+            }));
+        CATCH_REQUIRE(batch_calls == 2);
+
+        // once removed, the batch callback is not called anymore
+        //
+        opt.remove_batch_callback(id);
+        CATCH_REQUIRE(opt.set_dynamic_values({
+                  { "tls", "on" }
+            }));
+        CATCH_REQUIRE(batch_calls == 2);
+        CATCH_REQUIRE(opt.get_string("tls") == "on");
+    }
+    CATCH_END_SECTION()
 }
 
 
 
+CATCH_TEST_CASE("check_option_layers", "[option_info][valid][layer]")
+{
+    CATCH_START_SECTION("check_option_layers: replace the configuration layer")
+    {
+        advgetopt::option_info tags("tags");
+        tags.add_flag(advgetopt::GETOPT_FLAG_REQUIRED);
+        tags.add_flag(advgetopt::GETOPT_FLAG_MULTIPLE);
+        tags.set_multiple_separators(advgetopt::string_list_t{","});
+        tags.set_keep_layers(true);
+
+        tags.set_multiple_values("a,b", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        for(int idx(0); idx < 100; ++idx)
+        {
+            tags.add_value("c" + std::to_string(idx), advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        }
+        CATCH_REQUIRE(tags.size() == 102);
+
+        advgetopt::option_info::generation_t const generation(advgetopt::option_info::get_global_generation());
+        tags.rewind_layer(advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        CATCH_REQUIRE_FALSE(tags.is_defined());
+        tags.set_multiple_values("x", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        CATCH_REQUIRE(tags.forward_layer());
+        CATCH_REQUIRE(advgetopt::option_info::get_global_generation() == generation);
+
+        CATCH_REQUIRE(tags.size() == 101);
+        CATCH_REQUIRE(tags.get_value(0) == "x");
+        CATCH_REQUIRE(tags.get_value(1) == "c0");
+        CATCH_REQUIRE(tags.get_value(100) == "c99");
+        CATCH_REQUIRE(tags.source() == advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+
+        // the same values do not report a change
+        //
+        tags.rewind_layer(advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        tags.set_multiple_values("x", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        CATCH_REQUIRE_FALSE(tags.forward_layer());
+        CATCH_REQUIRE(tags.size() == 101);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("check_option_layers: replayed values are not checked again")
+    {
+        advgetopt::option_info level("level");
+        level.add_flag(advgetopt::GETOPT_FLAG_REQUIRED);
+        level.add_flag(advgetopt::GETOPT_FLAG_DYNAMIC_CONFIGURATION);
+        level.set_keep_layers(true);
+
+        level.set_value(0, "low", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        for(int idx(0); idx < 1'000; ++idx)
+        {
+            level.set_value(0, std::to_string(idx), advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_DIRECT);
+        }
+
+        // the direct value was accepted when set, replaying it must not
+        // generate an error now that the option is not dynamic anymore
+        //
+        level.remove_flag(advgetopt::GETOPT_FLAG_DYNAMIC_CONFIGURATION);
+        level.rewind_layer(advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        level.set_value(0, "high", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        CATCH_REQUIRE_FALSE(level.forward_layer());
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+        CATCH_REQUIRE(level.get_value() == "999");
+        CATCH_REQUIRE(level.source() == advgetopt::option_source_t::SOURCE_DIRECT);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("check_option_layers: reset with and without a source")
+    {
+        advgetopt::option_info verbose("verbose");
+        verbose.add_flag(advgetopt::GETOPT_FLAG_FLAG);
+        verbose.set_keep_layers(true);
+
+        verbose.add_value(std::string(), advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        verbose.reset(advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        CATCH_REQUIRE_FALSE(verbose.is_defined());
+
+        // the reset from the command line is applied again
+        //
+        verbose.rewind_layer(advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        verbose.add_value(std::string(), advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        CATCH_REQUIRE_FALSE(verbose.forward_layer());
+        CATCH_REQUIRE_FALSE(verbose.is_defined());
+
+        // the reset() without parameters forgets all the layers
+        //
+        void (advgetopt::option_info::*reset)() = &advgetopt::option_info::reset;
+        verbose.add_value(std::string(), advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        CATCH_REQUIRE(verbose.is_defined());
+        (verbose.*reset)();
+        CATCH_REQUIRE_FALSE(verbose.is_defined());
+        verbose.rewind_layer(advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        CATCH_REQUIRE_FALSE(verbose.forward_layer());
+        CATCH_REQUIRE_FALSE(verbose.is_defined());
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("check_option_layers: the layers are only kept on request")
+    {
+        advgetopt::option_info sizes("sizes");
+        sizes.add_flag(advgetopt::GETOPT_FLAG_REQUIRED);
+        sizes.add_flag(advgetopt::GETOPT_FLAG_MULTIPLE);
+        CATCH_REQUIRE_FALSE(sizes.get_keep_layers());
+
+        // without layers, a rewind does nothing
+        //
+        sizes.set_value(0, "33", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        sizes.rewind_layer(advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        CATCH_REQUIRE(sizes.get_value() == "33");
+        CATCH_REQUIRE_FALSE(sizes.forward_layer());
+
+        // the values set before the layers are kept are recorded as
+        // a whole in the layer of their source
+        //
+        sizes.set_keep_layers(true);
+        CATCH_REQUIRE(sizes.get_keep_layers());
+        for(int idx(0); idx < 10; ++idx)
+        {
+            sizes.add_value("a" + std::to_string(idx), advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        }
+        for(int idx(0); idx < 1'000; ++idx)
+        {
+            sizes.set_value(idx % 10, std::to_string(idx), advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        }
+        CATCH_REQUIRE(sizes.size() == 11);
+
+        sizes.rewind_layer(advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        CATCH_REQUIRE_FALSE(sizes.is_defined());
+        sizes.set_value(0, "55", advgetopt::string_list_t(), advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        CATCH_REQUIRE_FALSE(sizes.forward_layer());
+        CATCH_REQUIRE(sizes.size() == 11);
+        CATCH_REQUIRE(sizes.get_value(0) == "990");
+        CATCH_REQUIRE(sizes.get_value(9) == "999");
+        CATCH_REQUIRE(sizes.get_value(10) == "a9");
+        CATCH_REQUIRE(sizes.source() == advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+
+        sizes.set_keep_layers(false);
+        CATCH_REQUIRE_FALSE(sizes.get_keep_layers());
+    }
+    CATCH_END_SECTION()
+}
+
+
 // vim: ts=4 sw=4 et
@@ -0,0 +1,266 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+// advgetopt
+//
+#include    <advgetopt/exception.h>
+#include    <advgetopt/option_overlay.h>
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+
+CATCH_TEST_CASE("option_overlay", "[options][valid][overlay]")
+{
+    CATCH_START_SECTION("option_overlay: override a few options for one request")
+    {
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("verbose")
+                , advgetopt::ShortName('v')
+                , advgetopt::Flags(advgetopt::standalone_command_flags<>())
+                , advgetopt::Help("make it verbose.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("timeout")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Validator("integer(1...100)")
+                , advgetopt::DefaultValue("30")
+                , advgetopt::Help("the timeout.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("tenant")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("the name of the tenant.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("delay")
+                , advgetopt::Flags(advgetopt::command_flags<
+                              advgetopt::GETOPT_FLAG_REQUIRED
+                            , advgetopt::GETOPT_FLAG_HAS_DEFAULT
+                            , advgetopt::GETOPT_FLAG_ALIAS>())
+                , advgetopt::Help("timeout")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Usage: test option_overlay";
+
+        char const * cargv[] =
+        {
+            "/usr/bin/overlay",
+            "-v",
+            "--tenant",
+            "main",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::getopt base(environment_options, argc, argv);
+
+        advgetopt::option_overlay overlay(base);
+        CATCH_REQUIRE(&overlay.get_base() == &base);
+        CATCH_REQUIRE(overlay.overrides() == 0);
+
+        // everything falls through to the base
+        //
+        CATCH_REQUIRE(overlay.is_defined("verbose"));
+        CATCH_REQUIRE_FALSE(overlay.is_defined("timeout"));
+        CATCH_REQUIRE(overlay.get_long("timeout") == 30);
+        CATCH_REQUIRE(overlay.get_string("tenant") == "main");
+        CATCH_REQUIRE_FALSE(overlay.is_overridden("tenant"));
+
+        // override two options, one through its alias
+        //
+        CATCH_REQUIRE(overlay.set_value("delay", "5"));
+        CATCH_REQUIRE(overlay.set_value("tenant", "blue"));
+        CATCH_REQUIRE(overlay.overrides() == 2);
+        CATCH_REQUIRE(overlay.is_overridden("timeout"));
+        CATCH_REQUIRE(overlay.is_overridden("tenant"));
+        CATCH_REQUIRE_FALSE(overlay.is_overridden("verbose"));
+
+        CATCH_REQUIRE(overlay.is_defined("timeout"));
+        CATCH_REQUIRE(overlay.size("timeout") == 1);
+        CATCH_REQUIRE(overlay.get_long("timeout") == 5);
+        CATCH_REQUIRE(overlay.try_get_long("timeout") == 5);
+        CATCH_REQUIRE_FALSE(overlay.try_get_long("timeout", 0, 10, 20).has_value());
+        CATCH_REQUIRE_FALSE(overlay.try_get_long("timeout", 1).has_value());
+        CATCH_REQUIRE(overlay.get_string("tenant") == "blue");
+        CATCH_REQUIRE(overlay.try_get_string("tenant") == "blue");
+        CATCH_REQUIRE(overlay.try_get_raw_string("tenant") == "blue");
+        CATCH_REQUIRE_FALSE(overlay.try_get_string("tenant", 1).has_value());
+        CATCH_REQUIRE(overlay.is_defined("verbose"));
+
+        // the base was not modified
+        //
+        CATCH_REQUIRE_FALSE(base.is_defined("timeout"));
+        CATCH_REQUIRE(base.get_long("timeout") == 30);
+        CATCH_REQUIRE(base.get_string("tenant") == "main");
+
+        // replace a value
+        //
+        CATCH_REQUIRE(overlay.set_value("timeout", "7"));
+        CATCH_REQUIRE(overlay.overrides() == 2);
+        CATCH_REQUIRE(overlay.get_long("timeout") == 7);
+
+        // restore one option
+        //
+        overlay.reset("timeout");
+        overlay.reset("unknown");
+        CATCH_REQUIRE(overlay.overrides() == 1);
+        CATCH_REQUIRE_FALSE(overlay.is_defined("timeout"));
+        CATCH_REQUIRE(overlay.get_long("timeout") == 30);
+
+        // restore all and reuse the overlay
+        //
+        overlay.clear();
+        CATCH_REQUIRE(overlay.overrides() == 0);
+        CATCH_REQUIRE(overlay.get_string("tenant") == "main");
+        CATCH_REQUIRE(overlay.set_value("tenant", "green"));
+        CATCH_REQUIRE(overlay.get_string("tenant") == "green");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("option_overlay: values larger than the arena")
+    {
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("timeout")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Validator("integer(1...100)")
+                , advgetopt::DefaultValue("30")
+                , advgetopt::Help("the timeout.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("tenant")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("the name of the tenant.")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Usage: test option_overlay";
+
+        char const * cargv[] =
+        {
+            "/usr/bin/overlay",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::getopt base(environment_options, argc, argv);
+
+        std::string const large(advgetopt::option_overlay::ARENA_SIZE * 4, 'x');
+        advgetopt::option_overlay overlay(base);
+        CATCH_REQUIRE(overlay.set_value("tenant", large));
+        CATCH_REQUIRE(overlay.get_string("tenant") == large);
+        CATCH_REQUIRE(overlay.set_value("timeout", "99"));
+        CATCH_REQUIRE(overlay.get_long("timeout") == 99);
+        CATCH_REQUIRE(overlay.get_string("tenant") == large);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("invalid_option_overlay", "[options][invalid][overlay]")
+{
+    CATCH_START_SECTION("invalid_option_overlay: unknown option and invalid values")
+    {
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("timeout")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Validator("integer(1...100)")
+                , advgetopt::DefaultValue("30")
+                , advgetopt::Help("the timeout.")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Usage: test option_overlay";
+
+        char const * cargv[] =
+        {
+            "/usr/bin/overlay",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::getopt base(environment_options, argc, argv);
+
+        advgetopt::option_overlay overlay(base);
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  overlay.set_value("unknown", "1")
+                , advgetopt::getopt_logic_error
+                , Catch::Matchers::ExceptionMessage(
+                          "getopt_logic_error: option_overlay::set_value(): there is no --unknown option defined."));
+
+        CATCH_REQUIRE(overlay.set_value("timeout", "12"));
+
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: input \"500\" given to parameter --timeout is not considered valid: out of range.");
+        CATCH_REQUIRE_FALSE(overlay.set_value("timeout", "500"));
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+        CATCH_REQUIRE(overlay.get_long("timeout") == 12);
+
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: 12 is out of bounds (20..50 inclusive) in parameter --timeout.");
+        CATCH_REQUIRE(overlay.get_long("timeout", 0, 20, 50) == -1);
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  overlay.get_long("timeout", 1)
+                , advgetopt::getopt_undefined
+                , Catch::Matchers::ExceptionMessage(
+                          "getopt_exception: option_overlay::get_long(): no value at index 1 (idx >= 1) for --timeout so you can't get this value."));
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  overlay.get_string("timeout", 1)
+                , advgetopt::getopt_undefined
+                , Catch::Matchers::ExceptionMessage(
+                          "getopt_exception: option_overlay::get_string(): no value at index 1 (idx >= 1) for --timeout so you can't get this value."));
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
@@ -0,0 +1,208 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+// advgetopt
+//
+#include    <advgetopt/exception.h>
+#include    <advgetopt/option_schema.h>
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+
+CATCH_TEST_CASE("option_schema", "[options][valid][schema]")
+{
+    CATCH_START_SECTION("option_schema: many getopt objects sharing one schema")
+    {
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("verbose")
+                , advgetopt::ShortName('v')
+                , advgetopt::Flags(advgetopt::standalone_command_flags<>())
+                , advgetopt::Help("make it verbose.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("size")
+                , advgetopt::ShortName('s')
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Validator("integer(1...100)")
+                , advgetopt::Help("the size.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("length")
+                , advgetopt::Flags(advgetopt::command_flags<
+                              advgetopt::GETOPT_FLAG_REQUIRED
+                            , advgetopt::GETOPT_FLAG_ALIAS>())
+                , advgetopt::Help("size")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Usage: test option_schema";
+
+        advgetopt::option_schema::pointer_t schema(std::make_shared<advgetopt::option_schema>(environment_options));
+        CATCH_REQUIRE(schema->size() == 3);
+        CATCH_REQUIRE(schema->get_options_environment().f_options == options);
+        CATCH_REQUIRE(schema->get_definition("unknown") == nullptr);
+        advgetopt::option_info::definition_pointer_t const size(schema->get_definition("size"));
+        CATCH_REQUIRE(size != nullptr);
+        CATCH_REQUIRE(size->f_name == "size");
+        CATCH_REQUIRE(size->f_short_name == 's');
+        CATCH_REQUIRE(size->f_help == "the size.");
+        CATCH_REQUIRE(size->f_validator != nullptr);
+
+        char const * cargv1[] =
+        {
+            "/usr/bin/schema",
+            "-v",
+            "--size",
+            "7",
+            nullptr
+        };
+        int const argc1(sizeof(cargv1) / sizeof(cargv1[0]) - 1);
+        char ** argv1 = const_cast<char **>(cargv1);
+
+        char const * cargv2[] =
+        {
+            "/usr/bin/schema",
+            "--length",
+            "99",
+            nullptr
+        };
+        int const argc2(sizeof(cargv2) / sizeof(cargv2[0]) - 1);
+        char ** argv2 = const_cast<char **>(cargv2);
+
+        advgetopt::getopt opt1(schema, argc1, argv1);
+        advgetopt::getopt opt2(schema, argc2, argv2);
+
+        // the definitions are shared
+        //
+        CATCH_REQUIRE(opt1.get_option("size")->get_definition() == size);
+        CATCH_REQUIRE(opt2.get_option("size")->get_definition() == size);
+        CATCH_REQUIRE(opt1.get_option('s') == opt1.get_option("size"));
+
+        // the values are not
+        //
+        CATCH_REQUIRE(opt1.is_defined("verbose"));
+        CATCH_REQUIRE(opt1.get_long("size") == 7);
+        CATCH_REQUIRE_FALSE(opt2.is_defined("verbose"));
+        CATCH_REQUIRE(opt2.get_long("size") == 99);
+
+        // aliases were linked to the option of their own getopt
+        //
+        CATCH_REQUIRE(opt1.get_option("length", true)->get_alias_destination() == opt1.get_option("size"));
+        CATCH_REQUIRE(opt2.get_option("length", true)->get_alias_destination() == opt2.get_option("size"));
+
+        // modifying a definition makes a copy for that option only
+        //
+        opt1.get_option("size")->set_help("changed help.");
+        CATCH_REQUIRE(opt1.get_option("size")->get_help() == "changed help.");
+        CATCH_REQUIRE(opt1.get_option("size")->get_definition() != size);
+        CATCH_REQUIRE(opt2.get_option("size")->get_help() == "the size.");
+        CATCH_REQUIRE(opt2.get_option("size")->get_definition() == size);
+        CATCH_REQUIRE(size->f_help == "the size.");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("option_schema: schema from a getopt prototype")
+    {
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("verbose")
+                , advgetopt::ShortName('v')
+                , advgetopt::Flags(advgetopt::standalone_command_flags<>())
+                , advgetopt::Help("make it verbose.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("size")
+                , advgetopt::ShortName('s')
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Validator("integer(1...100)")
+                , advgetopt::Help("the size.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("length")
+                , advgetopt::Flags(advgetopt::command_flags<
+                              advgetopt::GETOPT_FLAG_REQUIRED
+                            , advgetopt::GETOPT_FLAG_ALIAS>())
+                , advgetopt::Help("size")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Usage: test option_schema";
+
+        advgetopt::getopt prototype(environment_options);
+        prototype.add_option(std::make_shared<advgetopt::option_info>("dynamic"));
+        advgetopt::option_schema::pointer_t schema(std::make_shared<advgetopt::option_schema>(prototype));
+        CATCH_REQUIRE(schema->size() == 4);
+        CATCH_REQUIRE(schema->get_definition("dynamic") == prototype.get_option("dynamic")->get_definition());
+
+        // changing the prototype does not change the schema
+        //
+        prototype.get_option("verbose")->set_help("new help.");
+        CATCH_REQUIRE(schema->get_definition("verbose")->f_help == "make it verbose.");
+
+        advgetopt::getopt opt(schema);
+        CATCH_REQUIRE(opt.get_option("dynamic") != nullptr);
+        CATCH_REQUIRE(opt.get_option("verbose")->get_help() == "make it verbose.");
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("invalid_option_schema", "[options][invalid][schema]")
+{
+    CATCH_START_SECTION("invalid_option_schema: null pointers")
+    {
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  advgetopt::getopt(advgetopt::option_schema::pointer_t())
+                , advgetopt::getopt_logic_error
+                , Catch::Matchers::ExceptionMessage(
+                          "getopt_logic_error: the schema pointer cannot be null."));
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  std::make_shared<advgetopt::option_info>(advgetopt::option_info::definition_pointer_t())
+                , advgetopt::getopt_logic_error
+                , Catch::Matchers::ExceptionMessage(
+                          "getopt_logic_error: option_info::option_info(): the definition pointer cannot be null."));
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
@@ -336,6 +336,24 @@ CATCH_TEST_CASE("options_sources_environment_variable_and_config_file", "[option
         CATCH_REQUIRE(more_sources[1] == "more=instructions [environment-variable]");
         CATCH_REQUIRE(more_sources[2] == "more=magical [command-line]");
 
+        // the raw records include the line number
+        //
+        advgetopt::option_info::trace_record_vector_t const & more_records(more->trace_records());
+        CATCH_REQUIRE(more_records.size() == 3);
+        CATCH_REQUIRE(more_records[0].f_source == advgetopt::option_source_t::SOURCE_CONFIGURATION);
+        CATCH_REQUIRE(advgetopt::option_info::get_trace_filename(more_records[0].f_filename) == SNAP_CATCH2_NAMESPACE::g_tmp_dir() + "/.config/src.config");
+        CATCH_REQUIRE(more_records[0].f_line == 8);
+        CATCH_REQUIRE(more_records[0].f_index == advgetopt::option_info::TRACE_SINGLE_VALUE);
+        CATCH_REQUIRE(more_records[0].f_value == "data");
+        CATCH_REQUIRE(more_records[1].f_source == advgetopt::option_source_t::SOURCE_ENVIRONMENT_VARIABLE);
+        CATCH_REQUIRE(more_records[1].f_filename == 0);
+        CATCH_REQUIRE(more_records[1].f_line == 0);
+        CATCH_REQUIRE(more_records[1].f_value == "instructions");
+        CATCH_REQUIRE(more_records[2].f_source == advgetopt::option_source_t::SOURCE_COMMAND_LINE);
+        CATCH_REQUIRE(more_records[2].f_value == "magical");
+        CATCH_REQUIRE(advgetopt::option_info::get_trace_filename(0).empty());
+        CATCH_REQUIRE(advgetopt::option_info::get_trace_filename(1'000'000).empty());
+
         advgetopt::option_info::pointer_t organized(opt.get_option("organized"));
         CATCH_REQUIRE(organized != nullptr);
         CATCH_REQUIRE(opt.is_defined("organized"));
@@ -378,6 +396,11 @@ CATCH_TEST_CASE("options_sources_environment_variable_and_config_file", "[option
         CATCH_REQUIRE(color_sources[1] == "color[1]=orange [environment-variable]");
         CATCH_REQUIRE(color_sources[2] == "color[2]=purple [environment-variable]");
 
+        advgetopt::option_info::trace_record_vector_t const & color_records(color->trace_records());
+        CATCH_REQUIRE(color_records.size() == 3);
+        CATCH_REQUIRE(color_records[2].f_index == 2);
+        CATCH_REQUIRE(color_records[2].f_value == "purple");
+
         advgetopt::option_info::pointer_t sources(opt.get_option("sources"));
         CATCH_REQUIRE(sources != nullptr);
         CATCH_REQUIRE(opt.is_defined("sources"));
@@ -0,0 +1,342 @@
+// Copyright (c) 2006-2025  Made to Order Software Corp.  All Rights Reserved
+//
+// https://snapwebsites.org/project/advgetopt
+// contact@m2osw.com
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+
+// advgetopt
+//
+#include    <advgetopt/exception.h>
+#include    <advgetopt/parse_session.h>
+
+
+// self
+//
+#include    "catch_main.h"
+
+
+// C++
+//
+#include    <thread>
+
+
+// last include
+//
+#include    <snapdev/poison.h>
+
+
+
+
+CATCH_TEST_CASE("parse_session", "[arguments][valid][getopt][session]")
+{
+    CATCH_START_SECTION("parse_session: parse several command lines with one session")
+    {
+        char const * const separators[] =
+        {
+            ",",
+            nullptr
+        };
+
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("verbose")
+                , advgetopt::ShortName('v')
+                , advgetopt::Flags(advgetopt::standalone_command_flags<>())
+                , advgetopt::Help("make it verbose.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("size")
+                , advgetopt::ShortName('s')
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Validator("integer(1...100)")
+                , advgetopt::DefaultValue("33")
+                , advgetopt::Help("the size.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("tags")
+                , advgetopt::Flags(advgetopt::command_flags<
+                              advgetopt::GETOPT_FLAG_REQUIRED
+                            , advgetopt::GETOPT_FLAG_MULTIPLE>())
+                , advgetopt::Separators(separators)
+                , advgetopt::Help("list of tags.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("long-name")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("an option with a dash.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("config-only")
+                , advgetopt::Flags(advgetopt::config_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("not available on the command line.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("--")
+                , advgetopt::Flags(advgetopt::command_flags<
+                              advgetopt::GETOPT_FLAG_MULTIPLE
+                            , advgetopt::GETOPT_FLAG_DEFAULT_OPTION>())
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Usage: test parse_session";
+
+        char const * cargv[] =
+        {
+            "/usr/bin/arguments",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::getopt::pointer_t prototype(std::make_shared<advgetopt::getopt>(environment_options, argc, argv));
+        advgetopt::parse_session session(*prototype);
+
+        CATCH_REQUIRE(session.parse("-v --size 5 --tags a b c file1"));
+        CATCH_REQUIRE(session.get_error().empty());
+        CATCH_REQUIRE(session.is_defined("verbose"));
+        CATCH_REQUIRE(session.get_long("size") == 5);
+        CATCH_REQUIRE(session.size("tags") == 4);
+        CATCH_REQUIRE(session.get_string("tags", 3) == "file1");
+        CATCH_REQUIRE_FALSE(session.is_defined("--"));
+
+        // the previous values are gone
+        //
+        CATCH_REQUIRE(session.parse("--tags=x,y 'quoted arg' -- -v x"));
+        CATCH_REQUIRE_FALSE(session.is_defined("verbose"));
+        CATCH_REQUIRE_FALSE(session.is_defined("size"));
+        CATCH_REQUIRE(session.get_long("size") == 33);
+        CATCH_REQUIRE(session.size("tags") == 2);
+        CATCH_REQUIRE(session.get_string("tags", 0) == "x");
+        CATCH_REQUIRE(session.get_string("tags", 1) == "y");
+        CATCH_REQUIRE(session.size("--") == 3);
+        CATCH_REQUIRE(session.get_string("--", 0) == "quoted arg");
+        CATCH_REQUIRE(session.get_string("--", 1) == "-v");
+        CATCH_REQUIRE(session.get_string("--", 2) == "x");
+        CATCH_REQUIRE(session.get_string("--", 3) == std::nullopt);
+
+        CATCH_REQUIRE(session.parse("-vs 7 --long_name \"a b\" --verbose=false"));
+        CATCH_REQUIRE_FALSE(session.is_defined("verbose"));
+        CATCH_REQUIRE(session.get_long("size") == 7);
+        CATCH_REQUIRE(session.get_string("long-name") == "a b");
+        CATCH_REQUIRE(session.get_string("long_name") == "a b");
+        CATCH_REQUIRE(session.get_string("unknown") == std::nullopt);
+        CATCH_REQUIRE(session.get_long("long-name") == std::nullopt);
+
+        // the prototype was not modified
+        //
+        CATCH_REQUIRE_FALSE(prototype->is_defined("verbose"));
+        CATCH_REQUIRE_FALSE(prototype->is_defined("size"));
+        CATCH_REQUIRE_FALSE(prototype->is_defined("tags"));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("parse_session: one session per thread")
+    {
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("verbose")
+                , advgetopt::ShortName('v')
+                , advgetopt::Flags(advgetopt::standalone_command_flags<>())
+                , advgetopt::Help("make it verbose.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("size")
+                , advgetopt::ShortName('s')
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Validator("integer(1...100)")
+                , advgetopt::DefaultValue("33")
+                , advgetopt::Help("the size.")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Usage: test parse_session";
+
+        char const * cargv[] =
+        {
+            "/usr/bin/arguments",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::getopt::pointer_t prototype(std::make_shared<advgetopt::getopt>(environment_options, argc, argv));
+
+        std::atomic<std::size_t> errors(0);
+        std::vector<std::thread> workers;
+        for(int t(0); t < 4; ++t)
+        {
+            workers.emplace_back([&prototype, &errors, t]()
+                {
+                    advgetopt::parse_session session(*prototype);
+                    for(int idx(0); idx < 1'000; ++idx)
+                    {
+                        long const size((idx + t) % 100 + 1);
+                        if(!session.parse("-v --size " + std::to_string(size))
+                        || session.get_long("size") != size)
+                        {
+                            ++errors;
+                        }
+                    }
+                });
+        }
+        for(auto & w : workers)
+        {
+            w.join();
+        }
+        CATCH_REQUIRE(errors == 0);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("parse_session: names remain valid when a definition gets replaced")
+    {
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("size")
+                , advgetopt::ShortName('s')
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Validator("integer(1...100)")
+                , advgetopt::DefaultValue("33")
+                , advgetopt::Help("the size.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("long-name")
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("an option with a dash.")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Usage: test parse_session";
+
+        char const * cargv[] =
+        {
+            "/usr/bin/arguments",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::getopt::pointer_t prototype(std::make_shared<advgetopt::getopt>(environment_options, argc, argv));
+        advgetopt::parse_session session(*prototype);
+
+        // each setter replaces the definition of the option; the session
+        // keeps the previous definitions so its names are still valid
+        //
+        prototype->get_option("long-name")->set_help("a new help string.");
+        prototype->get_option("size")->set_help("a new size help string.");
+        prototype.reset();
+
+        CATCH_REQUIRE(session.parse("--long-name abc -s 12"));
+        CATCH_REQUIRE(session.get_string("long-name") == "abc");
+        CATCH_REQUIRE(session.get_long("size") == 12);
+    }
+    CATCH_END_SECTION()
+}
+
+
+CATCH_TEST_CASE("invalid_parse_session", "[arguments][invalid][getopt][session]")
+{
+    CATCH_START_SECTION("invalid_parse_session: errors are returned, not logged")
+    {
+        advgetopt::option const options[] =
+        {
+            advgetopt::define_option(
+                  advgetopt::Name("verbose")
+                , advgetopt::ShortName('v')
+                , advgetopt::Flags(advgetopt::standalone_command_flags<>())
+                , advgetopt::Help("make it verbose.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("size")
+                , advgetopt::ShortName('s')
+                , advgetopt::Flags(advgetopt::command_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Validator("integer(1...100)")
+                , advgetopt::DefaultValue("33")
+                , advgetopt::Help("the size.")
+            ),
+            advgetopt::define_option(
+                  advgetopt::Name("config-only")
+                , advgetopt::Flags(advgetopt::config_flags<advgetopt::GETOPT_FLAG_REQUIRED>())
+                , advgetopt::Help("not available on the command line.")
+            ),
+            advgetopt::end_options()
+        };
+
+        advgetopt::options_environment environment_options;
+        environment_options.f_project_name = "unittest";
+        environment_options.f_options = options;
+        environment_options.f_help_header = "Usage: test parse_session";
+
+        char const * cargv[] =
+        {
+            "/usr/bin/arguments",
+            nullptr
+        };
+        int const argc(sizeof(cargv) / sizeof(cargv[0]) - 1);
+        char ** argv = const_cast<char **>(cargv);
+
+        advgetopt::getopt::pointer_t prototype(std::make_shared<advgetopt::getopt>(environment_options, argc, argv));
+        advgetopt::parse_session session(*prototype);
+
+        CATCH_REQUIRE_FALSE(session.parse("--size=500"));
+        CATCH_REQUIRE(session.get_error() == "input \"500\" given to parameter --size is not considered valid: out of range.");
+
+        CATCH_REQUIRE_FALSE(session.parse("--unknown"));
+        CATCH_REQUIRE(session.get_error() == "option \"--unknown\" is not supported.");
+
+        CATCH_REQUIRE_FALSE(session.parse("-z"));
+        CATCH_REQUIRE(session.get_error() == "option \"-z\" is not supported.");
+
+        CATCH_REQUIRE_FALSE(session.parse("--size"));
+        CATCH_REQUIRE(session.get_error() == "option --size expects an argument.");
+
+        CATCH_REQUIRE_FALSE(session.parse("--size="));
+        CATCH_REQUIRE(session.get_error() == "option --size must be given a value.");
+
+        CATCH_REQUIRE_FALSE(session.parse("--verbose=maybe"));
+        CATCH_REQUIRE(session.get_error() == "option --verbose cannot be given value \"maybe\". It only accepts \"true\" or \"false\".");
+
+        CATCH_REQUIRE_FALSE(session.parse("--=5"));
+        CATCH_REQUIRE(session.get_error() == "name missing in \"--=5\".");
+
+        CATCH_REQUIRE_FALSE(session.parse("--config-only abc"));
+        CATCH_REQUIRE(session.get_error() == "option \"--config-only\" is not supported on the command line.");
+
+        // a successful parse clears the error
+        //
+        CATCH_REQUIRE(session.parse("--size 3"));
+        CATCH_REQUIRE(session.get_error().empty());
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+// vim: ts=4 sw=4 et
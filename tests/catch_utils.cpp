@@ -38,6 +38,7 @@
 // C++
 //
 #include    <fstream>
+#include    <iterator>
 #include    <random>
 
 
@@ -1075,4 +1076,59 @@ CATCH_TEST_CASE("utils_true_false", "[utils][boolean]")
 
 
 
+
+CATCH_TEST_CASE("utils_utf8", "[utils][valid]")
+{
+    CATCH_START_SECTION("utils_utf8: count characters")
+    {
+        CATCH_REQUIRE(advgetopt::utf8_length("") == 0);
+        CATCH_REQUIRE(advgetopt::utf8_length("a") == 1);
+        CATCH_REQUIRE(advgetopt::utf8_length("Hello World!") == 12);
+        CATCH_REQUIRE(advgetopt::utf8_length("Un très long texte avec des caractères accentués.") == 49);
+        CATCH_REQUIRE(advgetopt::utf8_length("\xE2\x82\xAC\xF0\x9F\x98\x80") == 2);
+
+        // continuation bytes are not counted, like libutf8::u8length()
+        //
+        CATCH_REQUIRE(advgetopt::utf8_length("\x80\xBF") == 0);
+
+        // compare with a plain loop on strings long enough to use blocks
+        //
+        char const * const pieces[] = { "a", " ", "\xC3\xA9", "\xE2\x82\xAC", "\xF0\x9F\x98\x80" };
+        std::mt19937 generator(123);
+        for(int count(0); count < 1000; ++count)
+        {
+            std::string s;
+            std::size_t characters(0);
+            std::size_t const max(generator() % 100);
+            std::vector<std::size_t> offsets;
+            for(std::size_t idx(0); idx < max; ++idx)
+            {
+                offsets.push_back(s.length());
+                s += pieces[generator() % std::size(pieces)];
+                ++characters;
+            }
+            CATCH_REQUIRE(advgetopt::utf8_length(s) == characters);
+
+            for(std::size_t idx(0); idx < characters; ++idx)
+            {
+                CATCH_REQUIRE(advgetopt::utf8_offset(s, idx) == offsets[idx]);
+            }
+            CATCH_REQUIRE(advgetopt::utf8_offset(s, characters) == s.length());
+            CATCH_REQUIRE(advgetopt::utf8_offset(s, characters + 10) == s.length());
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("utils_utf8: break up a line with multibyte characters")
+    {
+        // "très" is 4 characters but 5 bytes
+        //
+        CATCH_REQUIRE(advgetopt::breakup_line("un très bon texte", 0, 12) == "un très bon\ntexte\n");
+        CATCH_REQUIRE(advgetopt::breakup_line("été été été", 0, 7) == "été été\nété\n");
+        CATCH_REQUIRE(advgetopt::breakup_line("ééééééé", 2, 6) == "éééé\n  ééé\n");
+    }
+    CATCH_END_SECTION()
+}
+
+
 // vim: ts=4 sw=4 et
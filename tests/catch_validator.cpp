@@ -19,7 +19,13 @@
 
 // advgetopt
 //
+#include    <advgetopt/validator_address.h>
+#include    <advgetopt/validator_double.h>
 #include    <advgetopt/validator_duration.h>
+#include    <advgetopt/validator_email.h>
+#include    <advgetopt/validator_integer.h>
+#include    <advgetopt/validator_keywords.h>
+#include    <advgetopt/validator_list.h>
 #include    <advgetopt/validator_size.h>
 
 #include    <advgetopt/exception.h>
@@ -38,9 +44,12 @@
 
 // C++
 //
+#include    <atomic>
 #include    <cmath>
 #include    <fstream>
 #include    <iomanip>
+#include    <regex>
+#include    <thread>
 
 
 // last include
@@ -148,6 +157,74 @@ std::int64_t large_rnd(bool zero_allowed = true)
     }
 }
 
+
+
+class counting_validator
+    : public advgetopt::validator
+{
+public:
+    typedef std::shared_ptr<counting_validator> pointer_t;
+
+    counting_validator(std::string const & name, std::size_t max_length)
+        : f_name(name)
+        , f_max_length(max_length)
+    {
+    }
+
+    virtual std::string name() const override
+    {
+        return f_name;
+    }
+
+    virtual bool validate(std::string const & value) const override
+    {
+        ++f_count;
+        return value.length() <= f_max_length;
+    }
+
+    std::size_t get_count() const
+    {
+        return f_count;
+    }
+
+private:
+    std::string const       f_name;
+    std::size_t const       f_max_length;
+    mutable std::size_t     f_count = 0;
+};
+
+
+class legacy_validator
+    : public advgetopt::validator
+{
+public:
+    virtual std::string name() const override
+    {
+        return "legacy";
+    }
+
+    virtual bool validate(std::string const & value) const override
+    {
+        if(value == "legacy")
+        {
+            return true;
+        }
+        set_error("not the legacy value.");
+        return false;
+    }
+};
+
+
+class incomplete_validator
+    : public advgetopt::validator
+{
+public:
+    virtual std::string name() const override
+    {
+        return "incomplete";
+    }
+};
+
 }
 
 
@@ -171,6 +248,248 @@ CATCH_TEST_CASE("unknown_validator", "[validator][valid][validation]")
 
 
 
+
+CATCH_TEST_CASE("shared_validators", "[validator][valid][validation]")
+{
+    CATCH_START_SECTION("shared_validators: same specification returns the same validator")
+    {
+        advgetopt::validator::const_pointer_t a(advgetopt::validator::get_shared("integer(1...65535)"));
+        advgetopt::validator::const_pointer_t b(advgetopt::validator::get_shared("integer(1...65535)"));
+        advgetopt::validator::const_pointer_t c(advgetopt::validator::get_shared("  integer ( 1...65535 ) "));
+        advgetopt::validator::const_pointer_t d(advgetopt::validator::get_shared("integer(\"1...65535\")"));
+        advgetopt::validator::const_pointer_t e(advgetopt::validator::get_shared("integer(1...1024)"));
+
+        CATCH_REQUIRE(a != nullptr);
+        CATCH_REQUIRE(a == b);
+        CATCH_REQUIRE(a == c);
+        CATCH_REQUIRE(a == d);
+        CATCH_REQUIRE(a != e);
+
+        // create() still returns a new validator each time
+        //
+        advgetopt::validator::pointer_t f(advgetopt::validator::create("integer(1...65535)"));
+        CATCH_REQUIRE(f != nullptr);
+        CATCH_REQUIRE(f != a);
+
+        CATCH_REQUIRE(a->validate("80"));
+        CATCH_REQUIRE_FALSE(a->validate("65536"));
+        CATCH_REQUIRE(a->get_error() == "out of range.");
+        CATCH_REQUIRE(e->get_error() == "<error undefined>");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("shared_validators: lists are shared too")
+    {
+        advgetopt::validator::const_pointer_t a(advgetopt::validator::get_shared("length(1...3) | keywords(off, on)"));
+        advgetopt::validator::const_pointer_t b(advgetopt::validator::get_shared("length(1...3)|keywords(off,on)"));
+
+        CATCH_REQUIRE(a != nullptr);
+        CATCH_REQUIRE(a->name() == "list");
+        CATCH_REQUIRE(a == b);
+
+        // shared validators can't be modified
+        //
+        std::shared_ptr<advgetopt::validator_list const> list(std::dynamic_pointer_cast<advgetopt::validator_list const>(a));
+        CATCH_REQUIRE(list != nullptr);
+        CATCH_REQUIRE(list->get_validators().size() == 2);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("shared_validators: invalid specifications are not cached")
+    {
+        CATCH_REQUIRE(advgetopt::validator::get_shared(std::string()) == nullptr);
+        CATCH_REQUIRE(advgetopt::validator::get_shared("unknown_shared_validator") == nullptr);
+
+        for(int count(0); count < 2; ++count)
+        {
+            SNAP_CATCH2_NAMESPACE::push_expected_log("error: validator(): parameter list must end with ')'. Remaining input: \"...EOS\"");
+            CATCH_REQUIRE(advgetopt::validator::get_shared("integer(1...5") == nullptr);
+            SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("shared_validators: errors are kept per thread")
+    {
+        advgetopt::validator::const_pointer_t v(advgetopt::validator::get_shared("integer(0...9)"));
+        CATCH_REQUIRE(v != nullptr);
+
+        CATCH_REQUIRE_FALSE(v->validate("10"));
+        CATCH_REQUIRE(v->get_error() == "out of range.");
+
+        bool other_valid(true);
+        std::string other_error;
+        std::thread t([&]()
+            {
+                other_valid = v->validate("a");
+                other_error = v->get_error();
+            });
+        t.join();
+
+        CATCH_REQUIRE_FALSE(other_valid);
+        CATCH_REQUIRE(other_error == "not a valid number.");
+        CATCH_REQUIRE(v->get_error() == "out of range.");
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+CATCH_TEST_CASE("validation_result", "[validator][valid][validation]")
+{
+    CATCH_START_SECTION("validation_result: error codes and messages")
+    {
+        advgetopt::validation_result result;
+        CATCH_REQUIRE(result.is_valid());
+        CATCH_REQUIRE(result.get_code() == advgetopt::validation_error_t::VALIDATION_ERROR_NONE);
+        CATCH_REQUIRE(result.get_message().empty());
+
+        advgetopt::validator::pointer_t integer(advgetopt::validator::create("integer(1...10)"));
+        CATCH_REQUIRE(integer != nullptr);
+
+        CATCH_REQUIRE(integer->validate_with_result("5", result));
+        CATCH_REQUIRE(result.is_valid());
+
+        CATCH_REQUIRE_FALSE(integer->validate_with_result("11", result));
+        CATCH_REQUIRE_FALSE(result.is_valid());
+        CATCH_REQUIRE(result.get_code() == advgetopt::validation_error_t::VALIDATION_ERROR_OUT_OF_RANGE);
+        CATCH_REQUIRE(result.get_message() == "out of range.");
+
+        CATCH_REQUIRE_FALSE(integer->validate_with_result("five", result));
+        CATCH_REQUIRE(result.get_code() == advgetopt::validation_error_t::VALIDATION_ERROR_INVALID);
+        CATCH_REQUIRE(result.get_message() == "not a valid number.");
+
+        result.clear();
+        CATCH_REQUIRE(result.is_valid());
+
+        advgetopt::validator::pointer_t keywords(advgetopt::validator::create("keywords(on, off) | integer(0...1)"));
+        CATCH_REQUIRE(keywords != nullptr);
+        CATCH_REQUIRE_FALSE(keywords->validate_with_result("maybe", result));
+        CATCH_REQUIRE(result.get_code() == advgetopt::validation_error_t::VALIDATION_ERROR_NO_MATCH);
+        CATCH_REQUIRE(result.get_message() == "none of the validators could accept the input value.");
+
+        result.set_error(advgetopt::validation_error_t::VALIDATION_ERROR_INVALID, std::string("dynamic message"));
+        CATCH_REQUIRE(result.get_message() == "dynamic message");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("validation_result: validators implementing the older validate()")
+    {
+        legacy_validator legacy;
+        advgetopt::validation_result result;
+
+        CATCH_REQUIRE(legacy.validate("legacy"));
+        CATCH_REQUIRE(legacy.validate_with_result("legacy", result));
+        CATCH_REQUIRE(result.is_valid());
+
+        CATCH_REQUIRE_FALSE(legacy.validate_with_result("modern", result));
+        CATCH_REQUIRE(result.get_code() == advgetopt::validation_error_t::VALIDATION_ERROR_INVALID);
+        CATCH_REQUIRE(result.get_message() == "not the legacy value.");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("validation_result: one validator shared by many threads")
+    {
+        advgetopt::validator::const_pointer_t v(advgetopt::validator::get_shared("integer(-100...100) | keywords(none)"));
+        CATCH_REQUIRE(v != nullptr);
+
+        std::atomic<int> errors(0);
+        std::vector<std::thread> threads;
+        for(int t(0); t < 4; ++t)
+        {
+            threads.emplace_back([&v, &errors, t]()
+                {
+                    advgetopt::validation_result result;
+                    for(int idx(0); idx < 10'000; ++idx)
+                    {
+                        int const n((idx + t) % 300 - 150);
+                        bool const expected(n >= -100 && n <= 100);
+                        if(v->validate_with_result(std::to_string(n), result) != expected
+                        || (!expected && result.get_code() != advgetopt::validation_error_t::VALIDATION_ERROR_NO_MATCH))
+                        {
+                            ++errors;
+                        }
+                    }
+                });
+        }
+        for(auto & t : threads)
+        {
+            t.join();
+        }
+        CATCH_REQUIRE(errors == 0);
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+CATCH_TEST_CASE("invalid_validation_result", "[validator][invalid][validation]")
+{
+    CATCH_START_SECTION("invalid_validation_result: a validator must implement validate()")
+    {
+        incomplete_validator incomplete;
+        advgetopt::validation_result result;
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  incomplete.validate("value")
+                , advgetopt::getopt_logic_error
+                , Catch::Matchers::ExceptionMessage(
+                          "getopt_logic_error: validator \"incomplete\" must implement validate() or validate_with_result()."));
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  incomplete.validate_with_result("value", result)
+                , advgetopt::getopt_logic_error
+                , Catch::Matchers::ExceptionMessage(
+                          "getopt_logic_error: validator \"incomplete\" must implement validate() or validate_with_result()."));
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+CATCH_TEST_CASE("validator_plugins", "[validator][valid][validation]")
+{
+    CATCH_START_SECTION("validator_plugins: load the email plugin on demand")
+    {
+        std::string const path(advgetopt::validator::get_plugins_path());
+        CATCH_REQUIRE_FALSE(path.empty());
+
+        // search a directory which does not exist first
+        //
+        advgetopt::validator::set_plugins_path("/this/directory/does/not/exist:" + path);
+        CATCH_REQUIRE(advgetopt::validator::get_plugins_path() == "/this/directory/does/not/exist:" + path);
+
+        CATCH_REQUIRE(advgetopt::validator::load_plugin("email"));
+
+        // once loaded, the plugin remains available
+        //
+        CATCH_REQUIRE(advgetopt::validator::load_plugin("email"));
+        advgetopt::validator::pointer_t email(advgetopt::validator::create("email"));
+        CATCH_REQUIRE(email != nullptr);
+        CATCH_REQUIRE(email->name() == "email");
+        CATCH_REQUIRE(email->validate("user@example.com"));
+
+        advgetopt::validator::set_plugins_path(path);
+        CATCH_REQUIRE(advgetopt::validator::get_plugins_path() == path);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("validator_plugins: missing plugins")
+    {
+        CATCH_REQUIRE_FALSE(advgetopt::validator::load_plugin("not_a_plugin"));
+        CATCH_REQUIRE(advgetopt::validator::create("not_a_plugin", advgetopt::string_list_t()) == nullptr);
+
+        // names which could be used to load any file are refused
+        //
+        CATCH_REQUIRE_FALSE(advgetopt::validator::load_plugin(""));
+        CATCH_REQUIRE_FALSE(advgetopt::validator::load_plugin("../../lib/x86_64-linux-gnu/libc"));
+        CATCH_REQUIRE_FALSE(advgetopt::validator::load_plugin("Email"));
+        CATCH_REQUIRE(advgetopt::validator::create("../email", advgetopt::string_list_t()) == nullptr);
+    }
+    CATCH_END_SECTION()
+}
+
+
+
 CATCH_TEST_CASE("email_validator", "[invalid][validation]")
 {
     CATCH_START_SECTION("email_validator: verify that email verification works.")
@@ -225,12 +544,180 @@ CATCH_TEST_CASE("email_validator", "[invalid][validation]")
         CATCH_REQUIRE_FALSE(email->validate("uSeR@com"));
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("email_validator: verify the domain cache")
+    {
+        advgetopt::validator_email::set_domain_cache_size(0);
+        CATCH_REQUIRE(advgetopt::validator_email::get_cached_domains() == 0);
+        advgetopt::validator_email::set_domain_cache_size(3);
+
+        advgetopt::validator::pointer_t email(advgetopt::validator::create("email"));
+        CATCH_REQUIRE(email != nullptr);
+
+        CATCH_REQUIRE(email->validate("alexis@example.com"));
+        CATCH_REQUIRE(advgetopt::validator_email::get_cached_domains() == 1);
+        CATCH_REQUIRE(email->validate("first.last@example.com"));
+        CATCH_REQUIRE(email->validate("user+tag@example.com"));
+        CATCH_REQUIRE(advgetopt::validator_email::get_cached_domains() == 1);
+
+        // domain names are case insensitive
+        //
+        CATCH_REQUIRE(email->validate("alexis@Example.COM"));
+        CATCH_REQUIRE(advgetopt::validator_email::get_cached_domains() == 1);
+
+        // invalid domains are cached too
+        //
+        CATCH_REQUIRE_FALSE(email->validate("alexis@com"));
+        CATCH_REQUIRE_FALSE(email->validate("doug@com"));
+        CATCH_REQUIRE(advgetopt::validator_email::get_cached_domains() == 2);
+
+        // an invalid local part is still detected with a cached domain
+        //
+        CATCH_REQUIRE_FALSE(email->validate(".alexis@example.com"));
+        CATCH_REQUIRE_FALSE(email->validate("alexis..wilke@example.com"));
+        CATCH_REQUIRE_FALSE(email->validate("@example.com"));
+
+        // complex addresses go through libtld
+        //
+        CATCH_REQUIRE(email->validate("Alexis Wilke <alexis@example.com>"));
+
+        // the least recently used domain gets removed
+        //
+        CATCH_REQUIRE(email->validate("alexis@example.net"));
+        CATCH_REQUIRE(email->validate("alexis@example.org"));
+        CATCH_REQUIRE(advgetopt::validator_email::get_cached_domains() == 3);
+        CATCH_REQUIRE(email->validate("alexis@m2osw.com"));
+        CATCH_REQUIRE(advgetopt::validator_email::get_cached_domains() == 3);
+
+        advgetopt::validator_email::set_domain_cache_size(advgetopt::validator_email::DEFAULT_DOMAIN_CACHE_SIZE);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("email_validator: verify a batch of emails")
+    {
+        advgetopt::validator::pointer_t email(advgetopt::validator::create("email"));
+        CATCH_REQUIRE(email != nullptr);
+
+        advgetopt::string_list_t const values{
+              "alexis@example.com"
+            , "doug@example.com"
+            , "bad..local@example.com"
+            , "user@com"
+            , "Alexis Wilke <alexis@example.com>"
+            , "user@example.com, other@example.com"
+            , "last@example.com"
+        };
+        advgetopt::validator::index_list_t invalid;
+        CATCH_REQUIRE_FALSE(email->validate_batch(values, invalid));
+        CATCH_REQUIRE(invalid == advgetopt::validator::index_list_t({ 2, 3, 5 }));
+
+        for(std::size_t idx(0); idx < values.size(); ++idx)
+        {
+            bool const expected(std::find(invalid.begin(), invalid.end(), idx) == invalid.end());
+            CATCH_REQUIRE(email->validate(values[idx]) == expected);
+        }
+    }
+    CATCH_END_SECTION()
 }
 
 
 
 CATCH_TEST_CASE("integer_validator", "[validator][valid][validation]")
 {
+    CATCH_START_SECTION("integer_validator: verify conversions of views")
+    {
+        std::string const numbers("12345678901234567,-0x1F,0b101,99999999999999999999,+8");
+        std::int64_t n(0);
+
+        CATCH_REQUIRE(advgetopt::validator_integer::convert_string(std::string_view(numbers).substr(0, 17), n));
+        CATCH_REQUIRE(n == 12345678901234567);
+        CATCH_REQUIRE(advgetopt::validator_integer::convert_string(std::string_view(numbers).substr(0, 8), n));
+        CATCH_REQUIRE(n == 12345678);
+        CATCH_REQUIRE(advgetopt::validator_integer::convert_string(std::string_view(numbers).substr(18, 5), n));
+        CATCH_REQUIRE(n == -31);
+        CATCH_REQUIRE(advgetopt::validator_integer::convert_string(std::string_view(numbers).substr(24, 5), n));
+        CATCH_REQUIRE(n == 5);
+        CATCH_REQUIRE(advgetopt::validator_integer::convert_string(std::string_view(numbers).substr(51, 2), n));
+        CATCH_REQUIRE(n == 8);
+
+        // overflows are always detected
+        //
+        CATCH_REQUIRE_FALSE(advgetopt::validator_integer::convert_string(std::string_view(numbers).substr(30, 20), n));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_integer::convert_string("23626557060081122765", n));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_integer::convert_string("9223372036854775808", n));
+        CATCH_REQUIRE(advgetopt::validator_integer::convert_string("-9223372036854775808", n));
+        CATCH_REQUIRE(n == std::numeric_limits<std::int64_t>::min());
+        CATCH_REQUIRE(advgetopt::validator_integer::convert_string("9223372036854775807", n));
+        CATCH_REQUIRE(n == std::numeric_limits<std::int64_t>::max());
+
+        // the whole view must be a number
+        //
+        CATCH_REQUIRE_FALSE(advgetopt::validator_integer::convert_string(std::string_view(numbers).substr(0, 18), n));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_integer::convert_string("1234567a", n));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_integer::convert_string("123456789012345a", n));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_integer::convert_string(std::string_view("12\0", 3), n));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_integer::convert_string("", n));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_integer::convert_string("+", n));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_integer::convert_string("0x", n));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("integer_validator: verify a batch of integers")
+    {
+        advgetopt::validator::pointer_t integer_validator(advgetopt::validator::create("integer(-1000...1000, 1000000000000000000...9000000000000000000)"));
+        CATCH_REQUIRE(integer_validator != nullptr);
+
+        advgetopt::string_list_t values;
+        advgetopt::validator::index_list_t expected;
+        for(int idx(0); idx < 10'000; ++idx)
+        {
+            std::string v;
+            switch(rand() % 6)
+            {
+            case 0:
+                v = std::to_string(rand() % 4001 - 2000);
+                break;
+
+            case 1:
+                v = std::to_string(large_rnd());
+                break;
+
+            case 2:
+                v = "0x" + std::to_string(rand() % 1000);
+                break;
+
+            case 3:
+                v = std::to_string(rand() % 1000) + (rand() % 2 == 0 ? "z" : " ");
+                break;
+
+            case 4:
+                v = (rand() % 2 == 0 ? "+" : "-") + std::to_string(rand() % 1500);
+                break;
+
+            case 5:
+                v = "9" + std::to_string(large_rnd() & 0x7FFFFFFFFFFFFFFF);
+                break;
+
+            }
+            if(!integer_validator->validate(v))
+            {
+                expected.push_back(values.size());
+            }
+            values.push_back(v);
+        }
+
+        advgetopt::validator::index_list_t invalid{ 1, 2, 3 };
+        CATCH_REQUIRE(integer_validator->validate_batch(values, invalid) == expected.empty());
+        CATCH_REQUIRE(invalid == expected);
+
+        CATCH_REQUIRE(integer_validator->validate_batch({"1", "-1000", "+1000", "1000000000000000000"}, invalid));
+        CATCH_REQUIRE(invalid.empty());
+
+        CATCH_REQUIRE_FALSE(integer_validator->validate_batch({"1", "", "+", "-1001", "999999999999999999"}, invalid));
+        CATCH_REQUIRE(invalid == advgetopt::validator::index_list_t{1, 2, 3, 4});
+    }
+    CATCH_END_SECTION()
+
     CATCH_START_SECTION("integer_validator: verify the integer validator")
     {
         advgetopt::validator::pointer_t integer_validator(advgetopt::validator::create("integer", advgetopt::string_list_t()));
@@ -498,6 +985,69 @@ CATCH_TEST_CASE("integer_validator", "[validator][valid][validation]")
         }
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("integer_validator: verify a large number of overlapping ranges")
+    {
+        // a list of ports as found in some firewall setups: many small
+        // ranges, some overlapping, some adjacent, in random order
+        //
+        std::vector<std::pair<std::int64_t, std::int64_t>> ranges;
+        advgetopt::string_list_t range_list;
+        for(int idx(0); idx < 500; ++idx)
+        {
+            std::int64_t const start(rand() % 60000 + 1);
+            std::int64_t const end(start + rand() % 20);
+            ranges.emplace_back(start, end);
+            if(start == end && rand() % 2 == 0)
+            {
+                range_list.push_back(std::to_string(start));
+            }
+            else
+            {
+                range_list.push_back(std::to_string(start) + "..." + std::to_string(end));
+            }
+        }
+
+        advgetopt::validator::pointer_t integer_validator(advgetopt::validator::create("integer", range_list));
+        CATCH_REQUIRE(integer_validator != nullptr);
+
+        for(std::int64_t port(-5); port <= 60030; ++port)
+        {
+            bool expected(false);
+            for(auto const & r : ranges)
+            {
+                if(port >= r.first
+                && port <= r.second)
+                {
+                    expected = true;
+                    break;
+                }
+            }
+            CATCH_REQUIRE(integer_validator->validate(std::to_string(port)) == expected);
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("integer_validator: verify adjacent and open ranges")
+    {
+        advgetopt::validator::pointer_t integer_validator(advgetopt::validator::create("integer(100...200, 201...300, ...-1000, 290...310, 9223372036854775800...)"));
+        CATCH_REQUIRE(integer_validator != nullptr);
+
+        CATCH_REQUIRE(integer_validator->validate("-9223372036854775808"));
+        CATCH_REQUIRE(integer_validator->validate("-1000"));
+        CATCH_REQUIRE_FALSE(integer_validator->validate("-999"));
+        CATCH_REQUIRE_FALSE(integer_validator->validate("99"));
+        CATCH_REQUIRE(integer_validator->validate("100"));
+        CATCH_REQUIRE(integer_validator->validate("200"));
+        CATCH_REQUIRE(integer_validator->validate("201"));
+        CATCH_REQUIRE(integer_validator->validate("300"));
+        CATCH_REQUIRE(integer_validator->validate("310"));
+        CATCH_REQUIRE_FALSE(integer_validator->validate("311"));
+        CATCH_REQUIRE_FALSE(integer_validator->validate("9223372036854775799"));
+        CATCH_REQUIRE(integer_validator->validate("9223372036854775800"));
+        CATCH_REQUIRE(integer_validator->validate("9223372036854775807"));
+    }
+    CATCH_END_SECTION()
 }
 
 
@@ -619,6 +1169,24 @@ CATCH_TEST_CASE("length_validator", "[validator][valid][validation]")
     }
     CATCH_END_SECTION()
 
+    CATCH_START_SECTION("length_validator: verify overlapping ranges")
+    {
+        advgetopt::validator::pointer_t length_validator(advgetopt::validator::create("length(8...12, 3, 1...2, 10...20)"));
+        CATCH_REQUIRE(length_validator != nullptr);
+
+        CATCH_REQUIRE_FALSE(length_validator->validate(""));
+        CATCH_REQUIRE(length_validator->validate("a"));
+        CATCH_REQUIRE(length_validator->validate("ab"));
+        CATCH_REQUIRE(length_validator->validate("abc"));
+        CATCH_REQUIRE_FALSE(length_validator->validate("abcd"));
+        CATCH_REQUIRE_FALSE(length_validator->validate("abcdefg"));
+        CATCH_REQUIRE(length_validator->validate("abcdefgh"));
+        CATCH_REQUIRE(length_validator->validate("abcdefghijklmno"));
+        CATCH_REQUIRE(length_validator->validate("abcdefghijklmnopqrst"));
+        CATCH_REQUIRE_FALSE(length_validator->validate("abcdefghijklmnopqrstu"));
+    }
+    CATCH_END_SECTION()
+
     CATCH_START_SECTION("length_validator: verify the length standalone list")
     {
         for(int count(0); count < 20; ++count)
@@ -722,6 +1290,75 @@ CATCH_TEST_CASE("multi_validators", "[validator][valid][validation]")
         }
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("multi_validators: verify that cheap validators run first")
+    {
+        advgetopt::validator::pointer_t validator(advgetopt::validator::create("regex(\"[0-9]+\") | email | length(1...3)"));
+        advgetopt::validator_list::pointer_t list(std::dynamic_pointer_cast<advgetopt::validator_list>(validator));
+        CATCH_REQUIRE(list != nullptr);
+
+        advgetopt::validator::vector_t const validators(list->get_validators());
+        CATCH_REQUIRE(validators.size() == 3);
+        CATCH_REQUIRE(validators[0]->name() == "length");
+        CATCH_REQUIRE(validators[1]->name() == "regex");
+        CATCH_REQUIRE(validators[2]->name() == "email");
+
+        CATCH_REQUIRE(list->validate("abc"));
+        CATCH_REQUIRE(list->validate("1234"));
+        CATCH_REQUIRE_FALSE(list->validate("abcd"));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("multi_validators: verify that the list short-circuits")
+    {
+        advgetopt::validator_list list({});
+
+        counting_validator::pointer_t regex(std::make_shared<counting_validator>("regex", 10));
+        counting_validator::pointer_t length(std::make_shared<counting_validator>("length", 3));
+        list.add_validator(regex);
+        list.add_validator(length);
+
+        CATCH_REQUIRE(list.validate("abc"));
+        CATCH_REQUIRE(length->get_count() == 1);
+        CATCH_REQUIRE(regex->get_count() == 0);
+
+        CATCH_REQUIRE(list.validate("abcd"));
+        CATCH_REQUIRE(length->get_count() == 2);
+        CATCH_REQUIRE(regex->get_count() == 1);
+
+        CATCH_REQUIRE_FALSE(list.validate("abcdefghijk"));
+        CATCH_REQUIRE(length->get_count() == 3);
+        CATCH_REQUIRE(regex->get_count() == 2);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("multi_validators: verify that the order does not change while validating")
+    {
+        advgetopt::validator_list list({});
+
+        counting_validator::pointer_t rarely(std::make_shared<counting_validator>("rarely", 0));
+        counting_validator::pointer_t often(std::make_shared<counting_validator>("often", 100));
+        list.add_validator(rarely);
+        list.add_validator(often);
+
+        // same estimated cost, so the order of declaration is kept
+        //
+        CATCH_REQUIRE(list.get_validators()[0] == rarely);
+        CATCH_REQUIRE(list.get_validators()[1] == often);
+
+        for(int idx(0); idx < 2'048; ++idx)
+        {
+            CATCH_REQUIRE(list.validate("value"));
+        }
+
+        // the order is static so "rarely" keeps running first
+        //
+        CATCH_REQUIRE(list.get_validators()[0] == rarely);
+        CATCH_REQUIRE(list.get_validators()[1] == often);
+        CATCH_REQUIRE(rarely->get_count() == 2'048);
+        CATCH_REQUIRE(often->get_count() == 2'048);
+    }
+    CATCH_END_SECTION()
 }
 
 
@@ -741,6 +1378,81 @@ CATCH_TEST_CASE("keywords_validator", "[validator][valid][validation]")
 
         CATCH_REQUIRE_FALSE(list_validator->validate(""));
         CATCH_REQUIRE_FALSE(list_validator->validate("other"));
+        CATCH_REQUIRE_FALSE(list_validator->validate("Angle"));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("keywords_validator: verify keyword identifiers")
+    {
+        advgetopt::validator::pointer_t validator(advgetopt::validator::create("keywords(red, green, blue, green, yellow)"));
+        CATCH_REQUIRE(validator != nullptr);
+
+        advgetopt::validator_keywords::pointer_t keywords(std::dynamic_pointer_cast<advgetopt::validator_keywords>(validator));
+        CATCH_REQUIRE(keywords != nullptr);
+        CATCH_REQUIRE_FALSE(keywords->is_case_insensitive());
+
+        // duplicates are ignored
+        //
+        CATCH_REQUIRE(keywords->size() == 4);
+        CATCH_REQUIRE(keywords->get_id("red") == 0);
+        CATCH_REQUIRE(keywords->get_id("green") == 1);
+        CATCH_REQUIRE(keywords->get_id("blue") == 2);
+        CATCH_REQUIRE(keywords->get_id("yellow") == 3);
+        CATCH_REQUIRE(keywords->get_id("Red") == advgetopt::validator_keywords::NO_KEYWORD);
+        CATCH_REQUIRE(keywords->get_id("purple") == advgetopt::validator_keywords::NO_KEYWORD);
+
+        CATCH_REQUIRE(keywords->get_keyword(0) == "red");
+        CATCH_REQUIRE(keywords->get_keyword(1) == "green");
+        CATCH_REQUIRE(keywords->get_keyword(2) == "blue");
+        CATCH_REQUIRE(keywords->get_keyword(3) == "yellow");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("keywords_validator: verify case insensitive keywords")
+    {
+        advgetopt::validator::pointer_t validator(advgetopt::validator::create("ikeywords(Yes, no, ON, off, on)"));
+        CATCH_REQUIRE(validator != nullptr);
+        CATCH_REQUIRE(validator->name() == "ikeywords");
+
+        advgetopt::validator_keywords::pointer_t keywords(std::dynamic_pointer_cast<advgetopt::validator_keywords>(validator));
+        CATCH_REQUIRE(keywords != nullptr);
+        CATCH_REQUIRE(keywords->is_case_insensitive());
+
+        CATCH_REQUIRE(keywords->size() == 4);
+
+        CATCH_REQUIRE(validator->validate("yes"));
+        CATCH_REQUIRE(validator->validate("YES"));
+        CATCH_REQUIRE(validator->validate("No"));
+        CATCH_REQUIRE(validator->validate("on"));
+        CATCH_REQUIRE(validator->validate("oFF"));
+        CATCH_REQUIRE_FALSE(validator->validate("yes!"));
+        CATCH_REQUIRE_FALSE(validator->validate("ye"));
+        CATCH_REQUIRE_FALSE(validator->validate(""));
+
+        CATCH_REQUIRE(keywords->get_id("yEs") == 0);
+        CATCH_REQUIRE(keywords->get_id("on") == 2);
+        CATCH_REQUIRE(keywords->get_keyword(2) == "ON");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("keywords_validator: verify a large number of keywords")
+    {
+        advgetopt::string_list_t list;
+        for(int idx(0); idx < 1'000; ++idx)
+        {
+            list.push_back("keyword" + std::to_string(idx * 37));
+        }
+        advgetopt::validator::pointer_t validator(advgetopt::validator::create("keywords", list));
+        advgetopt::validator_keywords::pointer_t keywords(std::dynamic_pointer_cast<advgetopt::validator_keywords>(validator));
+        CATCH_REQUIRE(keywords != nullptr);
+        CATCH_REQUIRE(keywords->size() == list.size());
+
+        for(int idx(0); idx < 1'000; ++idx)
+        {
+            CATCH_REQUIRE(keywords->validate(list[idx]));
+            CATCH_REQUIRE(keywords->get_id(list[idx]) == idx);
+            CATCH_REQUIRE_FALSE(keywords->validate("keyword" + std::to_string(idx * 37 + 1)));
+        }
     }
     CATCH_END_SECTION()
 }
@@ -750,6 +1462,103 @@ CATCH_TEST_CASE("keywords_validator", "[validator][valid][validation]")
 
 CATCH_TEST_CASE("double_validator", "[validator][valid][validation]")
 {
+    CATCH_START_SECTION("double_validator: verify conversions of views")
+    {
+        std::string const numbers("3.14159,-2.5e3,+0.125,1e400,0x1p4");
+        double d(0.0);
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wfloat-equal"
+        CATCH_REQUIRE(advgetopt::validator_double::convert_string(std::string_view(numbers).substr(0, 7), d));
+        bool const e1(d == 3.14159);
+        CATCH_REQUIRE(e1);
+        CATCH_REQUIRE(advgetopt::validator_double::convert_string(std::string_view(numbers).substr(0, 4), d));
+        bool const e2(d == 3.14);
+        CATCH_REQUIRE(e2);
+        CATCH_REQUIRE(advgetopt::validator_double::convert_string(std::string_view(numbers).substr(8, 6), d));
+        bool const e3(d == -2500.0);
+        CATCH_REQUIRE(e3);
+        CATCH_REQUIRE(advgetopt::validator_double::convert_string(std::string_view(numbers).substr(15, 6), d));
+        bool const e4(d == 0.125);
+        CATCH_REQUIRE(e4);
+
+        // hexadecimal numbers are still supported
+        //
+        CATCH_REQUIRE(advgetopt::validator_double::convert_string(std::string_view(numbers).substr(28, 5), d));
+        bool const e5(d == 16.0);
+        CATCH_REQUIRE(e5);
+#pragma GCC diagnostic pop
+
+        // overflow and underflow
+        //
+        CATCH_REQUIRE_FALSE(advgetopt::validator_double::convert_string(std::string_view(numbers).substr(22, 5), d));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_double::convert_string("1e-320", d));
+
+        // invalid
+        //
+        CATCH_REQUIRE_FALSE(advgetopt::validator_double::convert_string(std::string_view(numbers).substr(0, 8), d));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_double::convert_string("", d));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_double::convert_string("+", d));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_double::convert_string("+-3", d));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_double::convert_string(" 3", d));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_double::convert_string(".3", d));
+        CATCH_REQUIRE_FALSE(advgetopt::validator_double::convert_string("3,5", d));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("double_validator: verify a batch of doubles")
+    {
+        advgetopt::validator::pointer_t double_validator(advgetopt::validator::create("double(-10.5...10.25, 1e6...1e9)"));
+        CATCH_REQUIRE(double_validator != nullptr);
+
+        advgetopt::string_list_t values;
+        advgetopt::validator::index_list_t expected;
+        for(int idx(0); idx < 10'000; ++idx)
+        {
+            std::stringstream ss;
+            switch(rand() % 5)
+            {
+            case 0:
+                ss << std::setprecision(rand() % 17 + 1) << static_cast<double>(rand() % 30001 - 15000) / 1000.0;
+                break;
+
+            case 1:
+                ss << std::setprecision(rand() % 17 + 1) << static_cast<double>(rand()) * static_cast<double>(rand() % 2'000);
+                break;
+
+            case 2:
+                ss << rand() % 20 << '.';
+                break;
+
+            case 3:
+                ss << (rand() % 2 == 0 ? "+" : "-") << rand() % 15 << '.' << rand() % 1000 << (rand() % 2 == 0 ? "e" : "x");
+                break;
+
+            case 4:
+                ss << "10.25" << std::string(rand() % 20, '0');
+                break;
+
+            }
+            std::string const v(ss.str());
+            if(!double_validator->validate(v))
+            {
+                expected.push_back(values.size());
+            }
+            values.push_back(v);
+        }
+
+        advgetopt::validator::index_list_t invalid;
+        CATCH_REQUIRE(double_validator->validate_batch(values, invalid) == expected.empty());
+        CATCH_REQUIRE(invalid == expected);
+
+        CATCH_REQUIRE(double_validator->validate_batch({"1", "-10.5", "+10.25", "10.250000000000000001", "1e6"}, invalid));
+        CATCH_REQUIRE(invalid.empty());
+
+        CATCH_REQUIRE_FALSE(double_validator->validate_batch({"1.", "", ".5", "-10.51", "10.2500000000001"}, invalid));
+        CATCH_REQUIRE(invalid == advgetopt::validator::index_list_t{1, 2, 3, 4});
+    }
+    CATCH_END_SECTION()
+
     CATCH_START_SECTION("double_validator: verify the double validator")
     {
         advgetopt::validator::pointer_t double_validator(advgetopt::validator::create("double", advgetopt::string_list_t()));
@@ -935,6 +1744,31 @@ CATCH_TEST_CASE("double_validator", "[validator][valid][validation]")
     }
     CATCH_END_SECTION()
 
+    CATCH_START_SECTION("double_validator: verify overlapping ranges")
+    {
+        advgetopt::validator::pointer_t double_validator(advgetopt::validator::create("double(5.0...7.5, -3.0...-1.0, 1.0...5.0, 6.0...6.5, -1.0)"));
+        CATCH_REQUIRE(double_validator != nullptr);
+
+        CATCH_REQUIRE_FALSE(double_validator->validate("-3.1"));
+        CATCH_REQUIRE(double_validator->validate("-3.0"));
+        CATCH_REQUIRE(double_validator->validate("-1.0"));
+        CATCH_REQUIRE_FALSE(double_validator->validate("-0.5"));
+        CATCH_REQUIRE_FALSE(double_validator->validate("0.999"));
+        CATCH_REQUIRE(double_validator->validate("1.0"));
+        CATCH_REQUIRE(double_validator->validate("5.0"));
+        CATCH_REQUIRE(double_validator->validate("6.75"));
+        CATCH_REQUIRE(double_validator->validate("7.5"));
+        CATCH_REQUIRE_FALSE(double_validator->validate("7.51"));
+
+        // a NaN range never matches, even when it is the only range
+        //
+        advgetopt::validator::pointer_t nan_validator(advgetopt::validator::create("double(nan)"));
+        CATCH_REQUIRE(nan_validator != nullptr);
+        CATCH_REQUIRE_FALSE(nan_validator->validate("3.0"));
+        CATCH_REQUIRE_FALSE(nan_validator->validate("nan"));
+    }
+    CATCH_END_SECTION()
+
     CATCH_START_SECTION("double_validator: verify the double standalone list")
     {
         for(int count(0); count < 20; ++count)
@@ -1334,6 +2168,168 @@ CATCH_TEST_CASE("size_validator", "[validator][valid][validation]")
 
 
 
+CATCH_TEST_CASE("address_validator", "[validator][valid][validation]")
+{
+    CATCH_START_SECTION("address_validator: convert addresses to binary")
+    {
+        advgetopt::validator_address::address_t a;
+
+        CATCH_REQUIRE(advgetopt::validator_address::convert_string("192.168.3.7", a));
+        CATCH_REQUIRE(a.is_ipv4());
+        CATCH_REQUIRE_FALSE(a.has_port());
+        CATCH_REQUIRE_FALSE(a.is_cidr());
+        CATCH_REQUIRE(a.f_address[10] == 0xFF);
+        CATCH_REQUIRE(a.f_address[11] == 0xFF);
+        CATCH_REQUIRE(a.f_address[12] == 192);
+        CATCH_REQUIRE(a.f_address[13] == 168);
+        CATCH_REQUIRE(a.f_address[14] == 3);
+        CATCH_REQUIRE(a.f_address[15] == 7);
+
+        CATCH_REQUIRE(advgetopt::validator_address::convert_string("10.0.0.1:4040", a));
+        CATCH_REQUIRE(a.is_ipv4());
+        CATCH_REQUIRE(a.f_port == 4040);
+        CATCH_REQUIRE(a.f_prefix == 128);
+
+        CATCH_REQUIRE(advgetopt::validator_address::convert_string("10.0.0.0/8", a));
+        CATCH_REQUIRE(a.is_ipv4());
+        CATCH_REQUIRE(a.is_cidr());
+        CATCH_REQUIRE(a.f_prefix == 96 + 8);
+        CATCH_REQUIRE(a.f_port == -1);
+
+        CATCH_REQUIRE(advgetopt::validator_address::convert_string("::1", a));
+        CATCH_REQUIRE_FALSE(a.is_ipv4());
+        CATCH_REQUIRE(a.f_address[15] == 1);
+
+        CATCH_REQUIRE(advgetopt::validator_address::convert_string("[fe80::1]:443", a));
+        CATCH_REQUIRE_FALSE(a.is_ipv4());
+        CATCH_REQUIRE(a.f_address[0] == 0xFE);
+        CATCH_REQUIRE(a.f_address[1] == 0x80);
+        CATCH_REQUIRE(a.f_port == 443);
+
+        CATCH_REQUIRE(advgetopt::validator_address::convert_string("fd00::/8", a));
+        CATCH_REQUIRE(a.f_prefix == 8);
+
+        CATCH_REQUIRE(advgetopt::validator_address::convert_string("::ffff:127.0.0.1", a));
+        CATCH_REQUIRE(a.is_ipv4());
+
+        char const * const invalid[] = {
+            "",
+            "1.2.3",
+            "1.2.3.4.5",
+            "256.1.1.1",
+            "1.2.3.4:",
+            "1.2.3.4:65536",
+            "1.2.3.4:port",
+            "1.2.3.4/",
+            "1.2.3.4/33",
+            "1.2.3.4:80/8",
+            "::1/129",
+            "[::1",
+            "[::1]x",
+            "[::1]:",
+            "[1.2.3.4]",
+            "fe80:::1",
+            "host.example.com",
+        };
+        for(auto const & v : invalid)
+        {
+            CATCH_REQUIRE_FALSE(advgetopt::validator_address::convert_string(v, a));
+        }
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("address_validator: verify families, port and mask")
+    {
+        advgetopt::validator::pointer_t any(advgetopt::validator::create("address", advgetopt::string_list_t()));
+        CATCH_REQUIRE(any != nullptr);
+        CATCH_REQUIRE(any->name() == "address");
+        CATCH_REQUIRE(any->validate("127.0.0.1"));
+        CATCH_REQUIRE(any->validate("127.0.0.1:80"));
+        CATCH_REQUIRE(any->validate("::1"));
+        CATCH_REQUIRE(any->validate("[::1]:80"));
+        CATCH_REQUIRE_FALSE(any->validate("10.0.0.0/8"));
+        CATCH_REQUIRE_FALSE(any->validate("localhost"));
+
+        advgetopt::validation_result result;
+        advgetopt::validator::pointer_t ipv4(advgetopt::validator::create("address(ipv4, port)"));
+        CATCH_REQUIRE(ipv4->validate_with_result("127.0.0.1:80", result));
+        CATCH_REQUIRE_FALSE(ipv4->validate_with_result("127.0.0.1", result));
+        CATCH_REQUIRE(result.get_code() == advgetopt::validation_error_t::VALIDATION_ERROR_INVALID);
+        CATCH_REQUIRE(result.get_message() == "a port is required.");
+        CATCH_REQUIRE_FALSE(ipv4->validate_with_result("[::1]:80", result));
+        CATCH_REQUIRE(result.get_code() == advgetopt::validation_error_t::VALIDATION_ERROR_NO_MATCH);
+        CATCH_REQUIRE(result.get_message() == "IPv6 addresses are not allowed.");
+
+        advgetopt::validator::pointer_t ipv6(advgetopt::validator::create("address(ipv6, noport, cidr)"));
+        CATCH_REQUIRE(ipv6->validate_with_result("fd00::/8", result));
+        CATCH_REQUIRE(ipv6->validate_with_result("::1", result));
+        CATCH_REQUIRE_FALSE(ipv6->validate_with_result("[::1]:80", result));
+        CATCH_REQUIRE(result.get_code() == advgetopt::validation_error_t::VALIDATION_ERROR_INVALID);
+        CATCH_REQUIRE(result.get_message() == "a port is not allowed.");
+        CATCH_REQUIRE_FALSE(ipv6->validate_with_result("10.0.0.1", result));
+        CATCH_REQUIRE(result.get_message() == "IPv4 addresses are not allowed.");
+        CATCH_REQUIRE_FALSE(ipv6->validate_with_result("not an address", result));
+        CATCH_REQUIRE(result.get_message() == "not a valid IP address.");
+
+        CATCH_REQUIRE_FALSE(any->validate_with_result("10.0.0.0/8", result));
+        CATCH_REQUIRE(result.get_message() == "a CIDR mask is not allowed.");
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("address_validator: verify the allowed networks")
+    {
+        advgetopt::validator::pointer_t v(advgetopt::validator::create(
+                "address(cidr, 10.0.0.0/8, 192.168.1.0/24, 172.16.5.5, fd00::/8)"));
+        CATCH_REQUIRE(v != nullptr);
+
+        std::shared_ptr<advgetopt::validator_address> address(std::dynamic_pointer_cast<advgetopt::validator_address>(v));
+        CATCH_REQUIRE(address != nullptr);
+
+        CATCH_REQUIRE(v->validate("10.0.0.0"));
+        CATCH_REQUIRE(v->validate("10.255.255.255:80"));
+        CATCH_REQUIRE(v->validate("10.3.0.0/16"));
+        CATCH_REQUIRE(v->validate("192.168.1.200"));
+        CATCH_REQUIRE(v->validate("172.16.5.5"));
+        CATCH_REQUIRE(v->validate("fd12:3456::1"));
+
+        advgetopt::validation_result result;
+        CATCH_REQUIRE_FALSE(v->validate_with_result("11.0.0.1", result));
+        CATCH_REQUIRE(result.get_code() == advgetopt::validation_error_t::VALIDATION_ERROR_OUT_OF_RANGE);
+        CATCH_REQUIRE(result.get_message() == "address is not in the allowed networks.");
+        CATCH_REQUIRE_FALSE(v->validate("192.168.2.1"));
+        CATCH_REQUIRE_FALSE(v->validate("172.16.5.6"));
+        CATCH_REQUIRE_FALSE(v->validate("10.0.0.0/7"));
+        CATCH_REQUIRE_FALSE(v->validate("192.168.0.0/16"));
+        CATCH_REQUIRE_FALSE(v->validate("fe80::1"));
+        CATCH_REQUIRE_FALSE(v->validate("::1"));
+
+        // an IPv4 network does not match its IPv6 equivalent written
+        // without the mapping
+        //
+        CATCH_REQUIRE_FALSE(v->validate("::a00:1"));
+        CATCH_REQUIRE(v->validate("::ffff:10.0.0.1"));
+
+        advgetopt::validator_address::address_t a;
+        CATCH_REQUIRE(advgetopt::validator_address::convert_string("10.20.30.40", a));
+        CATCH_REQUIRE(address->is_allowed(a));
+        CATCH_REQUIRE(advgetopt::validator_address::convert_string("127.0.0.1", a));
+        CATCH_REQUIRE_FALSE(address->is_allowed(a));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("address_validator: a /0 network allows everything")
+    {
+        advgetopt::validator::pointer_t v(advgetopt::validator::create("address(::/0)"));
+        CATCH_REQUIRE(v->validate("1.2.3.4"));
+        CATCH_REQUIRE(v->validate("::1"));
+        CATCH_REQUIRE(v->validate("[2001:db8::5]:53"));
+    }
+    CATCH_END_SECTION()
+}
+
+
+
+
 CATCH_TEST_CASE("regex_validator", "[validator][valid][validation]")
 {
     CATCH_START_SECTION("regex_validator: verify the regex validator")
@@ -1403,6 +2399,72 @@ CATCH_TEST_CASE("regex_validator", "[validator][valid][validation]")
         CATCH_REQUIRE_FALSE(regex_validator->validate("contact!m2osw.com"));
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("regex_validator: verify that the entire value has to match")
+    {
+        advgetopt::validator::pointer_t regex_validator(advgetopt::validator::create("regex", {"a|ab"}));
+
+        CATCH_REQUIRE(regex_validator != nullptr);
+        CATCH_REQUIRE(regex_validator->validate("a"));
+        CATCH_REQUIRE(regex_validator->validate("ab"));
+        CATCH_REQUIRE_FALSE(regex_validator->validate("abc"));
+        CATCH_REQUIRE_FALSE(regex_validator->validate("ba"));
+        CATCH_REQUIRE_FALSE(regex_validator->validate(""));
+        CATCH_REQUIRE_FALSE(regex_validator->validate(std::string("a\0b", 3)));
+
+        // the ")" is a literal in POSIX
+        //
+        regex_validator = advgetopt::validator::create("regex", {"a)|b"});
+        CATCH_REQUIRE(regex_validator != nullptr);
+        CATCH_REQUIRE(regex_validator->validate("a)"));
+        CATCH_REQUIRE(regex_validator->validate("b"));
+        CATCH_REQUIRE_FALSE(regex_validator->validate("a"));
+        CATCH_REQUIRE_FALSE(regex_validator->validate("b)"));
+
+        // back references
+        //
+        regex_validator = advgetopt::validator::create("regex", {"([a-z]+)-\\1"});
+        CATCH_REQUIRE(regex_validator != nullptr);
+        CATCH_REQUIRE(regex_validator->validate("abc-abc"));
+        CATCH_REQUIRE_FALSE(regex_validator->validate("abc-abd"));
+        CATCH_REQUIRE_FALSE(regex_validator->validate("abc-abcabc"));
+
+        // bracket expressions with parenthesis and classes
+        //
+        regex_validator = advgetopt::validator::create("regex", {"[])[:digit:]]+"});
+        CATCH_REQUIRE(regex_validator != nullptr);
+        CATCH_REQUIRE(regex_validator->validate("])3)"));
+        CATCH_REQUIRE_FALSE(regex_validator->validate("])a)"));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("regex_validator: verify that very long values do not blow up")
+    {
+        advgetopt::validator::pointer_t regex_validator(advgetopt::validator::create("regex", {"(a+)+b"}));
+
+        CATCH_REQUIRE(regex_validator != nullptr);
+        CATCH_REQUIRE(regex_validator->validate(std::string(100'000, 'a') + 'b'));
+        CATCH_REQUIRE_FALSE(regex_validator->validate(std::string(100'000, 'a')));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("regex_validator: verify that validators can share a regex")
+    {
+        advgetopt::validator::pointer_t v1(advgetopt::validator::create("regex", {"/[0-9]+ (kb|mb|gb)/i"}));
+        advgetopt::validator::pointer_t v2(advgetopt::validator::create("regex", {"/[0-9]+ (kb|mb|gb)/i"}));
+        advgetopt::validator::pointer_t v3(advgetopt::validator::create("regex", {"[0-9]+ (kb|mb|gb)"}));
+
+        CATCH_REQUIRE(v1 != v2);
+
+        CATCH_REQUIRE(v1->validate("10 kb"));
+        CATCH_REQUIRE(v2->validate("10 kb"));
+        CATCH_REQUIRE(v3->validate("10 kb"));
+
+        CATCH_REQUIRE(v1->validate("10 MB"));
+        CATCH_REQUIRE(v2->validate("10 MB"));
+        CATCH_REQUIRE_FALSE(v3->validate("10 MB"));
+    }
+    CATCH_END_SECTION()
 }
 
 
@@ -1692,6 +2754,35 @@ CATCH_TEST_CASE("invalid_keywords_validator", "[invalid][validation]")
         CATCH_REQUIRE(keywords != nullptr);
     }
     CATCH_END_SECTION()
+
+    CATCH_START_SECTION("invalid_keywords_validator: verify that ikeywords without parameters fail.")
+    {
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: validator_ikeywords() requires at least one parameter.");
+        advgetopt::validator::pointer_t keywords(advgetopt::validator::create("ikeywords"));
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+        CATCH_REQUIRE(keywords != nullptr);
+        CATCH_REQUIRE_FALSE(keywords->validate(""));
+        CATCH_REQUIRE_FALSE(keywords->validate("ikeywords"));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("invalid_keywords_validator: verify out of range identifiers.")
+    {
+        advgetopt::validator_keywords keywords({"one", "two"});
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  keywords.get_keyword(-1)
+                , advgetopt::getopt_logic_error
+                , Catch::Matchers::ExceptionMessage(
+                          "getopt_logic_error: keyword identifier -1 is out of range."));
+
+        CATCH_REQUIRE_THROWS_MATCHES(
+                  keywords.get_keyword(2)
+                , advgetopt::getopt_logic_error
+                , Catch::Matchers::ExceptionMessage(
+                          "getopt_logic_error: keyword identifier 2 is out of range."));
+    }
+    CATCH_END_SECTION()
 }
 
 
@@ -1750,8 +2841,73 @@ CATCH_TEST_CASE("invalid_size_validator", "[invalid][validation]")
     CATCH_END_SECTION()
 }
 
+CATCH_TEST_CASE("invalid_address_validator", "[validator][invalid][validation]")
+{
+    CATCH_START_SECTION("invalid_address_validator: verify invalid networks")
+    {
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: \"10.0.0.0/40\" is not a valid network for the address validator; it must be an IP address with an optional CIDR mask.");
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: \"10.0.0.1:80\" is not a valid network for the address validator; it must be an IP address with an optional CIDR mask.");
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: \"future\" is not a valid network for the address validator; it must be an IP address with an optional CIDR mask.");
+        advgetopt::validator::pointer_t v(advgetopt::validator::create("address", {"10.0.0.0/40", "10.0.0.1:80", "future", "127.0.0.0/8"}));
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+
+        CATCH_REQUIRE(v->validate("127.1.2.3"));
+        CATCH_REQUIRE_FALSE(v->validate("10.0.0.1"));
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("invalid_address_validator: port required and forbidden")
+    {
+        SNAP_CATCH2_NAMESPACE::push_expected_log("error: the address validator cannot at the same time require and forbid a port.");
+        advgetopt::validator::pointer_t v(advgetopt::validator::create("address", {"port", "noport"}));
+        SNAP_CATCH2_NAMESPACE::expected_logs_stack_is_empty();
+
+        CATCH_REQUIRE(v->validate("127.0.0.1"));
+        CATCH_REQUIRE(v->validate("127.0.0.1:80"));
+    }
+    CATCH_END_SECTION()
+}
+
+
 CATCH_TEST_CASE("invalid_regex_validator", "[validator][invalid][validation]")
 {
+    CATCH_START_SECTION("invalid_regex_validator: verify invalid regular expression")
+    {
+        CATCH_REQUIRE_THROWS_AS(
+                  advgetopt::validator::create("regex", {"(unmatched"})
+                , std::regex_error);
+        CATCH_REQUIRE_THROWS_AS(
+                  advgetopt::validator::create("regex", {"/[a-z/i"})
+                , std::regex_error);
+
+        // an invalid expression is not cached, it throws every time
+        //
+        CATCH_REQUIRE_THROWS_AS(
+                  advgetopt::validator::create("regex", {"(unmatched"})
+                , std::regex_error);
+    }
+    CATCH_END_SECTION()
+
+    CATCH_START_SECTION("invalid_regex_validator: verify the cache limit")
+    {
+        // fill the cache with more expressions than it can hold; the
+        // oldest validator must still work once its expression was evicted
+        //
+        advgetopt::validator::pointer_t first(advgetopt::validator::create("regex", {"first-[0-9]+"}));
+        for(int idx(0); idx < 250; ++idx)
+        {
+            advgetopt::validator::pointer_t v(advgetopt::validator::create("regex", {"cache-" + std::to_string(idx)}));
+            CATCH_REQUIRE(v->validate("cache-" + std::to_string(idx)));
+        }
+        CATCH_REQUIRE(first->validate("first-123"));
+        CATCH_REQUIRE_FALSE(first->validate("first-"));
+
+        advgetopt::validator::pointer_t again(advgetopt::validator::create("regex", {"first-[0-9]+"}));
+        CATCH_REQUIRE(again->validate("first-99"));
+        CATCH_REQUIRE_FALSE(again->validate("second-99"));
+    }
+    CATCH_END_SECTION()
+
     CATCH_START_SECTION("invalid_regex_validator: verify invalid regex flags")
     {
         SNAP_CATCH2_NAMESPACE::push_expected_log("error: unsupported regex flag f in regular expression \"/contact@.*\\..*/f\".");